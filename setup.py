@@ -57,6 +57,76 @@ else:
     libraries = []
     library_dirs = []
 
+# if the environment variable CX_ORACLE_BUILD_MODE is set to "release", the
+# cx_Oracle and ODPI-C sources are compiled as a single translation unit with
+# full optimization and link time optimization enabled; in addition, if the
+# environment variable CX_ORACLE_PGO_MODE is set to "generate", the module is
+# instrumented to write profile data to the directory named by the
+# environment variable CX_ORACLE_PGO_DIR (default build/pgo) and if it is set
+# to "use", the module is optimized with the profile data found there. The
+# intended sequence is a build with "generate", a run of a representative
+# workload such as test/benchmark.py and a build with "use"; with clang the
+# raw profiles must first be merged into default.profdata in that directory
+# using llvm-profdata
+build_mode = os.environ.get("CX_ORACLE_BUILD_MODE", "default")
+pgo_mode = os.environ.get("CX_ORACLE_PGO_MODE")
+if build_mode not in ("default", "release"):
+    raise Exception("CX_ORACLE_BUILD_MODE must be default or release")
+if pgo_mode is not None and build_mode != "release":
+    raise Exception("CX_ORACLE_PGO_MODE requires a release build")
+if build_mode == "release":
+
+    # generate a source file that includes all of the other sources; the
+    # method and member tables in each of the cx_Oracle sources share the
+    # same names so they are renamed to make them unique
+    unity_dir = os.path.join("build", "unity")
+    unity_file_name = os.path.join(unity_dir, "cxoUnity.c")
+    unity_lines = []
+    renamed_names = ["cxoCalcMembers", "cxoMembers", "cxoMethods"]
+    for source in sources + dpi_sources:
+        base_name = os.path.splitext(os.path.basename(source))[0]
+        if source in sources:
+            for name in renamed_names:
+                unity_lines.append("#define %s %s_%s" % \
+                        (name, name, base_name))
+        unity_lines.append('#include "%s"' % \
+                os.path.abspath(source).replace("\\", "/"))
+        if source in sources:
+            for name in renamed_names:
+                unity_lines.append("#undef %s" % name)
+    unity_contents = "\n".join(unity_lines) + "\n"
+    os.makedirs(unity_dir, exist_ok=True)
+    if not os.path.exists(unity_file_name) or \
+            open(unity_file_name).read() != unity_contents:
+        with open(unity_file_name, "w") as f:
+            f.write(unity_contents)
+    depends.extend(sources + dpi_sources)
+    sources = [unity_file_name]
+    dpi_sources = []
+    include_dirs.append(source_dir)
+
+    # add optimization flags
+    if sys.platform == "win32":
+        if pgo_mode is not None:
+            raise Exception("CX_ORACLE_PGO_MODE is not supported on Windows")
+        extra_compile_args.extend(["/O2", "/GL"])
+        extra_link_args.append("/LTCG")
+    else:
+        extra_compile_args.extend(["-O3", "-flto"])
+        extra_link_args.extend(["-O3", "-flto"])
+        pgo_dir = os.path.abspath(os.environ.get("CX_ORACLE_PGO_DIR",
+                os.path.join("build", "pgo")))
+        if pgo_mode == "generate":
+            pgo_args = ["-fprofile-generate=%s" % pgo_dir]
+        elif pgo_mode == "use":
+            pgo_args = ["-fprofile-use=%s" % pgo_dir, "-fprofile-correction"]
+        elif pgo_mode is not None:
+            raise Exception("CX_ORACLE_PGO_MODE must be generate or use")
+        else:
+            pgo_args = []
+        extra_compile_args.extend(pgo_args)
+        extra_link_args.extend(pgo_args)
+
 # setup the extension
 extension = setuptools.Extension(
         name="cx_Oracle",
@@ -40,6 +40,42 @@ typedef struct {
     cxoBuffer *superShardingKeyBuffers;
 } cxoConnectionParams;
 
+//-----------------------------------------------------------------------------
+// structure used for creating standalone connections on native threads
+//-----------------------------------------------------------------------------
+typedef struct {
+    cxoConnectionParams *params;
+    dpiCommonCreateParams commonParams;
+    dpiConnCreateParams createParams;
+    dpiConn *handle;
+    cxoThread thread;
+    int started;
+    int status;
+    cxoErrorBuffer error;
+} cxoConnectionCreateTask;
+
+//-----------------------------------------------------------------------------
+// free list of connection objects of the default type which have been
+// deallocated and are available for reuse; this avoids the cost of allocating
+// a new object each time a connection is acquired from a session pool
+//-----------------------------------------------------------------------------
+#define CXO_CONNECTION_FREE_LIST_SIZE   32
+static cxoConnection *cxoConnectionFreeList[CXO_CONNECTION_FREE_LIST_SIZE];
+static int cxoConnectionNumFree = 0;
+
+// OCI handle type and attribute used to set the amount of LOB data that is
+// returned along with each LOB locator fetched by the session
+#define CXO_OCI_HTYPE_SESSION                   9
+#define CXO_OCI_ATTR_DEFAULT_LOBPREFETCH_SIZE   438
+
+//-----------------------------------------------------------------------------
+// parameters used as the starting point when acquiring connections from a
+// session pool using the fast path; these are initialized on first use
+//-----------------------------------------------------------------------------
+static dpiCommonCreateParams cxoConnectionPoolCommonParams;
+static dpiConnCreateParams cxoConnectionPoolCreateParams;
+static int cxoConnectionPoolParamsInitialized = 0;
+
 
 //-----------------------------------------------------------------------------
 // cxoConnectionParams_initialize()
@@ -285,6 +321,153 @@ static int cxoConnectionParams_finalize(cxoConnectionParams *params)
 }
 
 
+//-----------------------------------------------------------------------------
+// cxoConnection_acquireTempLob()
+//   Return a temporary LOB of the given type for use in binding a value,
+// taking one from the pool of temporary LOBs retained by the connection if
+// one is available or creating one otherwise. The caller is expected to
+// return it to the connection with cxoConnection_releaseTempLob().
+//-----------------------------------------------------------------------------
+dpiLob *cxoConnection_acquireTempLob(cxoConnection *conn,
+        dpiOracleTypeNum oracleTypeNum)
+{
+    dpiLob *handle;
+    uint32_t i;
+    int status;
+
+    // use a LOB from the pool, if one of the correct type is available
+    for (i = conn->numTempLobs; i > 0; i--) {
+        if (conn->tempLobs[i - 1].oracleTypeNum == oracleTypeNum) {
+            handle = conn->tempLobs[i - 1].handle;
+            conn->tempLobs[i - 1] = conn->tempLobs[--conn->numTempLobs];
+            conn->numTempLobsReused++;
+            return handle;
+        }
+    }
+
+    // otherwise, create a new one
+    if (cxoConnection_isConnected(conn) < 0)
+        return NULL;
+    Py_BEGIN_ALLOW_THREADS
+    status = dpiConn_newTempLob(conn->handle, oracleTypeNum, &handle);
+    Py_END_ALLOW_THREADS
+    if (status < 0)
+        return (dpiLob*) cxoError_raiseAndReturnNull();
+    conn->numTempLobsCreated++;
+    return handle;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoConnection_cacheDefine()
+//   Retain a define variable that is no longer needed by its cursor so that
+// it can be reused by a subsequent query with the same type, size and array
+// size. Only variables that nothing else refers to and that do not refer to
+// LOBs, objects or other handles are retained. Returns 1 if the variable was
+// retained, in which case the cache has taken over the reference.
+//-----------------------------------------------------------------------------
+int cxoConnection_cacheDefine(cxoConnection *conn, cxoVar *var)
+{
+    if (!conn->handle ||
+            conn->numCachedDefines == CXO_CONNECTION_DEFINE_CACHE_SIZE ||
+            Py_REFCNT(var) != 1 || var->isArray || var->objectType)
+        return 0;
+    switch (var->transformNum) {
+        case CXO_TRANSFORM_BINARY:
+        case CXO_TRANSFORM_BOOLEAN:
+        case CXO_TRANSFORM_DATE:
+        case CXO_TRANSFORM_DATETIME:
+        case CXO_TRANSFORM_DECIMAL:
+        case CXO_TRANSFORM_FIXED_CHAR:
+        case CXO_TRANSFORM_FIXED_NCHAR:
+        case CXO_TRANSFORM_FLOAT:
+        case CXO_TRANSFORM_INT:
+        case CXO_TRANSFORM_NATIVE_DOUBLE:
+        case CXO_TRANSFORM_NATIVE_FLOAT:
+        case CXO_TRANSFORM_NATIVE_INT:
+        case CXO_TRANSFORM_NSTRING:
+        case CXO_TRANSFORM_STRING:
+        case CXO_TRANSFORM_TIMEDELTA:
+        case CXO_TRANSFORM_TIMESTAMP:
+        case CXO_TRANSFORM_TIMESTAMP_LTZ:
+        case CXO_TRANSFORM_TIMESTAMP_TZ:
+            break;
+        default:
+            return 0;
+    }
+
+    // reset the state set by the cursor or by an output type handler; the
+    // reference to the connection is dropped to avoid a cycle
+    Py_CLEAR(var->inConverter);
+    Py_CLEAR(var->outConverter);
+    if (var->encodingErrors) {
+        PyMem_Free((void*) var->encodingErrors);
+        var->encodingErrors = NULL;
+    }
+    var->isValueSet = 0;
+    var->getReturnedData = 0;
+    Py_CLEAR(var->connection);
+    conn->defineCache[conn->numCachedDefines++] = var;
+    return 1;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoConnection_clearDefineCache()
+//   Release all of the define variables retained by the connection.
+//-----------------------------------------------------------------------------
+void cxoConnection_clearDefineCache(cxoConnection *conn)
+{
+    while (conn->numCachedDefines > 0)
+        Py_DECREF(conn->defineCache[--conn->numCachedDefines]);
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoConnection_clearTempLobPool()
+//   Release all of the temporary LOBs retained by the connection.
+//-----------------------------------------------------------------------------
+void cxoConnection_clearTempLobPool(cxoConnection *conn)
+{
+    if (conn->numTempLobs == 0)
+        return;
+    Py_BEGIN_ALLOW_THREADS
+    while (conn->numTempLobs > 0)
+        dpiLob_release(conn->tempLobs[--conn->numTempLobs].handle);
+    Py_END_ALLOW_THREADS
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoConnection_getCachedDefine()
+//   Return a define variable retained by the connection with the given type,
+// size and array size, if one is available, or NULL otherwise. No exception
+// is raised in either case.
+//-----------------------------------------------------------------------------
+cxoVar *cxoConnection_getCachedDefine(cxoConnection *conn,
+        cxoTransformNum transformNum, uint32_t size, uint32_t numElements)
+{
+    cxoVar *var;
+    uint32_t i;
+
+    if (size == 0)
+        size = cxoTransform_getDefaultSize(transformNum);
+    for (i = conn->numCachedDefines; i > 0; i--) {
+        var = conn->defineCache[i - 1];
+        if (var->transformNum == transformNum && var->size == size &&
+                var->allocatedElements == numElements) {
+            conn->defineCache[i - 1] =
+                    conn->defineCache[--conn->numCachedDefines];
+            Py_INCREF(conn);
+            var->connection = conn;
+            return var;
+        }
+    }
+
+    return NULL;
+}
+
+
 //-----------------------------------------------------------------------------
 // cxoConnection_getSodaFlags()
 //   Get the flags to use for SODA. This checks the autocommit flag and enables
@@ -316,6 +499,60 @@ int cxoConnection_isConnected(cxoConnection *conn)
 }
 
 
+//-----------------------------------------------------------------------------
+// cxoConnection_releaseTempLob()
+//   Return a temporary LOB acquired with cxoConnection_acquireTempLob() to
+// the pool so that it can be reused by a subsequent bind. If the pool is
+// full or the connection has been closed, the LOB is released instead. No
+// exception is raised in either case.
+//-----------------------------------------------------------------------------
+void cxoConnection_releaseTempLob(cxoConnection *conn, dpiLob *handle,
+        dpiOracleTypeNum oracleTypeNum)
+{
+    cxoTempLob *tempLob;
+
+    if (conn && conn->handle && conn->numTempLobs < conn->tempLobPoolSize) {
+        if (!conn->tempLobs)
+            conn->tempLobs = PyMem_Malloc(conn->tempLobPoolSize *
+                    sizeof(cxoTempLob));
+        if (conn->tempLobs) {
+            tempLob = &conn->tempLobs[conn->numTempLobs++];
+            tempLob->handle = handle;
+            tempLob->oracleTypeNum = oracleTypeNum;
+            return;
+        }
+    }
+    if (conn)
+        conn->numTempLobsDiscarded++;
+    Py_BEGIN_ALLOW_THREADS
+    dpiLob_release(handle);
+    Py_END_ALLOW_THREADS
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoConnection_setLobPrefetchSize()
+//   Set the amount of data (in characters for CLOBs and bytes for BLOBs) that
+// is returned by the database along with each LOB locator fetched by columns
+// defined after this call, so that small LOBs can be read without an
+// additional round trip. This is a session setting: callers set it only
+// around the defines that need it and then restore the previous value, which
+// is available in the lobPrefetchSize member.
+//-----------------------------------------------------------------------------
+int cxoConnection_setLobPrefetchSize(cxoConnection *conn, uint32_t size)
+{
+    if (size == conn->lobPrefetchSize)
+        return 0;
+    if (cxoConnection_isConnected(conn) < 0)
+        return -1;
+    if (dpiConn_setOciAttr(conn->handle, CXO_OCI_HTYPE_SESSION,
+            CXO_OCI_ATTR_DEFAULT_LOBPREFETCH_SIZE, &size, sizeof(size)) < 0)
+        return cxoError_raiseAndReturnInt();
+    conn->lobPrefetchSize = size;
+    return 0;
+}
+
+
 //-----------------------------------------------------------------------------
 // cxoConnection_getAttrText()
 //   Get the value of the attribute returned from the given function. The value
@@ -417,6 +654,16 @@ static PyObject *cxoConnection_changePassword(cxoConnection *conn,
 static PyObject *cxoConnection_new(PyTypeObject *type, PyObject *args,
         PyObject *keywordArgs)
 {
+    cxoConnection *conn;
+
+    // reuse an object from the free list, if one is available
+    if (type == &cxoPyTypeConnection && cxoConnectionNumFree > 0) {
+        conn = cxoConnectionFreeList[--cxoConnectionNumFree];
+        memset((char*) conn + sizeof(PyObject), 0,
+                sizeof(cxoConnection) - sizeof(PyObject));
+        return PyObject_Init((PyObject*) conn, type);
+    }
+
     return type->tp_alloc(type, 0);
 }
 
@@ -461,101 +708,172 @@ static int cxoConnection_splitComponent(PyObject *sourceObj,
 
 
 //-----------------------------------------------------------------------------
-// cxoConnection_init()
-//   Initialize the connection members.
+// cxoConnection_splitUsername()
+//   Split a user name of the form "user/password@dsn" into its components.
+// The user name and DSN of the connection are replaced and a new reference to
+// the password is returned; if the user name contains no password, the
+// connection is left unchanged and no password is returned.
 //-----------------------------------------------------------------------------
-static int cxoConnection_init(cxoConnection *conn, PyObject *args,
-        PyObject *keywordArgs)
+static int cxoConnection_splitUsername(cxoConnection *conn,
+        PyObject **passwordObj)
 {
-    PyObject *usernameObj, *passwordObj, *dsnObj, *cclassObj, *editionObj;
-    int status, temp, invokeSessionCallback, threaded, events;
-    PyObject *shardingKeyObj, *superShardingKeyObj, *tempObj;
     PyObject *beforePartObj, *afterPartObj;
-    dpiCommonCreateParams dpiCommonParams;
-    dpiConnCreateParams dpiCreateParams;
-    unsigned long long externalHandle;
-    PyObject *tagObj, *contextObj;
-    unsigned int stmtCacheSize;
-    cxoConnectionParams params;
-    PyObject *newPasswordObj;
-    cxoSessionPool *pool;
 
-    // define keyword arguments
-    static char *keywordList[] = { "user", "password", "dsn", "mode",
-            "handle", "pool", "threaded", "events", "cclass", "purity",
-            "newpassword", "encoding", "nencoding", "edition", "appcontext",
-            "tag", "matchanytag", "shardingkey", "supershardingkey",
-            "stmtcachesize", NULL };
-
-    // parse arguments
-    pool = NULL;
-    tagObj = Py_None;
-    threaded = 0;
-    externalHandle = 0;
-    newPasswordObj = usernameObj = NULL;
-    passwordObj = dsnObj = cclassObj = editionObj = NULL;
-    contextObj = shardingKeyObj = superShardingKeyObj = NULL;
-    stmtCacheSize = DPI_DEFAULT_STMT_CACHE_SIZE;
-    if (cxoUtils_initializeDPI(NULL) < 0)
+    *passwordObj = NULL;
+    if (cxoConnection_splitComponent(conn->username, "/", "find",
+            &beforePartObj, &afterPartObj) < 0)
         return -1;
-    if (dpiContext_initCommonCreateParams(cxoDpiContext, &dpiCommonParams) < 0)
-        return cxoError_raiseAndReturnInt();
-    if (dpiContext_initConnCreateParams(cxoDpiContext, &dpiCreateParams) < 0)
-        return cxoError_raiseAndReturnInt();
-    if (!PyArg_ParseTupleAndKeywords(args, keywordArgs,
-            "|OOOiKO!ppOiOssOOOpOOI", keywordList, &usernameObj, &passwordObj,
-            &dsnObj, &dpiCreateParams.authMode, &externalHandle,
-            &cxoPyTypeSessionPool, &pool, &threaded, &events, &cclassObj,
-            &dpiCreateParams.purity, &newPasswordObj,
-            &dpiCommonParams.encoding, &dpiCommonParams.nencoding, &editionObj,
-            &contextObj, &tagObj, &dpiCreateParams.matchAnyTag,
-            &shardingKeyObj, &superShardingKeyObj, &stmtCacheSize))
+    if (!beforePartObj)
+        return 0;
+    Py_DECREF(conn->username);
+    conn->username = beforePartObj;
+    *passwordObj = afterPartObj;
+    if (cxoConnection_splitComponent(*passwordObj, "@", "rfind",
+            &beforePartObj, &afterPartObj) < 0) {
+        Py_CLEAR(*passwordObj);
         return -1;
-    dpiCreateParams.externalHandle = (void*) externalHandle;
-    if (threaded)
-        dpiCommonParams.createMode |= DPI_MODE_CREATE_THREADED;
-    if (events)
-        dpiCommonParams.createMode |= DPI_MODE_CREATE_EVENTS;
+    }
+    if (beforePartObj) {
+        Py_DECREF(*passwordObj);
+        *passwordObj = beforePartObj;
+        Py_XDECREF(conn->dsn);
+        conn->dsn = afterPartObj;
+    }
+    return 0;
+}
 
-    // keep a copy of the user name and connect string (DSN)
-    Py_XINCREF(usernameObj);
-    conn->username = usernameObj;
-    Py_XINCREF(dsnObj);
-    conn->dsn = dsnObj;
-    Py_XINCREF(passwordObj);
 
-    // perform some parsing, if no password and DSN are provided but the user
-    // name is provided
-    if (conn->username && !passwordObj && !dsnObj) {
-        if (cxoConnection_splitComponent(conn->username, "/", "find",
-                &beforePartObj, &afterPartObj) < 0)
-            return -1;
-        if (beforePartObj) {
-            Py_DECREF(conn->username);
-            conn->username = beforePartObj;
-            passwordObj = afterPartObj;
-            if (cxoConnection_splitComponent(passwordObj, "@", "rfind",
-                    &beforePartObj, &afterPartObj) < 0)
-                return -1;
-            if (beforePartObj) {
-                Py_DECREF(passwordObj);
-                passwordObj = beforePartObj;
-                conn->dsn = afterPartObj;
-            }
+//-----------------------------------------------------------------------------
+// cxoConnection_runCreateTask()
+//   Create a standalone connection. This may be called on a native thread so
+// the GIL is not held and the Python interpreter must not be used. The error
+// is captured since the error buffer belongs to the calling thread.
+//-----------------------------------------------------------------------------
+static void cxoConnection_runCreateTask(void *arg)
+{
+    cxoConnectionCreateTask *task = (cxoConnectionCreateTask*) arg;
+    cxoConnectionParams *params = task->params;
+
+    task->status = dpiConn_create(cxoDpiContext, params->userNameBuffer.ptr,
+            params->userNameBuffer.size, params->passwordBuffer.ptr,
+            params->passwordBuffer.size, params->dsnBuffer.ptr,
+            params->dsnBuffer.size, &task->commonParams, &task->createParams,
+            &task->handle);
+    if (task->status < 0)
+        cxoError_captureInfo(&task->error);
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoConnection_createMany()
+//   Create the connection and the extra connections concurrently, each on its
+// own native thread (the connection itself is created on the calling thread).
+// If any of the connections cannot be created, the ones that were created are
+// closed and the first error is raised.
+//-----------------------------------------------------------------------------
+static int cxoConnection_createMany(cxoConnection *conn,
+        cxoConnectionParams *params, dpiCommonCreateParams *dpiCommonParams,
+        dpiConnCreateParams *dpiCreateParams, uint32_t numExtraConns,
+        cxoConnection **extraConns)
+{
+    cxoConnectionCreateTask *tasks, *task, *failedTask;
+    uint32_t i, numTasks = numExtraConns + 1;
+
+    // initialize the tasks
+    tasks = PyMem_Malloc(numTasks * sizeof(cxoConnectionCreateTask));
+    if (!tasks) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    for (i = 0; i < numTasks; i++) {
+        task = &tasks[i];
+        task->params = params;
+        task->commonParams = *dpiCommonParams;
+        task->createParams = *dpiCreateParams;
+        task->handle = NULL;
+        task->started = 0;
+    }
+
+    // start a thread for each extra connection and create the first one on
+    // this thread; any connections for which a thread could not be started
+    // are created on this thread as well
+    Py_BEGIN_ALLOW_THREADS
+    for (i = 1; i < numTasks; i++)
+        tasks[i].started = (cxoUtils_startThread(&tasks[i].thread,
+                cxoConnection_runCreateTask, &tasks[i]) == 0);
+    for (i = 0; i < numTasks; i++) {
+        if (!tasks[i].started)
+            cxoConnection_runCreateTask(&tasks[i]);
+    }
+    for (i = 1; i < numTasks; i++) {
+        if (tasks[i].started)
+            cxoUtils_joinThread(tasks[i].thread);
+    }
+    Py_END_ALLOW_THREADS
+
+    // if any connection failed, close the others and raise the error
+    failedTask = NULL;
+    for (i = 0; i < numTasks && !failedTask; i++) {
+        if (tasks[i].status < 0)
+            failedTask = &tasks[i];
+    }
+    if (failedTask) {
+        Py_BEGIN_ALLOW_THREADS
+        for (i = 0; i < numTasks; i++) {
+            if (tasks[i].status == DPI_SUCCESS)
+                dpiConn_release(tasks[i].handle);
         }
+        Py_END_ALLOW_THREADS
+        cxoError_raiseFromInfo(&failedTask->error.info);
+        PyMem_Free(tasks);
+        return -1;
     }
 
+    // transfer the handles to the connection objects
+    conn->handle = tasks[0].handle;
+    *dpiCreateParams = tasks[0].createParams;
+    for (i = 1; i < numTasks; i++)
+        extraConns[i - 1]->handle = tasks[i].handle;
+    PyMem_Free(tasks);
+    return 0;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoConnection_connect()
+//   Establish the connection (or acquire it from the session pool) using the
+// parameters supplied by the caller and initialize the remaining members. If
+// extra connections are supplied, standalone connections are created for
+// them concurrently using the same parameters; their remaining members are
+// initialized from the connection.
+//-----------------------------------------------------------------------------
+static int cxoConnection_connect(cxoConnection *conn, cxoSessionPool *pool,
+        PyObject *passwordObj, PyObject *cclassObj, PyObject *newPasswordObj,
+        PyObject *editionObj, PyObject *contextObj, PyObject *tagObj,
+        PyObject *shardingKeyObj, PyObject *superShardingKeyObj,
+        dpiCommonCreateParams *dpiCommonParams,
+        dpiConnCreateParams *dpiCreateParams, uint32_t numExtraConns,
+        cxoConnection **extraConns)
+{
+    cxoConnection *extraConn;
+    uint32_t i;
+    int status, temp, invokeSessionCallback;
+    cxoConnectionParams params;
+    dpiErrorInfo errorInfo;
+    uint64_t startTime = 0;
+    PyObject *tempObj;
+
     // setup parameters
     cxoConnectionParams_initialize(&params);
     if (pool) {
-        dpiCreateParams.pool = pool->handle;
+        dpiCreateParams->pool = pool->handle;
         params.encoding = pool->encodingInfo.encoding;
         params.nencoding = pool->encodingInfo.nencoding;
     } else {
         params.encoding =
-                cxoUtils_getAdjustedEncoding(dpiCommonParams.encoding);
+                cxoUtils_getAdjustedEncoding(dpiCommonParams->encoding);
         params.nencoding =
-                cxoUtils_getAdjustedEncoding(dpiCommonParams.nencoding);
+                cxoUtils_getAdjustedEncoding(dpiCommonParams->nencoding);
     }
     if (cxoConnectionParams_processContext(&params, contextObj) < 0)
         return cxoConnectionParams_finalize(&params);
@@ -577,28 +895,24 @@ static int cxoConnection_init(cxoConnection *conn, PyObject *args,
             cxoBuffer_fromObject(&params.editionBuffer, editionObj,
                     params.encoding) < 0 ||
             cxoBuffer_fromObject(&params.tagBuffer, tagObj,
-                    params.encoding) < 0) {
-        Py_XDECREF(passwordObj);
+                    params.encoding) < 0)
         return cxoConnectionParams_finalize(&params);
-    }
-    Py_XDECREF(passwordObj);
     if (params.userNameBuffer.size == 0 && params.passwordBuffer.size == 0)
-        dpiCreateParams.externalAuth = 1;
-    dpiCreateParams.connectionClass = params.connectionClassBuffer.ptr;
-    dpiCreateParams.connectionClassLength = params.connectionClassBuffer.size;
-    dpiCreateParams.newPassword = params.newPasswordBuffer.ptr;
-    dpiCreateParams.newPasswordLength = params.newPasswordBuffer.size;
-    dpiCommonParams.edition = params.editionBuffer.ptr;
-    dpiCommonParams.editionLength = params.editionBuffer.size;
-    dpiCommonParams.stmtCacheSize = stmtCacheSize;
-    dpiCreateParams.tag = params.tagBuffer.ptr;
-    dpiCreateParams.tagLength = params.tagBuffer.size;
-    dpiCreateParams.appContext = params.appContext;
-    dpiCreateParams.numAppContext = params.numAppContext;
-    dpiCreateParams.shardingKeyColumns = params.shardingKeyColumns;
-    dpiCreateParams.numShardingKeyColumns = params.numShardingKeyColumns;
-    dpiCreateParams.superShardingKeyColumns = params.superShardingKeyColumns;
-    dpiCreateParams.numSuperShardingKeyColumns =
+        dpiCreateParams->externalAuth = 1;
+    dpiCreateParams->connectionClass = params.connectionClassBuffer.ptr;
+    dpiCreateParams->connectionClassLength = params.connectionClassBuffer.size;
+    dpiCreateParams->newPassword = params.newPasswordBuffer.ptr;
+    dpiCreateParams->newPasswordLength = params.newPasswordBuffer.size;
+    dpiCommonParams->edition = params.editionBuffer.ptr;
+    dpiCommonParams->editionLength = params.editionBuffer.size;
+    dpiCreateParams->tag = params.tagBuffer.ptr;
+    dpiCreateParams->tagLength = params.tagBuffer.size;
+    dpiCreateParams->appContext = params.appContext;
+    dpiCreateParams->numAppContext = params.numAppContext;
+    dpiCreateParams->shardingKeyColumns = params.shardingKeyColumns;
+    dpiCreateParams->numShardingKeyColumns = params.numShardingKeyColumns;
+    dpiCreateParams->superShardingKeyColumns = params.superShardingKeyColumns;
+    dpiCreateParams->numSuperShardingKeyColumns =
             params.numSuperShardingKeyColumns;
     if (pool && !pool->homogeneous && pool->username && conn->username) {
         temp = PyObject_RichCompareBool(conn->username, pool->username, Py_EQ);
@@ -608,28 +922,48 @@ static int cxoConnection_init(cxoConnection *conn, PyObject *args,
             params.userNameBuffer.size = 0;
     }
 
-    // create connection
-    Py_BEGIN_ALLOW_THREADS
-    status = dpiConn_create(cxoDpiContext, params.userNameBuffer.ptr,
-            params.userNameBuffer.size, params.passwordBuffer.ptr,
-            params.passwordBuffer.size, params.dsnBuffer.ptr,
-            params.dsnBuffer.size, &dpiCommonParams, &dpiCreateParams,
-            &conn->handle);
-    Py_END_ALLOW_THREADS
-    if (status < 0) {
-        cxoConnectionParams_finalize(&params);
-        return cxoError_raiseAndReturnInt();
+    // create connection; for connections acquired from a session pool, the
+    // time spent waiting and the outcome are recorded in the pool statistics
+    if (numExtraConns > 0) {
+        if (cxoConnection_createMany(conn, &params, dpiCommonParams,
+                dpiCreateParams, numExtraConns, extraConns) < 0)
+            return cxoConnectionParams_finalize(&params);
+    } else {
+        if (pool)
+            startTime = cxoUtils_getMonotonicTime();
+        Py_BEGIN_ALLOW_THREADS
+        status = dpiConn_create(cxoDpiContext, params.userNameBuffer.ptr,
+                params.userNameBuffer.size, params.passwordBuffer.ptr,
+                params.passwordBuffer.size, params.dsnBuffer.ptr,
+                params.dsnBuffer.size, dpiCommonParams, dpiCreateParams,
+                &conn->handle);
+        Py_END_ALLOW_THREADS
+        if (status < 0) {
+            dpiContext_getError(cxoDpiContext, &errorInfo);
+            cxoConnectionParams_finalize(&params);
+            if (pool)
+                cxoSessionPool_recordAcquire(pool, startTime,
+                        errorInfo.code);
+            return cxoError_raiseFromInfo(&errorInfo);
+        }
+        if (pool) {
+            cxoSessionPool_recordAcquire(pool, startTime, 0);
+            if (dpiCreateParams->outNewSession)
+                cxoSessionPool_recordNewSession(pool);
+            Py_INCREF(pool);
+            conn->sessionPool = pool;
+        }
     }
 
     // determine if session callback should be invoked; this takes place if
     // the connection is newly created by the pool or if the requested tag
     // does not match the actual tag
     invokeSessionCallback = 0;
-    if (dpiCreateParams.outNewSession ||
-            dpiCreateParams.outTagLength != params.tagBuffer.size ||
-            (dpiCreateParams.outTagLength > 0 &&
-            strncmp(dpiCreateParams.outTag, params.tagBuffer.ptr,
-                    dpiCreateParams.outTagLength) != 0))
+    if (dpiCreateParams->outNewSession ||
+            dpiCreateParams->outTagLength != params.tagBuffer.size ||
+            (dpiCreateParams->outTagLength > 0 &&
+            strncmp(dpiCreateParams->outTag, params.tagBuffer.ptr,
+                    dpiCreateParams->outTagLength) != 0))
         invokeSessionCallback = 1;
     cxoConnectionParams_finalize(&params);
 
@@ -645,10 +979,21 @@ static int cxoConnection_init(cxoConnection *conn, PyObject *args,
                 cxoUtils_getAdjustedEncoding(conn->encodingInfo.nencoding);
     }
 
+    // initialize the extra connections from the connection
+    for (i = 0; i < numExtraConns; i++) {
+        extraConn = extraConns[i];
+        extraConn->encodingInfo = conn->encodingInfo;
+        extraConn->threaded = conn->threaded;
+        Py_XINCREF(conn->username);
+        extraConn->username = conn->username;
+        Py_XINCREF(conn->dsn);
+        extraConn->dsn = conn->dsn;
+    }
+
     // set tag property
-    if (dpiCreateParams.outTagLength > 0) {
-        conn->tag = PyUnicode_Decode(dpiCreateParams.outTag,
-                dpiCreateParams.outTagLength, conn->encodingInfo.encoding,
+    if (dpiCreateParams->outTagLength > 0) {
+        conn->tag = PyUnicode_Decode(dpiCreateParams->outTag,
+                dpiCreateParams->outTagLength, conn->encodingInfo.encoding,
                 NULL);
         if (!conn->tag)
             return -1;
@@ -668,25 +1013,303 @@ static int cxoConnection_init(cxoConnection *conn, PyObject *args,
 }
 
 
+//-----------------------------------------------------------------------------
+// cxoConnection_initHelper()
+//   Initialize the connection members from the arguments and establish the
+// connection. If extra connections are supplied, standalone connections are
+// established for them concurrently using the same arguments.
+//-----------------------------------------------------------------------------
+static int cxoConnection_initHelper(cxoConnection *conn, PyObject *args,
+        PyObject *keywordArgs, uint32_t numExtraConns,
+        cxoConnection **extraConns)
+{
+    PyObject *usernameObj, *passwordObj, *dsnObj, *cclassObj, *editionObj;
+    PyObject *shardingKeyObj, *superShardingKeyObj;
+    dpiCommonCreateParams dpiCommonParams;
+    dpiConnCreateParams dpiCreateParams;
+    int status, threaded, events;
+    unsigned long long externalHandle;
+    PyObject *tagObj, *contextObj;
+    unsigned int stmtCacheSize;
+    PyObject *newPasswordObj;
+    cxoSessionPool *pool;
+
+    // define keyword arguments
+    static char *keywordList[] = { "user", "password", "dsn", "mode",
+            "handle", "pool", "threaded", "events", "cclass", "purity",
+            "newpassword", "encoding", "nencoding", "edition", "appcontext",
+            "tag", "matchanytag", "shardingkey", "supershardingkey",
+            "stmtcachesize", NULL };
+
+    // parse arguments
+    pool = NULL;
+    tagObj = Py_None;
+    threaded = 0;
+    externalHandle = 0;
+    newPasswordObj = usernameObj = NULL;
+    passwordObj = dsnObj = cclassObj = editionObj = NULL;
+    contextObj = shardingKeyObj = superShardingKeyObj = NULL;
+    stmtCacheSize = DPI_DEFAULT_STMT_CACHE_SIZE;
+    if (cxoUtils_initializeDPI(NULL) < 0)
+        return -1;
+    if (dpiContext_initCommonCreateParams(cxoDpiContext, &dpiCommonParams) < 0)
+        return cxoError_raiseAndReturnInt();
+    if (dpiContext_initConnCreateParams(cxoDpiContext, &dpiCreateParams) < 0)
+        return cxoError_raiseAndReturnInt();
+    if (!PyArg_ParseTupleAndKeywords(args, keywordArgs,
+            "|OOOiKO!ppOiOssOOOpOOI", keywordList, &usernameObj, &passwordObj,
+            &dsnObj, &dpiCreateParams.authMode, &externalHandle,
+            &cxoPyTypeSessionPool, &pool, &threaded, &events, &cclassObj,
+            &dpiCreateParams.purity, &newPasswordObj,
+            &dpiCommonParams.encoding, &dpiCommonParams.nencoding, &editionObj,
+            &contextObj, &tagObj, &dpiCreateParams.matchAnyTag,
+            &shardingKeyObj, &superShardingKeyObj, &stmtCacheSize))
+        return -1;
+    if (numExtraConns > 0 && (pool || externalHandle)) {
+        cxoError_raiseFromString(cxoProgrammingErrorException,
+                "pool and handle cannot be specified when creating multiple "
+                "connections");
+        return -1;
+    }
+    dpiCreateParams.externalHandle = (void*) externalHandle;
+    if (threaded)
+        dpiCommonParams.createMode |= DPI_MODE_CREATE_THREADED;
+    conn->threaded = (pool) ? pool->threaded : (threaded && !externalHandle);
+    if (events)
+        dpiCommonParams.createMode |= DPI_MODE_CREATE_EVENTS;
+
+    // keep a copy of the user name and connect string (DSN)
+    Py_XINCREF(usernameObj);
+    conn->username = usernameObj;
+    Py_XINCREF(dsnObj);
+    conn->dsn = dsnObj;
+    Py_XINCREF(passwordObj);
+
+    // perform some parsing, if no password and DSN are provided but the user
+    // name is provided
+    if (conn->username && !passwordObj && !dsnObj) {
+        if (cxoConnection_splitUsername(conn, &passwordObj) < 0)
+            return -1;
+    }
+
+    // establish the connection
+    dpiCommonParams.stmtCacheSize = stmtCacheSize;
+    status = cxoConnection_connect(conn, pool, passwordObj, cclassObj,
+            newPasswordObj, editionObj, contextObj, tagObj, shardingKeyObj,
+            superShardingKeyObj, &dpiCommonParams, &dpiCreateParams,
+            numExtraConns, extraConns);
+    Py_XDECREF(passwordObj);
+    return status;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoConnection_init()
+//   Initialize the connection members.
+//-----------------------------------------------------------------------------
+static int cxoConnection_init(cxoConnection *conn, PyObject *args,
+        PyObject *keywordArgs)
+{
+    return cxoConnection_initHelper(conn, args, keywordArgs, 0, NULL);
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoConnection_connectMany()
+//   Create the specified number of standalone connections concurrently using
+// the same arguments as those accepted by the Connection constructor (which
+// follow the number of connections in the arguments) and return them in a
+// list. Either all of the connections are created or none of them are.
+//-----------------------------------------------------------------------------
+PyObject *cxoConnection_connectMany(PyObject *args, PyObject *keywordArgs)
+{
+    PyObject *numConnsObj, *connArgs, *conns;
+    Py_ssize_t numConns, numCreated, i;
+    cxoConnection **connObjs;
+    int status;
+
+    // determine the number of connections
+    if (PyTuple_GET_SIZE(args) < 1) {
+        PyErr_SetString(PyExc_TypeError,
+                "connect_many() missing required argument 'n'");
+        return NULL;
+    }
+    numConnsObj = PyTuple_GET_ITEM(args, 0);
+    numConns = PyLong_AsSsize_t(numConnsObj);
+    if (PyErr_Occurred())
+        return NULL;
+    if (numConns < 1) {
+        cxoError_raiseFromString(cxoProgrammingErrorException,
+                "number of connections must be at least 1");
+        return NULL;
+    }
+
+    // create the connection objects
+    connObjs = PyMem_Malloc(numConns * sizeof(cxoConnection*));
+    if (!connObjs)
+        return PyErr_NoMemory();
+    status = 0;
+    for (numCreated = 0; numCreated < numConns; numCreated++) {
+        connObjs[numCreated] = (cxoConnection*)
+                cxoConnection_new(&cxoPyTypeConnection, NULL, NULL);
+        if (!connObjs[numCreated]) {
+            status = -1;
+            break;
+        }
+    }
+
+    // establish the connections
+    if (status == 0) {
+        connArgs = PyTuple_GetSlice(args, 1, PyTuple_GET_SIZE(args));
+        if (!connArgs)
+            status = -1;
+        else {
+            status = cxoConnection_initHelper(connObjs[0], connArgs,
+                    keywordArgs, (uint32_t) numConns - 1, connObjs + 1);
+            Py_DECREF(connArgs);
+        }
+    }
+
+    // transfer the connections to the list that is returned
+    conns = (status == 0) ? PyList_New(numConns) : NULL;
+    if (!conns) {
+        for (i = 0; i < numCreated; i++)
+            Py_DECREF(connObjs[i]);
+        PyMem_Free(connObjs);
+        return NULL;
+    }
+    for (i = 0; i < numConns; i++)
+        PyList_SET_ITEM(conns, i, (PyObject*) connObjs[i]);
+    PyMem_Free(connObjs);
+
+    return conns;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoConnection_newFromPool()
+//   Create a new connection acquired from the session pool. This is used by
+// the pool when connections of the default type are being acquired and avoids
+// building and parsing the keyword arguments needed to call the type and the
+// initialization of the parameters from scratch.
+//-----------------------------------------------------------------------------
+PyObject *cxoConnection_newFromPool(cxoSessionPool *pool,
+        PyObject *usernameObj, PyObject *passwordObj, PyObject *cclassObj,
+        uint32_t purity, PyObject *tagObj, int matchAnyTag,
+        PyObject *shardingKeyObj, PyObject *superShardingKeyObj)
+{
+    dpiCommonCreateParams dpiCommonParams;
+    dpiConnCreateParams dpiCreateParams;
+    cxoConnection *conn;
+    int status;
+
+    // initialize the parameters used as a starting point, if needed
+    if (!cxoConnectionPoolParamsInitialized) {
+        if (dpiContext_initCommonCreateParams(cxoDpiContext,
+                &cxoConnectionPoolCommonParams) < 0)
+            return cxoError_raiseAndReturnNull();
+        if (dpiContext_initConnCreateParams(cxoDpiContext,
+                &cxoConnectionPoolCreateParams) < 0)
+            return cxoError_raiseAndReturnNull();
+        cxoConnectionPoolParamsInitialized = 1;
+    }
+    dpiCommonParams = cxoConnectionPoolCommonParams;
+    dpiCreateParams = cxoConnectionPoolCreateParams;
+    dpiCreateParams.purity = purity;
+    dpiCreateParams.matchAnyTag = matchAnyTag;
+
+    // create the connection object and establish the connection
+    conn = (cxoConnection*) cxoConnection_new(&cxoPyTypeConnection, NULL,
+            NULL);
+    if (!conn)
+        return NULL;
+    Py_XINCREF(usernameObj);
+    conn->username = usernameObj;
+
+    // perform the same parsing as when the type is called, if no password is
+    // provided but the user name is provided
+    if (usernameObj && !passwordObj) {
+        if (cxoConnection_splitUsername(conn, &passwordObj) < 0) {
+            Py_DECREF(conn);
+            return NULL;
+        }
+    } else {
+        Py_XINCREF(passwordObj);
+    }
+    status = cxoConnection_connect(conn, pool, passwordObj, cclassObj, NULL,
+            NULL, NULL, (tagObj) ? tagObj : Py_None, shardingKeyObj,
+            superShardingKeyObj, &dpiCommonParams, &dpiCreateParams, 0, NULL);
+    Py_XDECREF(passwordObj);
+    if (status < 0) {
+        Py_DECREF(conn);
+        return NULL;
+    }
+
+    return (PyObject*) conn;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoConnection_newFromHandle()
+//   Create a new connection object for a session that was previously acquired
+// from the session pool and retained by it. A reference to the handle is
+// transferred to the connection object, even if an error takes place.
+//-----------------------------------------------------------------------------
+PyObject *cxoConnection_newFromHandle(cxoSessionPool *pool, dpiConn *handle)
+{
+    cxoConnection *conn;
+
+    conn = (cxoConnection*) cxoConnection_new(&cxoPyTypeConnection, NULL,
+            NULL);
+    if (!conn) {
+        Py_BEGIN_ALLOW_THREADS
+        dpiConn_release(handle);
+        Py_END_ALLOW_THREADS
+        return NULL;
+    }
+    conn->handle = handle;
+    conn->encodingInfo = pool->encodingInfo;
+    conn->threaded = pool->threaded;
+    Py_INCREF(pool);
+    conn->sessionPool = pool;
+
+    return (PyObject*) conn;
+}
+
+
 //-----------------------------------------------------------------------------
 // cxoConnection_free()
 //   Deallocate the connection, disconnecting from the database if necessary.
 //-----------------------------------------------------------------------------
 static void cxoConnection_free(cxoConnection *conn)
 {
+    cxoConnection_clearDefineCache(conn);
+    cxoConnection_clearTempLobPool(conn);
+    if (conn->tempLobs) {
+        PyMem_Free(conn->tempLobs);
+        conn->tempLobs = NULL;
+    }
     if (conn->handle) {
         Py_BEGIN_ALLOW_THREADS
         dpiConn_release(conn->handle);
         Py_END_ALLOW_THREADS
         conn->handle = NULL;
     }
-    Py_CLEAR(conn->sessionPool);
+    cxoSessionPool_detachConnection(conn);
     Py_CLEAR(conn->username);
     Py_CLEAR(conn->dsn);
     Py_CLEAR(conn->version);
+    Py_CLEAR(conn->versionInfo);
+    Py_CLEAR(conn->encoding);
+    Py_CLEAR(conn->nencoding);
     Py_CLEAR(conn->inputTypeHandler);
     Py_CLEAR(conn->outputTypeHandler);
     Py_CLEAR(conn->tag);
+    if (Py_TYPE(conn) == &cxoPyTypeConnection &&
+            cxoConnectionNumFree < CXO_CONNECTION_FREE_LIST_SIZE) {
+        cxoConnectionFreeList[cxoConnectionNumFree++] = conn;
+        return;
+    }
     Py_TYPE(conn)->tp_free((PyObject*) conn);
 }
 
@@ -844,29 +1467,72 @@ static PyObject *cxoConnection_createLob(cxoConnection *conn,
 
 
 //-----------------------------------------------------------------------------
-// cxoConnection_getVersion()
-//   Retrieve the version of the database and return it. Note that this
-// function also places the result in the associated dictionary so it is only
-// calculated once.
+// cxoConnection_cacheVersion()
+//   Retrieve the version of the database and retain it, both as a string and
+// as a tuple, so that it is only retrieved once for each connection object.
 //-----------------------------------------------------------------------------
-static PyObject *cxoConnection_getVersion(cxoConnection *conn, void *unused)
+static int cxoConnection_cacheVersion(cxoConnection *conn)
 {
     dpiVersionInfo versionInfo;
     char buffer[25];
     int status, len;
 
-    if (cxoConnection_isConnected(conn) < 0)
-        return NULL;
+    if (conn->version)
+        return 0;
     Py_BEGIN_ALLOW_THREADS
     status = dpiConn_getServerVersion(conn->handle, NULL, NULL, &versionInfo);
     Py_END_ALLOW_THREADS
     if (status < 0)
-        return cxoError_raiseAndReturnNull();
+        return cxoError_raiseAndReturnInt();
     len = snprintf(buffer, sizeof(buffer), "%d.%d.%d.%d.%d",
             versionInfo.versionNum, versionInfo.releaseNum,
             versionInfo.updateNum, versionInfo.portReleaseNum,
             versionInfo.portUpdateNum);
-    return PyUnicode_DecodeASCII(buffer, len, NULL);
+    conn->versionInfo = Py_BuildValue("(iiiii)", versionInfo.versionNum,
+            versionInfo.releaseNum, versionInfo.updateNum,
+            versionInfo.portReleaseNum, versionInfo.portUpdateNum);
+    if (!conn->versionInfo)
+        return -1;
+    conn->version = PyUnicode_DecodeASCII(buffer, len, NULL);
+    if (!conn->version) {
+        Py_CLEAR(conn->versionInfo);
+        return -1;
+    }
+    return 0;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoConnection_getVersion()
+//   Retrieve the version of the database and return it. Note that the result
+// is retained by the connection so it is only retrieved once.
+//-----------------------------------------------------------------------------
+static PyObject *cxoConnection_getVersion(cxoConnection *conn, void *unused)
+{
+    if (cxoConnection_isConnected(conn) < 0)
+        return NULL;
+    if (cxoConnection_cacheVersion(conn) < 0)
+        return NULL;
+    Py_INCREF(conn->version);
+    return conn->version;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoConnection_getCachedEncoding()
+//   Return the name of the encoding as a string, creating it the first time
+// it is requested and retaining it in the given location.
+//-----------------------------------------------------------------------------
+static PyObject *cxoConnection_getCachedEncoding(PyObject **cache,
+        const char *encoding)
+{
+    if (!*cache) {
+        *cache = PyUnicode_DecodeASCII(encoding, strlen(encoding), NULL);
+        if (!*cache)
+            return NULL;
+    }
+    Py_INCREF(*cache);
+    return *cache;
 }
 
 
@@ -876,8 +1542,8 @@ static PyObject *cxoConnection_getVersion(cxoConnection *conn, void *unused)
 //-----------------------------------------------------------------------------
 static PyObject *cxoConnection_getEncoding(cxoConnection *conn, void *unused)
 {
-    return PyUnicode_DecodeASCII(conn->encodingInfo.encoding,
-            strlen(conn->encodingInfo.encoding), NULL);
+    return cxoConnection_getCachedEncoding(&conn->encoding,
+            conn->encodingInfo.encoding);
 }
 
 
@@ -922,8 +1588,8 @@ static PyObject *cxoConnection_getHandle(cxoConnection *conn, void *unused)
 static PyObject *cxoConnection_getNationalEncoding(cxoConnection *conn,
         void *unused)
 {
-    return PyUnicode_DecodeASCII(conn->encodingInfo.nencoding,
-            strlen(conn->encodingInfo.nencoding), NULL);
+    return cxoConnection_getCachedEncoding(&conn->nencoding,
+            conn->encodingInfo.nencoding);
 }
 
 
@@ -938,6 +1604,89 @@ static PyObject *cxoConnection_getMaxBytesPerCharacter(cxoConnection *conn,
 }
 
 
+//-----------------------------------------------------------------------------
+// cxoConnection_getStats()
+//   Return a dictionary containing a snapshot of the execution statistics
+// aggregated across all cursors created by the connection.
+//-----------------------------------------------------------------------------
+static PyObject *cxoConnection_getStats(cxoConnection *conn, void *unused)
+{
+    return cxoStats_toDict(&conn->stats);
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoConnection_getTempLobPoolSize()
+//   Return the maximum number of temporary LOBs retained by the connection
+// for reuse when binding values.
+//-----------------------------------------------------------------------------
+static PyObject *cxoConnection_getTempLobPoolSize(cxoConnection *conn,
+        void *unused)
+{
+    return PyLong_FromUnsignedLong(conn->tempLobPoolSize);
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoConnection_getTempLobStats()
+//   Return a dictionary containing the number of temporary LOBs currently
+// retained by the connection and the number of temporary LOBs that have been
+// created, reused and discarded when binding values.
+//-----------------------------------------------------------------------------
+static PyObject *cxoConnection_getTempLobStats(cxoConnection *conn,
+        void *unused)
+{
+    return Py_BuildValue("{sIsKsKsK}", "pooled", conn->numTempLobs,
+            "created", (unsigned long long) conn->numTempLobsCreated,
+            "reused", (unsigned long long) conn->numTempLobsReused,
+            "discarded", (unsigned long long) conn->numTempLobsDiscarded);
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoConnection_setTempLobPoolSize()
+//   Set the maximum number of temporary LOBs retained by the connection for
+// reuse when binding values. A value of zero disables the pool. Any LOBs in
+// excess of the new size are released.
+//-----------------------------------------------------------------------------
+static int cxoConnection_setTempLobPoolSize(cxoConnection *conn,
+        PyObject *value, void *unused)
+{
+    unsigned long poolSize;
+    cxoTempLob *tempLobs;
+
+    poolSize = PyLong_AsUnsignedLong(value);
+    if (PyErr_Occurred())
+        return -1;
+    if (poolSize > UINT32_MAX) {
+        PyErr_SetString(PyExc_OverflowError, "pool size too large");
+        return -1;
+    }
+    if (conn->tempLobs && poolSize != conn->tempLobPoolSize) {
+        if (conn->numTempLobs > poolSize) {
+            Py_BEGIN_ALLOW_THREADS
+            while (conn->numTempLobs > poolSize)
+                dpiLob_release(conn->tempLobs[--conn->numTempLobs].handle);
+            Py_END_ALLOW_THREADS
+        }
+        if (poolSize == 0) {
+            PyMem_Free(conn->tempLobs);
+            conn->tempLobs = NULL;
+        } else {
+            tempLobs = PyMem_Realloc(conn->tempLobs,
+                    poolSize * sizeof(cxoTempLob));
+            if (!tempLobs) {
+                PyErr_NoMemory();
+                return -1;
+            }
+            conn->tempLobs = tempLobs;
+        }
+    }
+    conn->tempLobPoolSize = (uint32_t) poolSize;
+    return 0;
+}
+
+
 //-----------------------------------------------------------------------------
 // cxoConnection_close()
 //   Close the connection, disconnecting from the database.
@@ -950,6 +1699,19 @@ static PyObject *cxoConnection_close(cxoConnection *conn, PyObject *args)
 
     if (cxoConnection_isConnected(conn) < 0)
         return NULL;
+    cxoConnection_clearDefineCache(conn);
+    cxoConnection_clearTempLobPool(conn);
+
+    // connections acquired from a pool using thread affinity may be retained
+    // by the pool for the calling thread instead of being released
+    if (conn->sessionPool) {
+        status = cxoSessionPool_cacheConnection(conn->sessionPool, conn);
+        if (status < 0)
+            return NULL;
+        if (status > 0)
+            Py_RETURN_NONE;
+    }
+
     if (cxoBuffer_fromObject(&tagBuffer, conn->tag,
             conn->encodingInfo.encoding) < 0)
         return NULL;
@@ -966,6 +1728,7 @@ static PyObject *cxoConnection_close(cxoConnection *conn, PyObject *args)
     if (status < 0)
         return cxoError_raiseAndReturnNull();
     conn->handle = NULL;
+    cxoSessionPool_detachConnection(conn);
 
     Py_RETURN_NONE;
 }
@@ -977,15 +1740,23 @@ static PyObject *cxoConnection_close(cxoConnection *conn, PyObject *args)
 //-----------------------------------------------------------------------------
 static PyObject *cxoConnection_commit(cxoConnection *conn, PyObject *args)
 {
-    int status;
+    uint64_t startTime = 0;
+    int status, isTraced;
 
     if (cxoConnection_isConnected(conn) < 0)
         return NULL;
+    isTraced = cxoTrace_isEnabled();
+    if (isTraced)
+        startTime = cxoUtils_getMonotonicTime();
     Py_BEGIN_ALLOW_THREADS
     status = dpiConn_commit(conn->handle);
     Py_END_ALLOW_THREADS
     if (status < 0)
-        return cxoError_raiseAndReturnNull();
+        cxoError_raiseAndReturnNull();
+    if (isTraced)
+        cxoTrace_record(CXO_TRACE_OP_COMMIT, NULL, NULL, startTime, 0);
+    if (status < 0)
+        return NULL;
 
     Py_RETURN_NONE;
 }
@@ -1057,15 +1828,23 @@ static PyObject *cxoConnection_prepare(cxoConnection *conn, PyObject *args)
 //-----------------------------------------------------------------------------
 static PyObject *cxoConnection_rollback(cxoConnection *conn, PyObject *args)
 {
-    int status;
+    uint64_t startTime = 0;
+    int status, isTraced;
 
     if (cxoConnection_isConnected(conn) < 0)
         return NULL;
+    isTraced = cxoTrace_isEnabled();
+    if (isTraced)
+        startTime = cxoUtils_getMonotonicTime();
     Py_BEGIN_ALLOW_THREADS
     status = dpiConn_rollback(conn->handle);
     Py_END_ALLOW_THREADS
     if (status < 0)
-        return cxoError_raiseAndReturnNull();
+        cxoError_raiseAndReturnNull();
+    if (isTraced)
+        cxoTrace_record(CXO_TRACE_OP_ROLLBACK, NULL, NULL, startTime, 0);
+    if (status < 0)
+        return NULL;
 
     Py_RETURN_NONE;
 }
@@ -1260,10 +2039,11 @@ static PyObject *cxoConnection_dequeue(cxoConnection *conn, PyObject* args,
     const char *messageIdValue;
     cxoDeqOptions *optionsObj;
     uint32_t messageIdLength;
+    uint64_t startTime = 0;
     cxoObject *payloadObj;
+    int status, isTraced;
     cxoBuffer nameBuffer;
     PyObject *nameObj;
-    int status;
 
     // parse arguments
     if (!PyArg_ParseTupleAndKeywords(args, keywordArgs, "OO!O!O!", keywordList,
@@ -1277,6 +2057,9 @@ static PyObject *cxoConnection_dequeue(cxoConnection *conn, PyObject* args,
         return NULL;
 
     // dequeue payload
+    isTraced = cxoTrace_isEnabled();
+    if (isTraced)
+        startTime = cxoUtils_getMonotonicTime();
     Py_BEGIN_ALLOW_THREADS
     status = dpiConn_deqObject(conn->handle, nameBuffer.ptr, nameBuffer.size,
             optionsObj->handle, propertiesObj->handle, payloadObj->handle,
@@ -1284,7 +2067,12 @@ static PyObject *cxoConnection_dequeue(cxoConnection *conn, PyObject* args,
     Py_END_ALLOW_THREADS
     cxoBuffer_clear(&nameBuffer);
     if (status < 0)
-        return cxoError_raiseAndReturnNull();
+        cxoError_raiseAndReturnNull();
+    if (isTraced)
+        cxoTrace_record(CXO_TRACE_OP_DEQUEUE, nameObj, NULL, startTime,
+                (status < 0) ? 0 : 1);
+    if (status < 0)
+        return NULL;
 
     // return message id
     if (!messageIdValue)
@@ -1307,10 +2095,11 @@ static PyObject *cxoConnection_enqueue(cxoConnection *conn, PyObject* args,
     const char *messageIdValue;
     cxoEnqOptions *optionsObj;
     uint32_t messageIdLength;
+    uint64_t startTime = 0;
     cxoObject *payloadObj;
+    int status, isTraced;
     cxoBuffer nameBuffer;
     PyObject *nameObj;
-    int status;
 
     // parse arguments
     if (!PyArg_ParseTupleAndKeywords(args, keywordArgs, "OO!O!O!", keywordList,
@@ -1324,6 +2113,9 @@ static PyObject *cxoConnection_enqueue(cxoConnection *conn, PyObject* args,
         return NULL;
 
     // enqueue payload
+    isTraced = cxoTrace_isEnabled();
+    if (isTraced)
+        startTime = cxoUtils_getMonotonicTime();
     Py_BEGIN_ALLOW_THREADS
     status = dpiConn_enqObject(conn->handle, nameBuffer.ptr, nameBuffer.size,
             optionsObj->handle, propertiesObj->handle, payloadObj->handle,
@@ -1331,7 +2123,12 @@ static PyObject *cxoConnection_enqueue(cxoConnection *conn, PyObject* args,
     Py_END_ALLOW_THREADS
     cxoBuffer_clear(&nameBuffer);
     if (status < 0)
-        return cxoError_raiseAndReturnNull();
+        cxoError_raiseAndReturnNull();
+    if (isTraced)
+        cxoTrace_record(CXO_TRACE_OP_ENQUEUE, nameObj, NULL, startTime,
+                (status < 0) ? 0 : 1);
+    if (status < 0)
+        return NULL;
 
     // return message id
     return PyBytes_FromStringAndSize(messageIdValue, messageIdLength);
@@ -1945,6 +2742,97 @@ static PyObject *cxoConnection_setOciAttr(cxoConnection *conn, PyObject *args,
 }
 
 
+//-----------------------------------------------------------------------------
+// cxoConnection_setInfoItem()
+//   Set an item in the session information dictionary and release the
+// reference to the value.
+//-----------------------------------------------------------------------------
+static int cxoConnection_setInfoItem(PyObject *dict, const char *key,
+        PyObject *value)
+{
+    int status;
+
+    if (!value)
+        return -1;
+    status = PyDict_SetItemString(dict, key, value);
+    Py_DECREF(value);
+    return status;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoConnection_sessionInfo()
+//   Return a dictionary containing the properties of the session in a single
+// call. The server version and encodings are retained by the connection after
+// they are first retrieved; the remaining properties are held by the client
+// and do not require a round trip to the database.
+//-----------------------------------------------------------------------------
+static PyObject *cxoConnection_sessionInfo(cxoConnection *conn,
+        PyObject *args)
+{
+    uint32_t stmtCacheSize, callTimeout, ltxidLength;
+    const char *ltxid;
+    PyObject *dict;
+
+    if (cxoConnection_isConnected(conn) < 0)
+        return NULL;
+    if (cxoConnection_cacheVersion(conn) < 0)
+        return NULL;
+    if (dpiConn_getStmtCacheSize(conn->handle, &stmtCacheSize) < 0 ||
+            dpiConn_getLTXID(conn->handle, &ltxid, &ltxidLength) < 0)
+        return cxoError_raiseAndReturnNull();
+    if (dpiConn_getCallTimeout(conn->handle, &callTimeout) < 0) {
+        if (cxoClientVersionInfo.versionNum >= 18)
+            return cxoError_raiseAndReturnNull();
+        callTimeout = 0;
+    }
+    dict = PyDict_New();
+    if (!dict)
+        return NULL;
+    if (PyDict_SetItemString(dict, "version", conn->version) < 0 ||
+            PyDict_SetItemString(dict, "version_info",
+                    conn->versionInfo) < 0 ||
+            cxoConnection_setInfoItem(dict, "encoding",
+                    cxoConnection_getEncoding(conn, NULL)) < 0 ||
+            cxoConnection_setInfoItem(dict, "nencoding",
+                    cxoConnection_getNationalEncoding(conn, NULL)) < 0 ||
+            cxoConnection_setInfoItem(dict, "max_bytes_per_character",
+                    PyLong_FromLong(
+                            conn->encodingInfo.maxBytesPerCharacter)) < 0 ||
+            cxoConnection_setInfoItem(dict, "current_schema",
+                    cxoConnection_getAttrText(conn,
+                            dpiConn_getCurrentSchema)) < 0 ||
+            cxoConnection_setInfoItem(dict, "edition",
+                    cxoConnection_getAttrText(conn,
+                            dpiConn_getEdition)) < 0 ||
+            cxoConnection_setInfoItem(dict, "external_name",
+                    cxoConnection_getAttrText(conn,
+                            dpiConn_getExternalName)) < 0 ||
+            cxoConnection_setInfoItem(dict, "internal_name",
+                    cxoConnection_getAttrText(conn,
+                            dpiConn_getInternalName)) < 0 ||
+            cxoConnection_setInfoItem(dict, "ltxid",
+                    PyBytes_FromStringAndSize(ltxid, ltxidLength)) < 0 ||
+            cxoConnection_setInfoItem(dict, "stmtcachesize",
+                    PyLong_FromUnsignedLong(stmtCacheSize)) < 0 ||
+            cxoConnection_setInfoItem(dict, "call_timeout",
+                    PyLong_FromUnsignedLong(callTimeout)) < 0 ||
+            cxoConnection_setInfoItem(dict, "autocommit",
+                    PyBool_FromLong(conn->autocommit)) < 0 ||
+            PyDict_SetItemString(dict, "username",
+                    (conn->username) ? conn->username : Py_None) < 0 ||
+            PyDict_SetItemString(dict, "dsn",
+                    (conn->dsn) ? conn->dsn : Py_None) < 0 ||
+            PyDict_SetItemString(dict, "tag",
+                    (conn->tag) ? conn->tag : Py_None) < 0) {
+        Py_DECREF(dict);
+        return NULL;
+    }
+
+    return dict;
+}
+
+
 //-----------------------------------------------------------------------------
 // declaration of methods for the Python type
 //-----------------------------------------------------------------------------
@@ -1988,6 +2876,8 @@ static PyMethodDef cxoMethods[] = {
     { "createlob", (PyCFunction) cxoConnection_createLob, METH_O },
     { "getSodaDatabase", (PyCFunction) cxoConnection_getSodaDatabase,
             METH_NOARGS },
+    { "session_info", (PyCFunction) cxoConnection_sessionInfo,
+            METH_NOARGS },
     { "_get_oci_attr", (PyCFunction) cxoConnection_getOciAttr,
             METH_VARARGS | METH_KEYWORDS },
     { "_set_oci_attr", (PyCFunction) cxoConnection_setOciAttr,
@@ -2009,6 +2899,9 @@ static PyMemberDef cxoMembers[] = {
             offsetof(cxoConnection, inputTypeHandler), 0 },
     { "outputtypehandler", T_OBJECT,
             offsetof(cxoConnection, outputTypeHandler), 0 },
+    { "stats_enabled", T_BOOL, offsetof(cxoConnection, statsEnabled), 0 },
+    { "temp_lob_max_size", T_ULONGLONG,
+            offsetof(cxoConnection, tempLobMaxSize), 0 },
     { NULL }
 };
 
@@ -2041,6 +2934,10 @@ static PyGetSetDef cxoCalcMembers[] = {
     { "edition", (getter) cxoConnection_getEdition, 0, 0, 0 },
     { "ltxid", (getter) cxoConnection_getLTXID, 0, 0, 0 },
     { "handle", (getter) cxoConnection_getHandle, 0, 0, 0 },
+    { "stats", (getter) cxoConnection_getStats, 0, 0, 0 },
+    { "temp_lob_pool_size", (getter) cxoConnection_getTempLobPoolSize,
+            (setter) cxoConnection_setTempLobPoolSize, 0, 0 },
+    { "temp_lob_stats", (getter) cxoConnection_getTempLobStats, 0, 0, 0 },
     { "Error", (getter) cxoConnection_getException, NULL, NULL,
             &cxoErrorException },
     { "Warning", (getter) cxoConnection_getException, NULL, NULL,
@@ -14,6 +14,22 @@
 
 #include "cxoModule.h"
 
+// statistics are tracked if enabled on the cursor or on its connection;
+// blocking calls are timed if statistics are tracked or tracing is enabled
+#define cxoCursor_trackStats(cursor) \
+        ((cursor)->statsEnabled || (cursor)->connection->statsEnabled)
+#define cxoCursor_isTimed(cursor) \
+        (cxoCursor_trackStats(cursor) || cxoTrace_isEnabled())
+
+//-----------------------------------------------------------------------------
+// free list of cursor objects of the default type which have been deallocated
+// and are available for reuse; this avoids the cost of allocating a new object
+// each time a short-lived cursor is created
+//-----------------------------------------------------------------------------
+#define CXO_CURSOR_FREE_LIST_SIZE       32
+static cxoCursor *cxoCursorFreeList[CXO_CURSOR_FREE_LIST_SIZE];
+static int cxoCursorNumFree = 0;
+
 //-----------------------------------------------------------------------------
 // cxoCursor_new()
 //   Create a new cursor object.
@@ -21,6 +37,16 @@
 static PyObject *cxoCursor_new(PyTypeObject *type, PyObject *args,
         PyObject *keywordArgs)
 {
+    cxoCursor *cursor;
+
+    // reuse an object from the free list, if one is available
+    if (type == &cxoPyTypeCursor && cxoCursorNumFree > 0) {
+        cursor = cxoCursorFreeList[--cxoCursorNumFree];
+        memset((char*) cursor + sizeof(PyObject), 0,
+                sizeof(cxoCursor) - sizeof(PyObject));
+        return PyObject_Init((PyObject*) cursor, type);
+    }
+
     return type->tp_alloc(type, 0);
 }
 
@@ -50,6 +76,8 @@ static int cxoCursor_init(cxoCursor *cursor, PyObject *args,
     cursor->fetchArraySize = 100;
     cursor->prefetchRows = DPI_DEFAULT_PREFETCH_ROWS;
     cursor->bindArraySize = 1;
+    cursor->windowCacheSize = 1000;
+    cursor->fetchLobs = 1;
     cursor->isOpen = 1;
 
     return 0;
@@ -80,6 +108,30 @@ static PyObject *cxoCursor_repr(cxoCursor *cursor)
 }
 
 
+//-----------------------------------------------------------------------------
+// cxoCursor_clearFetchVariables()
+//   Clear the fetch variables of the cursor. Variables that can be reused by
+// subsequent queries are retained by the connection.
+//-----------------------------------------------------------------------------
+static void cxoCursor_clearFetchVariables(cxoCursor *cursor)
+{
+    PyObject *var;
+    Py_ssize_t i;
+
+    if (!cursor->fetchVariables)
+        return;
+    if (cursor->connection && Py_REFCNT(cursor->fetchVariables) == 1) {
+        for (i = 0; i < PyList_GET_SIZE(cursor->fetchVariables); i++) {
+            var = PyList_GET_ITEM(cursor->fetchVariables, i);
+            if (var && cxoConnection_cacheDefine(cursor->connection,
+                    (cxoVar*) var))
+                PyList_SET_ITEM(cursor->fetchVariables, i, NULL);
+        }
+    }
+    Py_CLEAR(cursor->fetchVariables);
+}
+
+
 //-----------------------------------------------------------------------------
 // cxoCursor_free()
 //   Deallocate the cursor.
@@ -89,7 +141,7 @@ static void cxoCursor_free(cxoCursor *cursor)
     Py_CLEAR(cursor->statement);
     Py_CLEAR(cursor->statementTag);
     Py_CLEAR(cursor->bindVariables);
-    Py_CLEAR(cursor->fetchVariables);
+    cxoCursor_clearFetchVariables(cursor);
     if (cursor->handle) {
         dpiStmt_release(cursor->handle);
         cursor->handle = NULL;
@@ -98,6 +150,12 @@ static void cxoCursor_free(cxoCursor *cursor)
     Py_CLEAR(cursor->rowFactory);
     Py_CLEAR(cursor->inputTypeHandler);
     Py_CLEAR(cursor->outputTypeHandler);
+    Py_CLEAR(cursor->windowCache);
+    if (Py_TYPE(cursor) == &cxoPyTypeCursor &&
+            cxoCursorNumFree < CXO_CURSOR_FREE_LIST_SIZE) {
+        cxoCursorFreeList[cxoCursorNumFree++] = cursor;
+        return;
+    }
     Py_TYPE(cursor)->tp_free((PyObject*) cursor);
 }
 
@@ -118,6 +176,44 @@ static int cxoCursor_isOpen(cxoCursor *cursor)
 }
 
 
+//-----------------------------------------------------------------------------
+// cxoCursor_recordStats()
+//   Add the statistics to the ones kept by the cursor and to the aggregate
+// kept by the connection to which the cursor belongs.
+//-----------------------------------------------------------------------------
+static void cxoCursor_recordStats(cxoCursor *cursor, const cxoStats *delta)
+{
+    cxoStats_add(&cursor->stats, delta);
+    cxoStats_add(&cursor->connection->stats, delta);
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoCursor_recordWait()
+//   Record the time spent waiting for a blocking call that started at the
+// given time, along with the number of fetches performed and rows processed
+// by that call. The statistics are updated if they are being tracked and a
+// trace event is recorded if tracing is enabled.
+//-----------------------------------------------------------------------------
+static void cxoCursor_recordWait(cxoCursor *cursor, cxoTraceOp op,
+        uint64_t startTime, uint32_t numFetches, uint64_t numRows)
+{
+    cxoStats delta;
+
+    if (cxoCursor_trackStats(cursor)) {
+        memset(&delta, 0, sizeof(delta));
+        delta.numFetches = numFetches;
+        if (numFetches > 0)
+            delta.numRowsFetched = numRows;
+        delta.waitTime = cxoUtils_getMonotonicTime() - startTime;
+        cxoCursor_recordStats(cursor, &delta);
+    }
+    if (cxoTrace_isEnabled())
+        cxoTrace_record(op, cursor->statement, cursor->statementTag,
+                startTime, numRows);
+}
+
+
 //-----------------------------------------------------------------------------
 // cxoCursor_fetchRow()
 //   Fetch a single row from the cursor. Internally the number of rows left in
@@ -127,19 +223,28 @@ static int cxoCursor_isOpen(cxoCursor *cursor)
 static int cxoCursor_fetchRow(cxoCursor *cursor, int *found,
         uint32_t *bufferRowIndex)
 {
-    int status;
+    uint64_t startTime = 0;
+    int status, isTimed;
 
     // if the number of rows in the fetch buffer is zero and there are more
     // rows to fetch, call DPI with threading enabled in order to perform any
     // fetch requiring a network round trip
     if (cursor->numRowsInFetchBuffer == 0 && cursor->moreRowsToFetch) {
+        isTimed = cxoCursor_isTimed(cursor);
+        if (isTimed)
+            startTime = cxoUtils_getMonotonicTime();
         Py_BEGIN_ALLOW_THREADS
         status = dpiStmt_fetchRows(cursor->handle, cursor->fetchArraySize,
                 &cursor->fetchBufferRowIndex, &cursor->numRowsInFetchBuffer,
                 &cursor->moreRowsToFetch);
         Py_END_ALLOW_THREADS
         if (status < 0)
-            return cxoError_raiseAndReturnInt();
+            cxoError_raiseAndReturnInt();
+        if (isTimed)
+            cxoCursor_recordWait(cursor, CXO_TRACE_OP_FETCH, startTime, 1,
+                    (status < 0) ? 0 : cursor->numRowsInFetchBuffer);
+        if (status < 0)
+            return -1;
     }
 
     // keep track of where we are in the fetch buffer
@@ -155,6 +260,40 @@ static int cxoCursor_fetchRow(cxoCursor *cursor, int *found,
 }
 
 
+//-----------------------------------------------------------------------------
+// cxoCursor_defineVar()
+//   Define the variable for the given column of the query. For LOB columns
+// fetched inline, the LOB prefetch size of the session is set only for the
+// duration of the define and the previous value is then restored, so that
+// other cursors and later users of the session are not affected.
+//-----------------------------------------------------------------------------
+static int cxoCursor_defineVar(cxoCursor *cursor, uint32_t pos, cxoVar *var)
+{
+    cxoConnection *conn = cursor->connection;
+    uint32_t prevLobPrefetchSize;
+    cxoErrorBuffer error;
+    int status;
+
+    if (var->inlineLobSize == 0) {
+        if (dpiStmt_define(cursor->handle, pos, var->handle) < 0)
+            return cxoError_raiseAndReturnInt();
+        return 0;
+    }
+    prevLobPrefetchSize = conn->lobPrefetchSize;
+    if (cxoConnection_setLobPrefetchSize(conn, var->inlineLobSize) < 0)
+        return -1;
+    status = dpiStmt_define(cursor->handle, pos, var->handle);
+    if (status < 0)
+        cxoError_captureInfo(&error);
+    if (cxoConnection_setLobPrefetchSize(conn, prevLobPrefetchSize) < 0 &&
+            status == 0)
+        return -1;
+    if (status < 0)
+        return cxoError_raiseFromInfo(&error.info);
+    return 0;
+}
+
+
 //-----------------------------------------------------------------------------
 // cxoCursor_performDefine()
 //   Perform the defines for the cursor. At this point it is assumed that the
@@ -169,6 +308,7 @@ static int cxoCursor_performDefine(cxoCursor *cursor, uint32_t numQueryColumns)
     uint32_t pos, size;
     cxoDbType *dbType;
     char message[120];
+    cxoStats delta;
     cxoVar *var;
 
     // initialize fetching variables; these are used to reduce the number of
@@ -176,6 +316,7 @@ static int cxoCursor_performDefine(cxoCursor *cursor, uint32_t numQueryColumns)
     // there is a significant amount of overhead in making these calls
     cursor->numRowsInFetchBuffer = 0;
     cursor->moreRowsToFetch = 1;
+    Py_CLEAR(cursor->windowCache);
 
     // if fetch variables already exist, nothing more to do (we are executing
     // the same statement and therefore all defines have already been
@@ -260,21 +401,56 @@ static int cxoCursor_performDefine(cxoCursor *cursor, uint32_t numQueryColumns)
             }
         }
 
-        // if no variable created yet, use the database metadata
+        // if no variable created yet, reuse one retained by the connection
+        // or create one using the database metadata
+        if (!var && !objectType)
+            var = cxoConnection_getCachedDefine(cursor->connection,
+                    transformNum, size, cursor->fetchArraySize);
         if (!var) {
+            switch (transformNum) {
+                case CXO_TRANSFORM_BLOB:
+                case CXO_TRANSFORM_CLOB:
+                case CXO_TRANSFORM_NCLOB:
+                    if (!cursor->fetchLobs) {
+                        transformNum = (transformNum == CXO_TRANSFORM_BLOB) ?
+                                CXO_TRANSFORM_LONG_BINARY :
+                                CXO_TRANSFORM_LONG_STRING;
+                        size = 0;
+                    }
+                    break;
+                default:
+                    break;
+            }
             var = cxoVar_new(cursor, cursor->fetchArraySize, transformNum,
                     size, 0, objectType);
             if (!var) {
                 Py_XDECREF(objectType);
                 return -1;
             }
+            switch (transformNum) {
+                case CXO_TRANSFORM_BLOB:
+                case CXO_TRANSFORM_CLOB:
+                case CXO_TRANSFORM_NCLOB:
+                    var->inlineLobSize = cursor->inlineLobSize;
+                    break;
+                default:
+                    break;
+            }
         }
 
         // add the variable to the fetch variables and perform define
         Py_XDECREF(objectType);
         PyList_SET_ITEM(cursor->fetchVariables, pos - 1, (PyObject *) var);
-        if (dpiStmt_define(cursor->handle, pos, var->handle) < 0)
-            return cxoError_raiseAndReturnInt();
+        if (cxoCursor_defineVar(cursor, pos, var) < 0)
+            return -1;
+
+        // keep track of the size of the define buffers, if applicable
+        if (cxoCursor_trackStats(cursor)) {
+            memset(&delta, 0, sizeof(delta));
+            delta.numDefineBytes =
+                    (uint64_t) var->bufferSize * var->allocatedElements;
+            cxoCursor_recordStats(cursor, &delta);
+        }
 
     }
 
@@ -520,6 +696,17 @@ static PyObject *cxoCursor_getOciAttr(cxoCursor *cursor, PyObject *args,
 }
 
 
+//-----------------------------------------------------------------------------
+// cxoCursor_getInlineLobSize()
+//   Return the size at or below which LOBs are fetched as strings or bytes
+// instead of as LOB locators.
+//-----------------------------------------------------------------------------
+static PyObject *cxoCursor_getInlineLobSize(cxoCursor *cursor, void *unused)
+{
+    return PyLong_FromUnsignedLong(cursor->inlineLobSize);
+}
+
+
 //-----------------------------------------------------------------------------
 // cxoCursor_getPrefetchRows()
 //   Return an integer providing the number of rows that are prefetched by the
@@ -533,6 +720,17 @@ static PyObject *cxoCursor_getPrefetchRows(cxoCursor *cursor, void *unused)
 }
 
 
+//-----------------------------------------------------------------------------
+// cxoCursor_getStats()
+//   Return a dictionary containing a snapshot of the execution statistics
+// collected by the cursor.
+//-----------------------------------------------------------------------------
+static PyObject *cxoCursor_getStats(cxoCursor *cursor, void *unused)
+{
+    return cxoStats_toDict(&cursor->stats);
+}
+
+
 //-----------------------------------------------------------------------------
 // cxoCursor_close()
 //   Close the cursor. Any action taken on this cursor from this point forward
@@ -543,7 +741,7 @@ static PyObject *cxoCursor_close(cxoCursor *cursor, PyObject *args)
     if (cxoCursor_isOpen(cursor) < 0)
         return NULL;
     Py_CLEAR(cursor->bindVariables);
-    Py_CLEAR(cursor->fetchVariables);
+    cxoCursor_clearFetchVariables(cursor);
     if (cursor->handle) {
         if (dpiStmt_close(cursor->handle, NULL, 0) < 0)
             return cxoError_raiseAndReturnNull();
@@ -564,7 +762,10 @@ static int cxoCursor_setBindVariableHelper(cxoCursor *cursor,
         unsigned numElements, unsigned arrayPos, PyObject *value,
         cxoVar *origVar, cxoVar **newVar, int deferTypeAssignment)
 {
+    uint64_t numReallocations = 0;
+    dpiVar *origHandle;
     cxoVar *varToSet;
+    cxoStats delta;
     int isValueVar;
 
     // initialization
@@ -609,9 +810,12 @@ static int cxoCursor_setBindVariableHelper(cxoCursor *cursor,
                 if (!*newVar)
                     return -1;
                 varToSet = *newVar;
+                numReallocations++;
             }
 
-            // attempt to set the value
+            // attempt to set the value; the variable may be reallocated if
+            // the value is larger than the variable can hold
+            origHandle = (varToSet) ? varToSet->handle : NULL;
             if (varToSet && cxoVar_setValue(varToSet, arrayPos, value) < 0) {
 
                 // executemany() should simply fail after the first element
@@ -622,7 +826,10 @@ static int cxoCursor_setBindVariableHelper(cxoCursor *cursor,
                 PyErr_Clear();
                 Py_CLEAR(*newVar);
                 origVar = NULL;
+                numReallocations++;
 
+            } else if (varToSet && varToSet->handle != origHandle) {
+                numReallocations++;
             }
 
         }
@@ -651,6 +858,13 @@ static int cxoCursor_setBindVariableHelper(cxoCursor *cursor,
 
     }
 
+    // keep track of the number of reallocations, if applicable
+    if (numReallocations > 0 && cxoCursor_trackStats(cursor)) {
+        memset(&delta, 0, sizeof(delta));
+        delta.numBindReallocations = numReallocations;
+        cxoCursor_recordStats(cursor, &delta);
+    }
+
     return 0;
 }
 
@@ -794,20 +1008,24 @@ int cxoCursor_performBind(cxoCursor *cursor)
 
 
 //-----------------------------------------------------------------------------
-// cxoCursor_createRow()
-//   Create an object for the row. The object created is a tuple unless a row
-// factory function has been defined in which case it is the result of the
-// row factory function called with the argument tuple that would otherwise be
-// returned.
+// cxoCursor_createRowTuple()
+//   Create a tuple containing the values found in the row at the given
+// position in the fetch buffer.
 //-----------------------------------------------------------------------------
-static PyObject *cxoCursor_createRow(cxoCursor *cursor, uint32_t pos)
+static PyObject *cxoCursor_createRowTuple(cxoCursor *cursor, uint32_t pos)
 {
-    PyObject *tuple, *item, *result;
+    PyObject *tuple, *item;
     Py_ssize_t numItems, i;
+    uint64_t startTime = 0;
+    cxoStats delta;
+    int trackStats;
     cxoVar *var;
 
     // bump row count as a new row has been found
     cursor->rowCount++;
+    trackStats = cxoCursor_trackStats(cursor);
+    if (trackStats)
+        startTime = cxoUtils_getMonotonicTime();
 
     // create a new tuple
     numItems = PyList_GET_SIZE(cursor->fetchVariables);
@@ -826,17 +1044,52 @@ static PyObject *cxoCursor_createRow(cxoCursor *cursor, uint32_t pos)
         PyTuple_SET_ITEM(tuple, i, item);
     }
 
-    // if a row factory is defined, call it
-    if (cursor->rowFactory && cursor->rowFactory != Py_None) {
-        result = PyObject_CallObject(cursor->rowFactory, tuple);
-        Py_DECREF(tuple);
-        return result;
+    // keep track of the time spent converting the row, if applicable
+    if (trackStats) {
+        memset(&delta, 0, sizeof(delta));
+        delta.conversionTime = cxoUtils_getMonotonicTime() - startTime;
+        cxoCursor_recordStats(cursor, &delta);
     }
 
     return tuple;
 }
 
 
+//-----------------------------------------------------------------------------
+// cxoCursor_applyRowFactory()
+//   Return the object for the row tuple. This is the tuple itself unless a
+// row factory function has been defined in which case it is the result of the
+// row factory function called with the tuple as its arguments.
+//-----------------------------------------------------------------------------
+static PyObject *cxoCursor_applyRowFactory(cxoCursor *cursor, PyObject *tuple)
+{
+    if (cursor->rowFactory && cursor->rowFactory != Py_None)
+        return PyObject_CallObject(cursor->rowFactory, tuple);
+    Py_INCREF(tuple);
+    return tuple;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoCursor_createRow()
+//   Create an object for the row. The object created is a tuple unless a row
+// factory function has been defined in which case it is the result of the
+// row factory function called with the argument tuple that would otherwise be
+// returned.
+//-----------------------------------------------------------------------------
+static PyObject *cxoCursor_createRow(cxoCursor *cursor, uint32_t pos)
+{
+    PyObject *tuple, *result;
+
+    tuple = cxoCursor_createRowTuple(cursor, pos);
+    if (!tuple)
+        return NULL;
+    result = cxoCursor_applyRowFactory(cursor, tuple);
+    Py_DECREF(tuple);
+    return result;
+}
+
+
 //-----------------------------------------------------------------------------
 // cxoCursor_internalPrepare()
 //   Internal method for preparing a statement for execution.
@@ -845,7 +1098,8 @@ static int cxoCursor_internalPrepare(cxoCursor *cursor, PyObject *statement,
         PyObject *statementTag)
 {
     cxoBuffer statementBuffer, tagBuffer;
-    int status;
+    uint64_t startTime = 0;
+    int status, isTimed;
 
     // make sure we don't get a situation where nothing is to be executed
     if (statement == Py_None && !cursor->statement) {
@@ -873,7 +1127,7 @@ static int cxoCursor_internalPrepare(cxoCursor *cursor, PyObject *statement,
     cursor->statementTag = statementTag;
 
     // clear fetch and bind variables if applicable
-    Py_CLEAR(cursor->fetchVariables);
+    cxoCursor_clearFetchVariables(cursor);
     if (!cursor->setInputSizes)
         Py_CLEAR(cursor->bindVariables);
 
@@ -886,6 +1140,9 @@ static int cxoCursor_internalPrepare(cxoCursor *cursor, PyObject *statement,
         cxoBuffer_clear(&statementBuffer);
         return -1;
     }
+    isTimed = cxoCursor_isTimed(cursor);
+    if (isTimed)
+        startTime = cxoUtils_getMonotonicTime();
     Py_BEGIN_ALLOW_THREADS
     if (cursor->handle)
         dpiStmt_release(cursor->handle);
@@ -897,7 +1154,11 @@ static int cxoCursor_internalPrepare(cxoCursor *cursor, PyObject *statement,
     cxoBuffer_clear(&statementBuffer);
     cxoBuffer_clear(&tagBuffer);
     if (status < 0)
-        return cxoError_raiseAndReturnInt();
+        cxoError_raiseAndReturnInt();
+    if (isTimed)
+        cxoCursor_recordWait(cursor, CXO_TRACE_OP_PREPARE, startTime, 0, 0);
+    if (status < 0)
+        return -1;
 
     // get statement information
     if (dpiStmt_getInfo(cursor->handle, &cursor->stmtInfo) < 0)
@@ -930,8 +1191,9 @@ static int cxoCursor_internalPrepare(cxoCursor *cursor, PyObject *statement,
 static PyObject *cxoCursor_parse(cxoCursor *cursor, PyObject *statement)
 {
     uint32_t mode, numQueryColumns;
+    uint64_t startTime = 0;
+    int status, isTimed;
     dpiStmtInfo stmtInfo;
-    int status;
 
     // make sure the cursor is open
     if (cxoCursor_isOpen(cursor) < 0)
@@ -947,11 +1209,18 @@ static PyObject *cxoCursor_parse(cxoCursor *cursor, PyObject *statement)
     if (stmtInfo.isQuery)
         mode = DPI_MODE_EXEC_DESCRIBE_ONLY;
     else mode = DPI_MODE_EXEC_PARSE_ONLY;
+    isTimed = cxoCursor_isTimed(cursor);
+    if (isTimed)
+        startTime = cxoUtils_getMonotonicTime();
     Py_BEGIN_ALLOW_THREADS
     status = dpiStmt_execute(cursor->handle, mode, &numQueryColumns);
     Py_END_ALLOW_THREADS
     if (status < 0)
-        return cxoError_raiseAndReturnNull();
+        cxoError_raiseAndReturnNull();
+    if (isTimed)
+        cxoCursor_recordWait(cursor, CXO_TRACE_OP_PARSE, startTime, 0, 0);
+    if (status < 0)
+        return NULL;
 
     Py_RETURN_NONE;
 }
@@ -1309,7 +1578,8 @@ static PyObject *cxoCursor_execute(cxoCursor *cursor, PyObject *args,
 {
     PyObject *statement, *executeArgs;
     uint32_t numQueryColumns, mode;
-    int status;
+    uint64_t startTime = 0;
+    int status, isTimed;
 
     executeArgs = NULL;
     if (!PyArg_ParseTuple(args, "O|O", &statement, &executeArgs))
@@ -1346,17 +1616,25 @@ static PyObject *cxoCursor_execute(cxoCursor *cursor, PyObject *args,
         return NULL;
 
     // execute the statement
+    isTimed = cxoCursor_isTimed(cursor);
+    if (isTimed)
+        startTime = cxoUtils_getMonotonicTime();
     Py_BEGIN_ALLOW_THREADS
     mode = (cursor->connection->autocommit) ? DPI_MODE_EXEC_COMMIT_ON_SUCCESS :
             DPI_MODE_EXEC_DEFAULT;
     status = dpiStmt_execute(cursor->handle, mode, &numQueryColumns);
     Py_END_ALLOW_THREADS
-    if (status < 0)
-        return cxoError_raiseAndReturnNull();
 
     // get the count of the rows affected
-    if (dpiStmt_getRowCount(cursor->handle, &cursor->rowCount) < 0)
-        return cxoError_raiseAndReturnNull();
+    if (status == 0)
+        status = dpiStmt_getRowCount(cursor->handle, &cursor->rowCount);
+    if (status < 0)
+        cxoError_raiseAndReturnNull();
+    if (isTimed)
+        cxoCursor_recordWait(cursor, CXO_TRACE_OP_EXECUTE, startTime, 0,
+                (status < 0) ? 0 : cursor->rowCount);
+    if (status < 0)
+        return NULL;
 
     // for queries, return the cursor for convenience
     if (numQueryColumns > 0) {
@@ -1373,6 +1651,86 @@ static PyObject *cxoCursor_execute(cxoCursor *cursor, PyObject *args,
 }
 
 
+//-----------------------------------------------------------------------------
+// cxoCursor_convertLobBindVariable()
+//   Create a variable that binds long string or long raw data in place of
+// the given CLOB or BLOB variable, if the variable is eligible. Only
+// variables that have not had a value set and are not referenced outside of
+// the cursor (such as those created by setinputsizes()) are replaced.
+//-----------------------------------------------------------------------------
+static int cxoCursor_convertLobBindVariable(cxoCursor *cursor,
+        PyObject *varObj, cxoVar **newVar)
+{
+    cxoTransformNum transformNum;
+    cxoVar *var = (cxoVar*) varObj;
+
+    *newVar = NULL;
+    if (varObj == Py_None || Py_REFCNT(varObj) != 1 || var->isArray ||
+            var->isValueSet)
+        return 0;
+    if (var->transformNum == CXO_TRANSFORM_CLOB)
+        transformNum = CXO_TRANSFORM_LONG_STRING;
+    else if (var->transformNum == CXO_TRANSFORM_BLOB)
+        transformNum = CXO_TRANSFORM_LONG_BINARY;
+    else return 0;
+    *newVar = cxoVar_new(cursor, var->allocatedElements, transformNum, 0, 0,
+            NULL);
+    if (!*newVar)
+        return -1;
+    Py_XINCREF(var->inConverter);
+    (*newVar)->inConverter = var->inConverter;
+    Py_XINCREF(var->outConverter);
+    (*newVar)->outConverter = var->outConverter;
+    return 0;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoCursor_convertLobBindVariables()
+//   When bulk LOB binds are enabled and the statement is DML, replace the
+// CLOB and BLOB bind variables with variables that bind the data as long
+// string or long raw data. The database writes the data into the LOB columns
+// directly so that the entire array is sent in a single round trip instead
+// of a temporary LOB being created and written for each row.
+//-----------------------------------------------------------------------------
+static int cxoCursor_convertLobBindVariables(cxoCursor *cursor)
+{
+    PyObject *key, *varObj;
+    Py_ssize_t pos, i;
+    cxoVar *newVar;
+
+    if (!cursor->bulkLobBinds || !cursor->bindVariables ||
+            !cursor->stmtInfo.isDML || cursor->stmtInfo.isReturning)
+        return 0;
+    if (PyList_Check(cursor->bindVariables)) {
+        for (i = 0; i < PyList_GET_SIZE(cursor->bindVariables); i++) {
+            varObj = PyList_GET_ITEM(cursor->bindVariables, i);
+            if (cxoCursor_convertLobBindVariable(cursor, varObj, &newVar) < 0)
+                return -1;
+            if (newVar && PyList_SetItem(cursor->bindVariables, i,
+                    (PyObject*) newVar) < 0)
+                return -1;
+        }
+    } else {
+        pos = 0;
+        while (PyDict_Next(cursor->bindVariables, &pos, &key, &varObj)) {
+            if (cxoCursor_convertLobBindVariable(cursor, varObj, &newVar) < 0)
+                return -1;
+            if (newVar) {
+                if (PyDict_SetItem(cursor->bindVariables, key,
+                        (PyObject*) newVar) < 0) {
+                    Py_DECREF(newVar);
+                    return -1;
+                }
+                Py_DECREF(newVar);
+            }
+        }
+    }
+
+    return 0;
+}
+
+
 //-----------------------------------------------------------------------------
 // cxoCursor_executeMany()
 //   Execute the statement many times. The number of times is equivalent to the
@@ -1387,7 +1745,8 @@ static PyObject *cxoCursor_executeMany(cxoCursor *cursor, PyObject *args,
     int arrayDMLRowCountsEnabled = 0, batchErrorsEnabled = 0;
     PyObject *arguments, *parameters, *statement;
     uint32_t mode, i, numRows;
-    int status;
+    uint64_t startTime = 0;
+    int status, isTimed;
 
     // validate parameters
     if (!PyArg_ParseTupleAndKeywords(args, keywordArgs, "OO|ii", keywordList,
@@ -1417,6 +1776,8 @@ static PyObject *cxoCursor_executeMany(cxoCursor *cursor, PyObject *args,
     // prepare the statement
     if (cxoCursor_internalPrepare(cursor, statement, NULL) < 0)
         return NULL;
+    if (cxoCursor_convertLobBindVariables(cursor) < 0)
+        return NULL;
 
     // perform binds, as required
     if (PyLong_Check(parameters))
@@ -1439,14 +1800,21 @@ static PyObject *cxoCursor_executeMany(cxoCursor *cursor, PyObject *args,
     // execute the statement, but only if the number of rows is greater than
     // zero since Oracle raises an error otherwise
     if (numRows > 0) {
+        isTimed = cxoCursor_isTimed(cursor);
+        if (isTimed)
+            startTime = cxoUtils_getMonotonicTime();
         Py_BEGIN_ALLOW_THREADS
         status = dpiStmt_executeMany(cursor->handle, mode, numRows);
         Py_END_ALLOW_THREADS
         if (status < 0) {
             cxoError_raiseAndReturnNull();
             dpiStmt_getRowCount(cursor->handle, &cursor->rowCount);
-            return NULL;
         }
+        if (isTimed)
+            cxoCursor_recordWait(cursor, CXO_TRACE_OP_EXECUTE_MANY,
+                    startTime, 0, (status < 0) ? 0 : numRows);
+        if (status < 0)
+            return NULL;
         if (dpiStmt_getRowCount(cursor->handle, &cursor->rowCount) < 0)
             return cxoError_raiseAndReturnNull();
     }
@@ -1464,7 +1832,8 @@ static PyObject *cxoCursor_executeMany(cxoCursor *cursor, PyObject *args,
 static PyObject *cxoCursor_executeManyPrepared(cxoCursor *cursor,
         PyObject *args)
 {
-    int numIters, status;
+    int numIters, status, isTimed;
+    uint64_t startTime = 0;
 
     // expect number of times to execute the statement
     if (!PyArg_ParseTuple(args, "i", &numIters))
@@ -1479,13 +1848,22 @@ static PyObject *cxoCursor_executeManyPrepared(cxoCursor *cursor,
         return NULL;
 
     // execute the statement
+    isTimed = cxoCursor_isTimed(cursor);
+    if (isTimed)
+        startTime = cxoUtils_getMonotonicTime();
     Py_BEGIN_ALLOW_THREADS
     status = dpiStmt_executeMany(cursor->handle, DPI_MODE_EXEC_DEFAULT,
             numIters);
     Py_END_ALLOW_THREADS
-    if (status < 0 || dpiStmt_getRowCount(cursor->handle,
-            &cursor->rowCount) < 0)
-        return cxoError_raiseAndReturnNull();
+    if (status == 0)
+        status = dpiStmt_getRowCount(cursor->handle, &cursor->rowCount);
+    if (status < 0)
+        cxoError_raiseAndReturnNull();
+    if (isTimed)
+        cxoCursor_recordWait(cursor, CXO_TRACE_OP_EXECUTE_MANY, startTime,
+                0, (status < 0) ? 0 : (uint64_t) numIters);
+    if (status < 0)
+        return NULL;
 
     Py_RETURN_NONE;
 }
@@ -1595,7 +1973,8 @@ static PyObject *cxoCursor_fetchRaw(cxoCursor *cursor, PyObject *args,
 {
     static char *keywordList[] = { "numRows", NULL };
     uint32_t numRowsToFetch, numRowsFetched, bufferRowIndex;
-    int moreRows;
+    int moreRows, status, isTimed;
+    uint64_t startTime = 0;
 
     // expect an optional number of rows to retrieve
     numRowsToFetch = cursor->fetchArraySize;
@@ -1607,15 +1986,250 @@ static PyObject *cxoCursor_fetchRaw(cxoCursor *cursor, PyObject *args,
                 "rows to fetch exceeds array size");
 
     // perform the fetch
-    if (dpiStmt_fetchRows(cursor->handle, numRowsToFetch, &bufferRowIndex,
-            &numRowsFetched, &moreRows) < 0)
-        return cxoError_raiseAndReturnNull();
+    isTimed = cxoCursor_isTimed(cursor);
+    if (isTimed)
+        startTime = cxoUtils_getMonotonicTime();
+    status = dpiStmt_fetchRows(cursor->handle, numRowsToFetch,
+            &bufferRowIndex, &numRowsFetched, &moreRows);
+    if (status < 0)
+        cxoError_raiseAndReturnNull();
+    if (isTimed)
+        cxoCursor_recordWait(cursor, CXO_TRACE_OP_FETCH, startTime, 1,
+                (status < 0) ? 0 : numRowsFetched);
+    if (status < 0)
+        return NULL;
     cursor->rowCount += numRowsFetched;
     cursor->numRowsInFetchBuffer = 0;
     return PyLong_FromLong(numRowsFetched);
 }
 
 
+//-----------------------------------------------------------------------------
+// cxoCursor_getFetchMode()
+//   Return the fetch mode corresponding to the string, or the default mode if
+// no string was specified.
+//-----------------------------------------------------------------------------
+static int cxoCursor_getFetchMode(const char *strMode,
+        dpiFetchMode defaultMode, dpiFetchMode *mode)
+{
+    if (!strMode)
+        *mode = defaultMode;
+    else if (strcmp(strMode, "relative") == 0)
+        *mode = DPI_MODE_FETCH_RELATIVE;
+    else if (strcmp(strMode, "absolute") == 0)
+        *mode = DPI_MODE_FETCH_ABSOLUTE;
+    else if (strcmp(strMode, "first") == 0)
+        *mode = DPI_MODE_FETCH_FIRST;
+    else if (strcmp(strMode, "last") == 0)
+        *mode = DPI_MODE_FETCH_LAST;
+    else {
+        cxoError_raiseFromString(cxoInterfaceErrorException,
+                "mode must be one of relative, absolute, first or last");
+        return -1;
+    }
+
+    return 0;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoCursor_internalScroll()
+//   Scroll the cursor using the offset and mode specified and fill the fetch
+// buffer with the rows found at the new position.
+//-----------------------------------------------------------------------------
+static int cxoCursor_internalScroll(cxoCursor *cursor, dpiFetchMode mode,
+        int32_t offset)
+{
+    int status, isTimed;
+    uint64_t startTime = 0;
+
+    // perform scroll and get new row count and number of rows in buffer
+    isTimed = cxoCursor_isTimed(cursor);
+    if (isTimed)
+        startTime = cxoUtils_getMonotonicTime();
+    Py_BEGIN_ALLOW_THREADS
+    status = dpiStmt_scroll(cursor->handle, mode, offset,
+            0 - cursor->numRowsInFetchBuffer);
+    if (status == 0)
+        status = dpiStmt_fetchRows(cursor->handle, cursor->fetchArraySize,
+                &cursor->fetchBufferRowIndex, &cursor->numRowsInFetchBuffer,
+                &cursor->moreRowsToFetch);
+    if (status == 0)
+        status = dpiStmt_getRowCount(cursor->handle, &cursor->rowCount);
+    Py_END_ALLOW_THREADS
+    if (status < 0)
+        cxoError_raiseAndReturnInt();
+    if (isTimed)
+        cxoCursor_recordWait(cursor, CXO_TRACE_OP_FETCH, startTime, 1,
+                (status < 0) ? 0 : cursor->numRowsInFetchBuffer);
+    if (status < 0)
+        return -1;
+    cursor->rowCount -= cursor->numRowsInFetchBuffer;
+
+    return 0;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoCursor_getCachedWindow()
+//   Return a list containing the rows in the window cache starting at the
+// given (1-based) row number. If any of the rows are not found in the cache,
+// the list is not created and the results are set to NULL instead.
+//-----------------------------------------------------------------------------
+static int cxoCursor_getCachedWindow(cxoCursor *cursor, uint64_t firstRowNum,
+        uint32_t numRows, PyObject **results)
+{
+    PyObject *key, *tuple, *row;
+    uint32_t i;
+
+    *results = NULL;
+    if (!cursor->windowCache ||
+            (uint64_t) PyDict_Size(cursor->windowCache) < numRows)
+        return 0;
+    *results = PyList_New(numRows);
+    if (!*results)
+        return -1;
+    for (i = 0; i < numRows; i++) {
+        key = PyLong_FromUnsignedLongLong(firstRowNum + i);
+        if (!key) {
+            Py_CLEAR(*results);
+            return -1;
+        }
+        tuple = PyDict_GetItem(cursor->windowCache, key);
+        Py_DECREF(key);
+        if (!tuple) {
+            Py_CLEAR(*results);
+            return 0;
+        }
+        row = cxoCursor_applyRowFactory(cursor, tuple);
+        if (!row) {
+            Py_CLEAR(*results);
+            return -1;
+        }
+        PyList_SET_ITEM(*results, i, row);
+    }
+
+    return 0;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoCursor_cacheWindowRow()
+//   Add the row to the window cache. If the cache is full it is emptied first
+// in order to bound the amount of memory retained by the cursor.
+//-----------------------------------------------------------------------------
+static int cxoCursor_cacheWindowRow(cxoCursor *cursor, uint64_t rowNum,
+        PyObject *tuple)
+{
+    PyObject *key;
+    int status;
+
+    if (cursor->windowCacheSize == 0)
+        return 0;
+    if (!cursor->windowCache) {
+        cursor->windowCache = PyDict_New();
+        if (!cursor->windowCache)
+            return -1;
+    } else if ((uint64_t) PyDict_Size(cursor->windowCache) >=
+            cursor->windowCacheSize) {
+        PyDict_Clear(cursor->windowCache);
+    }
+    key = PyLong_FromUnsignedLongLong(rowNum);
+    if (!key)
+        return -1;
+    status = PyDict_SetItem(cursor->windowCache, key, tuple);
+    Py_DECREF(key);
+    return status;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoCursor_fetchWindow()
+//   Scroll the cursor using the offset and mode specified and return a list
+// containing up to the requested number of rows found at that position. The
+// scroll and the fetch of the first array of rows take a single round trip.
+// The rows are retained in a cache so that windows requested with an absolute
+// position which overlap windows already fetched are returned without any
+// round trips at all; in that case the position of the cursor is unchanged.
+//-----------------------------------------------------------------------------
+static PyObject *cxoCursor_fetchWindow(cxoCursor *cursor, PyObject *args,
+        PyObject *keywordArgs)
+{
+    static char *keywordList[] = { "offset", "count", "mode", NULL };
+    PyObject *results, *tuple, *row;
+    uint32_t bufferRowIndex = 0;
+    uint32_t count, rowNum;
+    dpiFetchMode mode;
+    int32_t offset;
+    char *strMode;
+    int found;
+
+    // parse arguments
+    strMode = NULL;
+    if (!PyArg_ParseTupleAndKeywords(args, keywordArgs, "iI|s", keywordList,
+            &offset, &count, &strMode))
+        return NULL;
+    if (cxoCursor_getFetchMode(strMode, DPI_MODE_FETCH_ABSOLUTE, &mode) < 0)
+        return NULL;
+
+    // verify fetch can be performed
+    if (cxoCursor_verifyFetch(cursor) < 0)
+        return NULL;
+
+    // return the rows from the cache, if possible
+    if (mode == DPI_MODE_FETCH_FIRST ||
+            (mode == DPI_MODE_FETCH_ABSOLUTE && offset > 0)) {
+        if (cxoCursor_getCachedWindow(cursor,
+                (mode == DPI_MODE_FETCH_FIRST) ? 1 : (uint64_t) offset,
+                count, &results) < 0)
+            return NULL;
+        if (results)
+            return results;
+    }
+
+    // scroll to the requested position
+    if (cxoCursor_internalScroll(cursor, mode, offset) < 0)
+        return NULL;
+
+    // fetch the rows, adding them to the cache
+    results = PyList_New(0);
+    if (!results)
+        return NULL;
+    for (rowNum = 0; rowNum < count; rowNum++) {
+        if (cxoCursor_fetchRow(cursor, &found, &bufferRowIndex) < 0) {
+            Py_DECREF(results);
+            return NULL;
+        }
+        if (!found)
+            break;
+        tuple = cxoCursor_createRowTuple(cursor, bufferRowIndex);
+        if (!tuple) {
+            Py_DECREF(results);
+            return NULL;
+        }
+        if (cxoCursor_cacheWindowRow(cursor, cursor->rowCount, tuple) < 0) {
+            Py_DECREF(tuple);
+            Py_DECREF(results);
+            return NULL;
+        }
+        row = cxoCursor_applyRowFactory(cursor, tuple);
+        Py_DECREF(tuple);
+        if (!row) {
+            Py_DECREF(results);
+            return NULL;
+        }
+        if (PyList_Append(results, row) < 0) {
+            Py_DECREF(row);
+            Py_DECREF(results);
+            return NULL;
+        }
+        Py_DECREF(row);
+    }
+
+    return results;
+}
+
+
 //-----------------------------------------------------------------------------
 // cxoCursor_scroll()
 //   Scroll the cursor using the value and mode specified.
@@ -1627,7 +2241,6 @@ static PyObject *cxoCursor_scroll(cxoCursor *cursor, PyObject *args,
     dpiFetchMode mode;
     int32_t offset;
     char *strMode;
-    int status;
 
     // parse arguments
     offset = 0;
@@ -1637,37 +2250,16 @@ static PyObject *cxoCursor_scroll(cxoCursor *cursor, PyObject *args,
         return NULL;
 
     // validate mode
-    if (!strMode)
-        mode = DPI_MODE_FETCH_RELATIVE;
-    else if (strcmp(strMode, "relative") == 0)
-        mode = DPI_MODE_FETCH_RELATIVE;
-    else if (strcmp(strMode, "absolute") == 0)
-        mode = DPI_MODE_FETCH_ABSOLUTE;
-    else if (strcmp(strMode, "first") == 0)
-        mode = DPI_MODE_FETCH_FIRST;
-    else if (strcmp(strMode, "last") == 0)
-        mode = DPI_MODE_FETCH_LAST;
-    else return cxoError_raiseFromString(cxoInterfaceErrorException,
-            "mode must be one of relative, absolute, first or last");
+    if (cxoCursor_getFetchMode(strMode, DPI_MODE_FETCH_RELATIVE, &mode) < 0)
+        return NULL;
 
     // make sure the cursor is open
     if (cxoCursor_isOpen(cursor) < 0)
         return NULL;
 
-    // perform scroll and get new row count and number of rows in buffer
-    Py_BEGIN_ALLOW_THREADS
-    status = dpiStmt_scroll(cursor->handle, mode, offset,
-            0 - cursor->numRowsInFetchBuffer);
-    if (status == 0)
-        status = dpiStmt_fetchRows(cursor->handle, cursor->fetchArraySize,
-                &cursor->fetchBufferRowIndex, &cursor->numRowsInFetchBuffer,
-                &cursor->moreRowsToFetch);
-    if (status == 0)
-        status = dpiStmt_getRowCount(cursor->handle, &cursor->rowCount);
-    Py_END_ALLOW_THREADS
-    if (status < 0)
-        return cxoError_raiseAndReturnNull();
-    cursor->rowCount -= cursor->numRowsInFetchBuffer;
+    // perform scroll
+    if (cxoCursor_internalScroll(cursor, mode, offset) < 0)
+        return NULL;
 
     Py_RETURN_NONE;
 }
@@ -2189,6 +2781,33 @@ static PyObject *cxoCursor_contextManagerExit(cxoCursor *cursor,
 }
 
 
+//-----------------------------------------------------------------------------
+// cxoCursor_setInlineLobSize()
+//   Set the size at or below which LOBs are fetched as strings or bytes
+// instead of as LOB locators. The data for LOBs of this size is prefetched
+// along with the locators so that no additional round trips are required.
+// The value only affects queries whose columns have not yet been defined and
+// is applied to those columns only, not to the session as a whole.
+//-----------------------------------------------------------------------------
+static int cxoCursor_setInlineLobSize(cxoCursor *cursor, PyObject *value,
+        void *unused)
+{
+    unsigned long size;
+
+    if (cxoCursor_isOpen(cursor) < 0)
+        return -1;
+    size = PyLong_AsUnsignedLong(value);
+    if (PyErr_Occurred())
+        return -1;
+    if (size > UINT32_MAX) {
+        PyErr_SetString(PyExc_OverflowError, "inline LOB size too large");
+        return -1;
+    }
+    cursor->inlineLobSize = (uint32_t) size;
+    return 0;
+}
+
+
 //-----------------------------------------------------------------------------
 // cxoCursor_setPrefetchRows()
 //   Set the number of rows that are prefetched by the Oracle Client library.
@@ -2237,6 +2856,8 @@ static PyMethodDef cxoMethods[] = {
               METH_VARARGS },
     { "setoutputsize", (PyCFunction) cxoCursor_setOutputSize, METH_VARARGS },
     { "scroll", (PyCFunction) cxoCursor_scroll, METH_VARARGS | METH_KEYWORDS },
+    { "fetch_window", (PyCFunction) cxoCursor_fetchWindow,
+            METH_VARARGS | METH_KEYWORDS },
     { "var", (PyCFunction) cxoCursor_var, METH_VARARGS | METH_KEYWORDS },
     { "arrayvar", (PyCFunction) cxoCursor_arrayVar, METH_VARARGS },
     { "bindnames", (PyCFunction) cxoCursor_bindNames, METH_NOARGS },
@@ -2266,6 +2887,8 @@ static PyMemberDef cxoMembers[] = {
     { "statement", T_OBJECT, offsetof(cxoCursor, statement), READONLY },
     { "connection", T_OBJECT_EX, offsetof(cxoCursor, connection), READONLY },
     { "rowfactory", T_OBJECT, offsetof(cxoCursor, rowFactory), 0 },
+    { "fetch_lobs", T_BOOL, offsetof(cxoCursor, fetchLobs), 0 },
+    { "bulk_lob_binds", T_BOOL, offsetof(cxoCursor, bulkLobBinds), 0 },
     { "bindvars", T_OBJECT, offsetof(cxoCursor, bindVariables), READONLY },
     { "fetchvars", T_OBJECT, offsetof(cxoCursor, fetchVariables), READONLY },
     { "inputtypehandler", T_OBJECT, offsetof(cxoCursor, inputTypeHandler),
@@ -2273,6 +2896,8 @@ static PyMemberDef cxoMembers[] = {
     { "outputtypehandler", T_OBJECT, offsetof(cxoCursor, outputTypeHandler),
             0 },
     { "scrollable", T_BOOL, offsetof(cxoCursor, isScrollable), 0 },
+    { "stats_enabled", T_BOOL, offsetof(cxoCursor, statsEnabled), 0 },
+    { "window_cache_size", T_UINT, offsetof(cxoCursor, windowCacheSize), 0 },
     { NULL }
 };
 
@@ -2282,9 +2907,12 @@ static PyMemberDef cxoMembers[] = {
 //-----------------------------------------------------------------------------
 static PyGetSetDef cxoCalcMembers[] = {
     { "description", (getter) cxoCursor_getDescription, 0, 0, 0 },
+    { "inline_lob_size", (getter) cxoCursor_getInlineLobSize,
+            (setter) cxoCursor_setInlineLobSize, 0, 0 },
     { "lastrowid", (getter) cxoCursor_getLastRowid, 0, 0, 0 },
     { "prefetchrows", (getter) cxoCursor_getPrefetchRows,
             (setter) cxoCursor_setPrefetchRows, 0, 0 },
+    { "stats", (getter) cxoCursor_getStats, 0, 0, 0 },
     { NULL }
 };
 
@@ -14,6 +14,53 @@
 
 #include "cxoModule.h"
 
+//-----------------------------------------------------------------------------
+// cxoError_copyString()
+//   Copy the null terminated string into the buffer, truncating it if
+// necessary, and return the copy. NULL is returned unchanged.
+//-----------------------------------------------------------------------------
+static const char *cxoError_copyString(char *buffer, size_t bufferSize,
+        const char *value)
+{
+    size_t length;
+
+    if (!value)
+        return NULL;
+    length = strlen(value);
+    if (length >= bufferSize)
+        length = bufferSize - 1;
+    memcpy(buffer, value, length);
+    buffer[length] = '\0';
+    return buffer;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoError_captureInfo()
+//   Capture the last DPI error raised on the calling thread into the buffer.
+// The strings referenced by the error information belong to the calling
+// thread and are copied so that the error can be raised later on another
+// thread. This may be called without the GIL held.
+//-----------------------------------------------------------------------------
+void cxoError_captureInfo(cxoErrorBuffer *buffer)
+{
+    dpiErrorInfo *info = &buffer->info;
+
+    dpiContext_getError(cxoDpiContext, info);
+    if (info->messageLength >= sizeof(buffer->message))
+        info->messageLength = sizeof(buffer->message) - 1;
+    memcpy(buffer->message, info->message, info->messageLength);
+    buffer->message[info->messageLength] = '\0';
+    info->message = buffer->message;
+    info->encoding = cxoError_copyString(buffer->encoding,
+            sizeof(buffer->encoding), info->encoding);
+    info->fnName = cxoError_copyString(buffer->fnName,
+            sizeof(buffer->fnName), info->fnName);
+    info->action = cxoError_copyString(buffer->action,
+            sizeof(buffer->action), info->action);
+}
+
+
 //-----------------------------------------------------------------------------
 // cxoError_free()
 //   Deallocate the error.
@@ -14,6 +14,102 @@
 
 #include "cxoModule.h"
 
+// maximum number of bytes written to a LOB by a single call when writing
+// from an object supporting the buffer protocol
+#define CXO_LOB_MAX_WRITE_SIZE          (64 * 1024 * 1024)
+
+// chunk size assumed for LOBs that do not report one (BFILEs)
+#define CXO_LOB_DEFAULT_CHUNK_SIZE      8192
+
+// size of the buffer used when transferring data between a LOB and a file
+// (before being rounded up to a multiple of the chunk size) and the default
+// number of bytes transferred between calls to the progress callback
+#define CXO_LOB_TRANSFER_SIZE           (1024 * 1024)
+#define CXO_LOB_PROGRESS_INTERVAL       (1024 * 1024)
+
+// default number of streams used for parallel transfers
+#define CXO_LOB_DEFAULT_NUM_STREAMS     4
+
+//-----------------------------------------------------------------------------
+// structure used for transferring data between a LOB and a file
+//-----------------------------------------------------------------------------
+typedef struct {
+    cxoLob *lob;
+    PyObject *progress;
+    uint64_t progressInterval;
+    uint64_t nextProgress;
+    uint64_t amount;
+    uint64_t bufferSize;
+    uint64_t numBytes;
+    uint64_t numFileBytes;
+    uint64_t numPendingBytes;
+    char *buffer;
+    int fd;
+    int closeFd;
+    int64_t position;
+    int resourceOpened;
+    int fileErrorNum;
+    int dpiFailed;
+    dpiErrorInfo errorInfo;
+    PyObject *codec;
+    const char *codecMethod;
+    PyObject *digest;
+    int toFile;
+    int computeCrc32c;
+    uint32_t crc32c;
+} cxoLobTransfer;
+
+//-----------------------------------------------------------------------------
+// structure used for each stream of a parallel transfer; each stream
+// transfers a contiguous range of the LOB on its own native thread
+//-----------------------------------------------------------------------------
+typedef struct {
+    dpiLob *handle;
+    cxoThread thread;
+    int started;
+    int toLob;
+    uint64_t offset;
+    uint64_t amount;
+    uint64_t pieceSize;
+    uint64_t numBytes;
+    char *data;
+    char *buffer;
+    int fd;
+    int64_t filePosition;
+    int fileErrorNum;
+    int dpiFailed;
+    cxoErrorBuffer error;
+} cxoLobStream;
+
+//-----------------------------------------------------------------------------
+// structure used for each BFILE read by cxoLob_readFiles(); the contents are
+// either retained in the buffer or written to the file with the given path;
+// each BFILE is read by the worker with the given number
+//-----------------------------------------------------------------------------
+typedef struct {
+    dpiLob *handle;
+    cxoConnection *connection;
+    uint32_t workerNum;
+    void *path;
+    char *buffer;
+    uint64_t numBytes;
+    int fileErrorNum;
+    int dpiFailed;
+    cxoErrorBuffer error;
+} cxoLobFile;
+
+//-----------------------------------------------------------------------------
+// structure used for each native thread started by cxoLob_readFiles(); each
+// thread reads the BFILEs assigned to it
+//-----------------------------------------------------------------------------
+typedef struct {
+    cxoThread thread;
+    int started;
+    cxoLobFile *files;
+    uint32_t numFiles;
+    uint32_t workerNum;
+} cxoLobFileWorker;
+
 //-----------------------------------------------------------------------------
 // cxoLob_new()
 //   Create a new LOB.
@@ -51,6 +147,106 @@ static void cxoLob_free(cxoLob *lob)
 }
 
 
+//-----------------------------------------------------------------------------
+// cxoLob_getTransferChunkSize()
+//   Return the chunk size of the LOB for use in sizing transfers. BFILEs do
+// not have a chunk size so a default value is used for them instead.
+//-----------------------------------------------------------------------------
+static int cxoLob_getTransferChunkSize(cxoLob *lob, uint32_t *chunkSize)
+{
+    *chunkSize = 0;
+    if (lob->dbType != cxoDbTypeBfile &&
+            dpiLob_getChunkSize(lob->handle, chunkSize) < 0)
+        return cxoError_raiseAndReturnInt();
+    if (*chunkSize == 0)
+        *chunkSize = CXO_LOB_DEFAULT_CHUNK_SIZE;
+    return 0;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoLob_readIntoBuffer()
+//   Read a portion of the data in the LOB into the supplied buffer, which is
+// expected to be at least of the size returned by dpiLob_getBufferSize() for
+// the amount requested. The buffer size is replaced with the number of bytes
+// actually read.
+//-----------------------------------------------------------------------------
+static int cxoLob_readIntoBuffer(cxoLob *lob, uint64_t offset,
+        uint64_t amount, char *buffer, uint64_t *bufferSize)
+{
+    uint64_t startTime = 0;
+    int status, isTraced;
+
+    isTraced = cxoTrace_isEnabled();
+    if (isTraced)
+        startTime = cxoUtils_getMonotonicTime();
+    Py_BEGIN_ALLOW_THREADS
+    status = dpiLob_readBytes(lob->handle, offset, amount, buffer,
+            bufferSize);
+    Py_END_ALLOW_THREADS
+    if (status < 0)
+        cxoError_raiseAndReturnInt();
+    if (isTraced)
+        cxoTrace_record(CXO_TRACE_OP_LOB_READ, NULL, NULL, startTime,
+                (status < 0) ? 0 : *bufferSize);
+    return (status < 0) ? -1 : 0;
+    return 0;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoLob_readBytes()
+//   Read a portion of the data in a BLOB or BFILE directly into a new bytes
+// object, avoiding the need for an intermediate buffer.
+//-----------------------------------------------------------------------------
+static PyObject *cxoLob_readBytes(cxoLob *lob, uint64_t offset,
+        uint64_t amount)
+{
+    uint64_t bufferSize;
+    PyObject *result;
+
+    result = PyBytes_FromStringAndSize(NULL, (Py_ssize_t) amount);
+    if (!result)
+        return NULL;
+    bufferSize = amount;
+    if (cxoLob_readIntoBuffer(lob, offset, amount, PyBytes_AS_STRING(result),
+            &bufferSize) < 0) {
+        Py_DECREF(result);
+        return NULL;
+    }
+    if (bufferSize < amount &&
+            _PyBytes_Resize(&result, (Py_ssize_t) bufferSize) < 0)
+        return NULL;
+    return result;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoLob_decode()
+//   Decode the data read from a CLOB or NCLOB.
+//-----------------------------------------------------------------------------
+static PyObject *cxoLob_decode(cxoLob *lob, const char *buffer,
+        uint64_t bufferSize)
+{
+    const char *encoding;
+
+    if (lob->dbType == cxoDbTypeNclob)
+        encoding = lob->connection->encodingInfo.nencoding;
+    else encoding = lob->connection->encodingInfo.encoding;
+    return PyUnicode_Decode(buffer, (Py_ssize_t) bufferSize, encoding, NULL);
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoLob_isCharacterData()
+//   Return a boolean indicating if the LOB contains character data.
+//-----------------------------------------------------------------------------
+static int cxoLob_isCharacterData(cxoLob *lob)
+{
+    return (lob->dbType == cxoDbTypeClob || lob->dbType == cxoDbTypeNclob);
+}
+
+
 //-----------------------------------------------------------------------------
 // cxoLob_internalRead()
 //   Return a portion (or all) of the data in the LOB.
@@ -61,7 +257,6 @@ static PyObject *cxoLob_internalRead(cxoLob *lob, uint64_t offset,
     uint64_t bufferSize;
     PyObject *result;
     char *buffer;
-    int status;
 
     // modify the arguments
     if (amount == (uint64_t)(-1)) {
@@ -72,6 +267,10 @@ static PyObject *cxoLob_internalRead(cxoLob *lob, uint64_t offset,
         else amount = 1;
     }
 
+    // binary data is read directly into the bytes object that is returned
+    if (!cxoLob_isCharacterData(lob))
+        return cxoLob_readBytes(lob, offset, amount);
+
     // create a buffer of the correct size
     if (dpiLob_getBufferSize(lob->handle, amount, &bufferSize) < 0)
         return cxoError_raiseAndReturnNull();
@@ -79,58 +278,472 @@ static PyObject *cxoLob_internalRead(cxoLob *lob, uint64_t offset,
     if (!buffer)
         return PyErr_NoMemory();
 
-    // read the LOB
-    Py_BEGIN_ALLOW_THREADS
-    status = dpiLob_readBytes(lob->handle, offset, amount, buffer,
-            &bufferSize);
-    Py_END_ALLOW_THREADS
-    if (status < 0) {
+    // read the LOB and decode the result
+    if (cxoLob_readIntoBuffer(lob, offset, amount, buffer, &bufferSize) < 0) {
         PyMem_Free(buffer);
+        return NULL;
+    }
+    result = cxoLob_decode(lob, buffer, bufferSize);
+    PyMem_Free(buffer);
+    return result;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoLob_getInlineValue()
+//   Return the contents of the LOB as a string or bytes object if its size
+// does not exceed the given maximum; otherwise, the LOB itself is returned.
+// When the LOB data was prefetched along with the locator, no round trip to
+// the database is required.
+//-----------------------------------------------------------------------------
+PyObject *cxoLob_getInlineValue(cxoLob *lob, uint64_t maxSize)
+{
+    uint64_t size;
+
+    if (dpiLob_getSize(lob->handle, &size) < 0)
         return cxoError_raiseAndReturnNull();
+    if (size > maxSize) {
+        Py_INCREF(lob);
+        return (PyObject*) lob;
+    }
+    if (size == 0) {
+        if (cxoLob_isCharacterData(lob))
+            return PyUnicode_New(0, 0);
+        return PyBytes_FromStringAndSize(NULL, 0);
     }
+    return cxoLob_internalRead(lob, 1, size);
+}
 
-    // return the result
-    if (lob->dbType == cxoDbTypeNclob) {
-        result = PyUnicode_Decode(buffer, (Py_ssize_t) bufferSize,
-                lob->connection->encodingInfo.nencoding, NULL);
-    } else if (lob->dbType == cxoDbTypeClob) {
-        result = PyUnicode_Decode(buffer, (Py_ssize_t) bufferSize,
-                lob->connection->encodingInfo.encoding, NULL);
-    } else {
-        result = PyBytes_FromStringAndSize(buffer, (Py_ssize_t) bufferSize);
+
+//-----------------------------------------------------------------------------
+// cxoLob_writeFromView()
+//   Write the data exposed by an object supporting the buffer protocol to a
+// BLOB without copying it. The data is written in pieces that are multiples
+// of the chunk size of the LOB, with the first piece sized so that the
+// remaining pieces start on a chunk boundary.
+//-----------------------------------------------------------------------------
+static int cxoLob_writeFromView(cxoLob *lob, PyObject *dataObj,
+        uint64_t offset)
+{
+    uint64_t startTime = 0, remaining, pieceSize, maxPieceSize;
+    int status, isTraced;
+    uint32_t chunkSize;
+    Py_buffer view;
+    char *ptr;
+
+    // acquire the view of the data; it remains valid while the GIL is
+    // released since it is held until all of the data has been written
+    if (PyObject_GetBuffer(dataObj, &view, PyBUF_SIMPLE) < 0)
+        return -1;
+    if (cxoLob_getTransferChunkSize(lob, &chunkSize) < 0) {
+        PyBuffer_Release(&view);
+        return -1;
     }
-    PyMem_Free(buffer);
-    return result;
+    if (chunkSize > CXO_LOB_MAX_WRITE_SIZE)
+        chunkSize = CXO_LOB_MAX_WRITE_SIZE;
+    maxPieceSize = CXO_LOB_MAX_WRITE_SIZE - CXO_LOB_MAX_WRITE_SIZE % chunkSize;
+
+    // write the data
+    isTraced = cxoTrace_isEnabled();
+    if (isTraced)
+        startTime = cxoUtils_getMonotonicTime();
+    ptr = (char*) view.buf;
+    remaining = (uint64_t) view.len;
+    status = DPI_SUCCESS;
+    Py_BEGIN_ALLOW_THREADS
+    if (remaining == 0)
+        status = dpiLob_writeBytes(lob->handle, offset, ptr, 0);
+    while (remaining > 0 && status == DPI_SUCCESS) {
+        pieceSize = maxPieceSize - (offset - 1) % chunkSize;
+        if (pieceSize > remaining)
+            pieceSize = remaining;
+        status = dpiLob_writeBytes(lob->handle, offset, ptr, pieceSize);
+        offset += pieceSize;
+        ptr += pieceSize;
+        remaining -= pieceSize;
+    }
+    Py_END_ALLOW_THREADS
+    if (status < 0)
+        cxoError_raiseAndReturnInt();
+    if (isTraced)
+        cxoTrace_record(CXO_TRACE_OP_LOB_WRITE, NULL, NULL, startTime,
+                (status < 0) ? 0 : (uint64_t) view.len);
+    PyBuffer_Release(&view);
+    if (status < 0)
+        return -1;
+    return 0;
 }
 
 
 //-----------------------------------------------------------------------------
 // cxoLob_internalWrite()
-//   Write the data in the Python object to the LOB.
+//   Write the data in the Python object to the LOB. Binary data may be
+// supplied by any object supporting the buffer protocol.
 //-----------------------------------------------------------------------------
 static int cxoLob_internalWrite(cxoLob *lob, PyObject *dataObj,
         uint64_t offset)
 {
+    uint64_t startTime = 0;
+    int status, isTraced;
     const char *encoding;
     cxoBuffer buffer;
-    int status;
 
+    if (!cxoLob_isCharacterData(lob) && PyObject_CheckBuffer(dataObj))
+        return cxoLob_writeFromView(lob, dataObj, offset);
     if (lob->dbType == cxoDbTypeNclob)
         encoding = lob->connection->encodingInfo.nencoding;
     else encoding = lob->connection->encodingInfo.encoding;
     if (cxoBuffer_fromObject(&buffer, dataObj, encoding) < 0)
         return -1;
+    isTraced = cxoTrace_isEnabled();
+    if (isTraced)
+        startTime = cxoUtils_getMonotonicTime();
     Py_BEGIN_ALLOW_THREADS
     status = dpiLob_writeBytes(lob->handle, offset,
             (char*) buffer.ptr, buffer.size);
     Py_END_ALLOW_THREADS
+    if (status < 0)
+        cxoError_raiseAndReturnInt();
+    if (isTraced)
+        cxoTrace_record(CXO_TRACE_OP_LOB_WRITE, NULL, NULL, startTime,
+                (status < 0) ? 0 : buffer.size);
     cxoBuffer_clear(&buffer);
     if (status < 0)
+        return -1;
+    return 0;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoLobTransfer_init()
+//   Prepare for transferring data between a LOB and a file: the file is
+// opened, a buffer aligned to the chunk size of the LOB is allocated and the
+// LOB is opened, if requested. The codec, if specified, is an object with a
+// compress() or decompress() method (such as those returned by
+// zlib.compressobj() and zlib.decompressobj()) through which the data is
+// passed; the digest, if specified, is either the string "crc32c" or an
+// object with an update() method (such as those returned by hashlib) and is
+// computed over the data as it is stored in the LOB.
+//-----------------------------------------------------------------------------
+static int cxoLobTransfer_init(cxoLobTransfer *transfer, cxoLob *lob,
+        PyObject *fileObj, int forWriting, int openLob, PyObject *progress,
+        uint64_t progressInterval, PyObject *codec, const char *codecMethod,
+        PyObject *digest)
+{
+    uint32_t chunkSize;
+    int status;
+
+    // initialize the structure
+    memset(transfer, 0, sizeof(cxoLobTransfer));
+    transfer->lob = lob;
+    transfer->fd = -1;
+    transfer->toFile = forWriting;
+    if (progress && progress != Py_None) {
+        if (!PyCallable_Check(progress)) {
+            PyErr_SetString(PyExc_TypeError, "progress must be callable");
+            return -1;
+        }
+        transfer->progress = progress;
+    }
+
+    // validate the codec and digest, if specified
+    if (codec && codec != Py_None) {
+        if (!PyObject_HasAttrString(codec, codecMethod)) {
+            PyErr_Format(PyExc_TypeError, "codec must have a %s() method",
+                    codecMethod);
+            return -1;
+        }
+        transfer->codec = codec;
+        transfer->codecMethod = codecMethod;
+    }
+    if (digest && digest != Py_None) {
+        if (PyUnicode_Check(digest)) {
+            if (PyUnicode_CompareWithASCIIString(digest, "crc32c") != 0) {
+                PyErr_SetString(PyExc_ValueError,
+                        "digest must be \"crc32c\" or a hash object");
+                return -1;
+            }
+            transfer->computeCrc32c = 1;
+            transfer->crc32c = cxoUtils_crc32c(0, NULL, 0);
+        } else if (!PyObject_HasAttrString(digest, "update")) {
+            PyErr_SetString(PyExc_TypeError,
+                    "digest must have an update() method");
+            return -1;
+        } else transfer->digest = digest;
+    }
+    transfer->progressInterval = progressInterval;
+    transfer->nextProgress = progressInterval;
+
+    // determine the amount to transfer with each call and allocate a buffer
+    // large enough to hold it
+    if (cxoLob_getTransferChunkSize(lob, &chunkSize) < 0)
+        return -1;
+    transfer->amount = CXO_LOB_TRANSFER_SIZE;
+    if (transfer->amount % chunkSize != 0)
+        transfer->amount += chunkSize - transfer->amount % chunkSize;
+    transfer->bufferSize = transfer->amount;
+    if (cxoLob_isCharacterData(lob) && dpiLob_getBufferSize(lob->handle,
+            transfer->amount, &transfer->bufferSize) < 0)
         return cxoError_raiseAndReturnInt();
+    transfer->buffer = PyMem_Malloc((size_t) transfer->bufferSize);
+    if (!transfer->buffer) {
+        PyErr_NoMemory();
+        return -1;
+    }
+
+    // open the file; positioned access is used if the file supports it
+    if (cxoUtils_openFile(fileObj, forWriting, &transfer->fd,
+            &transfer->closeFd) < 0)
+        return -1;
+    transfer->position = cxoUtils_getFilePosition(transfer->fd);
+
+    // open the LOB, if requested
+    if (openLob) {
+        Py_BEGIN_ALLOW_THREADS
+        status = dpiLob_openResource(lob->handle);
+        Py_END_ALLOW_THREADS
+        if (status < 0)
+            return cxoError_raiseAndReturnInt();
+        transfer->resourceOpened = 1;
+    }
+
+    return 0;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoLobTransfer_filePosition()
+//   Return the position in the file at which the next read or write should
+// take place, or -1 if the file is accessed sequentially.
+//-----------------------------------------------------------------------------
+static int64_t cxoLobTransfer_filePosition(cxoLobTransfer *transfer)
+{
+    if (transfer->position < 0)
+        return -1;
+    return transfer->position + (int64_t) transfer->numFileBytes;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoLobTransfer_finalize()
+//   Release the resources used by the transfer and raise an exception for
+// any error that took place while the GIL was released. The number of bytes
+// transferred is returned (along with the digest, if one was requested), or
+// NULL if an exception was raised.
+//-----------------------------------------------------------------------------
+static PyObject *cxoLobTransfer_finalize(cxoLobTransfer *transfer,
+        int isError)
+{
+    PyObject *digest;
+
+    if (transfer->resourceOpened) {
+        Py_BEGIN_ALLOW_THREADS
+        dpiLob_closeResource(transfer->lob->handle);
+        Py_END_ALLOW_THREADS
+    }
+    if (transfer->fd >= 0) {
+        if (transfer->closeFd)
+            cxoUtils_closeFile(transfer->fd, transfer->closeFd);
+        else cxoUtils_setFilePosition(transfer->fd,
+                cxoLobTransfer_filePosition(transfer));
+    }
+    if (transfer->buffer)
+        PyMem_Free(transfer->buffer);
+    if (isError)
+        return NULL;
+    if (transfer->dpiFailed) {
+        cxoError_raiseFromInfo(&transfer->errorInfo);
+        return NULL;
+    }
+    if (transfer->fileErrorNum) {
+        errno = transfer->fileErrorNum;
+        return PyErr_SetFromErrno(PyExc_OSError);
+    }
+    if (transfer->computeCrc32c)
+        return Py_BuildValue("KI", (unsigned long long) transfer->numBytes,
+                transfer->crc32c);
+    if (transfer->digest) {
+        digest = PyObject_CallMethod(transfer->digest, "digest", NULL);
+        if (!digest)
+            return NULL;
+        return Py_BuildValue("KN", (unsigned long long) transfer->numBytes,
+                digest);
+    }
+    return PyLong_FromUnsignedLongLong(transfer->numBytes);
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoLobTransfer_isProgressDue()
+//   Return a boolean indicating if the progress callback should be called.
+// This is called without holding the GIL.
+//-----------------------------------------------------------------------------
+static int cxoLobTransfer_isProgressDue(cxoLobTransfer *transfer)
+{
+    return (transfer->progress && transfer->progressInterval > 0 &&
+            transfer->numBytes >= transfer->nextProgress);
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoLobTransfer_reportProgress()
+//   Call the progress callback with the number of bytes transferred so far,
+// if one was supplied.
+//-----------------------------------------------------------------------------
+static int cxoLobTransfer_reportProgress(cxoLobTransfer *transfer)
+{
+    PyObject *result;
+
+    if (!transfer->progress)
+        return 0;
+    while (transfer->progressInterval > 0 &&
+            transfer->nextProgress <= transfer->numBytes)
+        transfer->nextProgress += transfer->progressInterval;
+    result = PyObject_CallFunction(transfer->progress, "K",
+            (unsigned long long) transfer->numBytes);
+    if (!result)
+        return -1;
+    Py_DECREF(result);
+    return 0;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoLobTransfer_updateDigest()
+//   Update the digest, if one was requested, with the given data.
+//-----------------------------------------------------------------------------
+static int cxoLobTransfer_updateDigest(cxoLobTransfer *transfer,
+        PyObject *data)
+{
+    Py_buffer view;
+    PyObject *result;
+
+    if (transfer->computeCrc32c) {
+        if (PyObject_GetBuffer(data, &view, PyBUF_SIMPLE) < 0)
+            return -1;
+        transfer->crc32c = cxoUtils_crc32c(transfer->crc32c, view.buf,
+                (size_t) view.len);
+        PyBuffer_Release(&view);
+    } else if (transfer->digest) {
+        result = PyObject_CallMethod(transfer->digest, "update", "O", data);
+        if (!result)
+            return -1;
+        Py_DECREF(result);
+    }
     return 0;
 }
 
 
+//-----------------------------------------------------------------------------
+// cxoLobTransfer_processData()
+//   Pass the data through the digest and the codec and write the result to
+// the destination (the file when reading from the LOB and the LOB at the given
+// offset otherwise). When no data is given, the codec is flushed instead.
+// Errors writing to the destination are recorded in the transfer structure,
+// as is done when the GIL is released.
+//-----------------------------------------------------------------------------
+static int cxoLobTransfer_processData(cxoLobTransfer *transfer,
+        PyObject *input, uint64_t *lobOffset)
+{
+    PyObject *output;
+    Py_buffer view;
+
+    // data read from the LOB is digested before it is decoded
+    if (input && transfer->toFile &&
+            cxoLobTransfer_updateDigest(transfer, input) < 0)
+        return -1;
+
+    // pass the data through the codec, if one was specified
+    if (!transfer->codec) {
+        Py_INCREF(input);
+        output = input;
+    } else {
+        if (!input)
+            output = PyObject_CallMethod(transfer->codec, "flush", NULL);
+        else output = PyObject_CallMethod(transfer->codec,
+                transfer->codecMethod, "O", input);
+        if (!output)
+            return -1;
+    }
+
+    // data written to the LOB is digested after it is encoded
+    if (!transfer->toFile &&
+            cxoLobTransfer_updateDigest(transfer, output) < 0) {
+        Py_DECREF(output);
+        return -1;
+    }
+
+    // write the data to the destination
+    if (PyObject_GetBuffer(output, &view, PyBUF_SIMPLE) < 0) {
+        Py_DECREF(output);
+        return -1;
+    }
+    if (view.len > 0) {
+        Py_BEGIN_ALLOW_THREADS
+        if (!transfer->toFile) {
+            if (dpiLob_writeBytes(transfer->lob->handle, *lobOffset,
+                    view.buf, (uint64_t) view.len) < 0) {
+                dpiContext_getError(cxoDpiContext, &transfer->errorInfo);
+                transfer->dpiFailed = 1;
+            } else *lobOffset += (uint64_t) view.len;
+        } else if (cxoUtils_writeFile(transfer->fd, view.buf,
+                (size_t) view.len,
+                cxoLobTransfer_filePosition(transfer)) < 0) {
+            transfer->fileErrorNum = errno;
+        } else transfer->numFileBytes += (uint64_t) view.len;
+        Py_END_ALLOW_THREADS
+        if (!transfer->dpiFailed && !transfer->fileErrorNum)
+            transfer->numBytes += (uint64_t) view.len;
+    }
+    PyBuffer_Release(&view);
+    Py_DECREF(output);
+
+    return 0;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoLobTransfer_processChunk()
+//   Process the pending data in the transfer buffer or, when the final flag
+// is set, flush the codec. The data is passed to the codec and the digest as
+// a memoryview of the transfer buffer, which is released once they have been
+// called since the buffer is reused for the next chunk; releasing the view
+// fails if either of them retained a reference to it.
+//-----------------------------------------------------------------------------
+static int cxoLobTransfer_processChunk(cxoLobTransfer *transfer,
+        uint64_t *lobOffset, int isFinal)
+{
+    PyObject *input, *result, *excType, *excValue, *excTraceback;
+    int status;
+
+    // nothing needs to be done at the end unless the codec can be flushed
+    if (isFinal)
+        return (transfer->codec &&
+                PyObject_HasAttrString(transfer->codec, "flush")) ?
+                cxoLobTransfer_processData(transfer, NULL, lobOffset) : 0;
+
+    // process the pending data
+    input = PyMemoryView_FromMemory(transfer->buffer,
+            (Py_ssize_t) transfer->numPendingBytes, PyBUF_READ);
+    transfer->numPendingBytes = 0;
+    if (!input)
+        return -1;
+    status = cxoLobTransfer_processData(transfer, input, lobOffset);
+
+    // release the view, retaining any exception that was already raised
+    PyErr_Fetch(&excType, &excValue, &excTraceback);
+    result = PyObject_CallMethod(input, "release", NULL);
+    Py_DECREF(input);
+    if (!result)
+        status = -1;
+    else Py_DECREF(result);
+    if (excType)
+        PyErr_Restore(excType, excValue, excTraceback);
+
+    return status;
+}
+
+
 //-----------------------------------------------------------------------------
 // cxoLob_size()
 //   Return the size of the data in the LOB.
@@ -179,22 +792,1126 @@ static PyObject *cxoLob_close(cxoLob *lob, PyObject *args)
 }
 
 
-//-----------------------------------------------------------------------------
-// cxoLob_read()
-//   Return a portion (or all) of the data in the LOB.
-//-----------------------------------------------------------------------------
-static PyObject *cxoLob_read(cxoLob *lob, PyObject *args, PyObject *keywordArgs)
-{
-    static char *keywordList[] = { "offset", "amount", NULL };
-    unsigned PY_LONG_LONG offset, amount;
+//-----------------------------------------------------------------------------
+// cxoLob_read()
+//   Return a portion (or all) of the data in the LOB.
+//-----------------------------------------------------------------------------
+static PyObject *cxoLob_read(cxoLob *lob, PyObject *args, PyObject *keywordArgs)
+{
+    static char *keywordList[] = { "offset", "amount", NULL };
+    unsigned PY_LONG_LONG offset, amount;
+
+    // offset and amount are expected, both optional
+    offset = 1;
+    amount = (unsigned PY_LONG_LONG)(-1);
+    if (!PyArg_ParseTupleAndKeywords(args, keywordArgs, "|KK", keywordList,
+            &offset, &amount))
+        return NULL;
+    return cxoLob_internalRead(lob, (uint64_t) offset, (uint64_t) amount);
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoLob_readInto()
+//   Read data from a BLOB or BFILE directly into a writable object supporting
+// the buffer protocol, starting at the given offset. The number of bytes read
+// is returned; this is zero once the end of the LOB has been reached.
+//-----------------------------------------------------------------------------
+static PyObject *cxoLob_readInto(cxoLob *lob, PyObject *args,
+        PyObject *keywordArgs)
+{
+    static char *keywordList[] = { "buffer", "offset", NULL };
+    unsigned PY_LONG_LONG offset;
+    uint64_t size, bufferSize;
+    Py_buffer view;
+    int status;
+
+    // parse arguments
+    offset = 1;
+    if (!PyArg_ParseTupleAndKeywords(args, keywordArgs, "w*|K", keywordList,
+            &view, &offset))
+        return NULL;
+    if (cxoLob_isCharacterData(lob)) {
+        PyBuffer_Release(&view);
+        cxoError_raiseFromString(cxoProgrammingErrorException,
+                "readinto() is only supported for BLOB and BFILE");
+        return NULL;
+    }
+
+    // nothing is read if the offset is beyond the end of the LOB
+    if (dpiLob_getSize(lob->handle, &size) < 0) {
+        PyBuffer_Release(&view);
+        return cxoError_raiseAndReturnNull();
+    }
+    bufferSize = (uint64_t) view.len;
+    if (offset > size || bufferSize == 0) {
+        PyBuffer_Release(&view);
+        return PyLong_FromLong(0);
+    }
+    if (bufferSize > size - offset + 1)
+        bufferSize = size - offset + 1;
+
+    // read the LOB; the buffer remains valid while the GIL is released since
+    // the view is held for the duration of the read
+    status = cxoLob_readIntoBuffer(lob, (uint64_t) offset, bufferSize,
+            view.buf, &bufferSize);
+    PyBuffer_Release(&view);
+    if (status < 0)
+        return NULL;
+    return PyLong_FromUnsignedLongLong(bufferSize);
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoLob_iterChunks()
+//   Return an iterator over the data in the LOB in chunks of the given size.
+// The size defaults to the chunk size of the LOB and is otherwise rounded up
+// to a multiple of it.
+//-----------------------------------------------------------------------------
+static PyObject *cxoLob_iterChunks(cxoLob *lob, PyObject *args,
+        PyObject *keywordArgs)
+{
+    static char *keywordList[] = { "size", NULL };
+    uint32_t size, chunkSize;
+    cxoLobChunkIter *iter;
+
+    // parse arguments
+    size = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, keywordArgs, "|I", keywordList,
+            &size))
+        return NULL;
+
+    // determine the amount to read each time
+    if (cxoLob_getTransferChunkSize(lob, &chunkSize) < 0)
+        return NULL;
+    if (size == 0)
+        size = chunkSize;
+    else if (size % chunkSize != 0) {
+        if (size > UINT32_MAX - chunkSize) {
+            PyErr_SetString(PyExc_OverflowError, "size is too large");
+            return NULL;
+        }
+        size += chunkSize - size % chunkSize;
+    }
+
+    // create the iterator
+    iter = (cxoLobChunkIter*)
+            cxoPyTypeLobChunkIter.tp_alloc(&cxoPyTypeLobChunkIter, 0);
+    if (!iter)
+        return NULL;
+    Py_INCREF(lob);
+    iter->lob = lob;
+    iter->offset = 1;
+    iter->amount = size;
+    if (dpiLob_getSize(lob->handle, &iter->size) < 0) {
+        Py_DECREF(iter);
+        return cxoError_raiseAndReturnNull();
+    }
+
+    // character data is read into a buffer that is reused for each chunk
+    if (cxoLob_isCharacterData(lob)) {
+        if (dpiLob_getBufferSize(lob->handle, size, &iter->bufferSize) < 0) {
+            Py_DECREF(iter);
+            return cxoError_raiseAndReturnNull();
+        }
+        iter->buffer = PyMem_Malloc((size_t) iter->bufferSize);
+        if (!iter->buffer) {
+            Py_DECREF(iter);
+            return PyErr_NoMemory();
+        }
+    }
+
+    return (PyObject*) iter;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoLob_reader()
+//   Return a reader for incrementally reading the text in a CLOB or NCLOB.
+// The LOB is read in pieces of the given size (rounded up to a multiple of
+// the chunk size of the LOB), so the amount of memory used is bounded
+// regardless of the size of the LOB.
+//-----------------------------------------------------------------------------
+static PyObject *cxoLob_reader(cxoLob *lob, PyObject *args,
+        PyObject *keywordArgs)
+{
+    static char *keywordList[] = { "size", NULL };
+    uint32_t size, chunkSize;
+    cxoLobReader *reader;
+
+    // parse arguments
+    size = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, keywordArgs, "|I", keywordList,
+            &size))
+        return NULL;
+    if (!cxoLob_isCharacterData(lob)) {
+        cxoError_raiseFromString(cxoProgrammingErrorException,
+                "reader() is only supported for CLOB and NCLOB");
+        return NULL;
+    }
+
+    // determine the amount to read each time
+    if (cxoLob_getTransferChunkSize(lob, &chunkSize) < 0)
+        return NULL;
+    if (size == 0)
+        size = CXO_LOB_TRANSFER_SIZE;
+    if (size % chunkSize != 0) {
+        if (size > UINT32_MAX - chunkSize) {
+            PyErr_SetString(PyExc_OverflowError, "size is too large");
+            return NULL;
+        }
+        size += chunkSize - size % chunkSize;
+    }
+
+    // create the reader
+    reader = (cxoLobReader*)
+            cxoPyTypeLobReader.tp_alloc(&cxoPyTypeLobReader, 0);
+    if (!reader)
+        return NULL;
+    Py_INCREF(lob);
+    reader->lob = lob;
+    reader->amount = size;
+    reader->textOffset = 1;
+    reader->nextOffset = 1;
+    if (dpiLob_getSize(lob->handle, &reader->size) < 0) {
+        Py_DECREF(reader);
+        return cxoError_raiseAndReturnNull();
+    }
+    if (dpiLob_getBufferSize(lob->handle, size, &reader->bufferSize) < 0) {
+        Py_DECREF(reader);
+        return cxoError_raiseAndReturnNull();
+    }
+    reader->buffer = PyMem_Malloc((size_t) reader->bufferSize);
+    if (!reader->buffer) {
+        Py_DECREF(reader);
+        return PyErr_NoMemory();
+    }
+
+    return (PyObject*) reader;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoLob_readToFile()
+//   Write the data in the LOB to a file, starting at the given offset in the
+// LOB. The entire transfer takes place without holding the GIL, except when
+// the progress callback is called or when the data must be passed to a
+// decompressor or digest object. Character data is written in the encoding
+// used by the connection. The number of bytes written is returned, along with
+// the digest of the data read from the LOB, if one was requested.
+//-----------------------------------------------------------------------------
+static PyObject *cxoLob_readToFile(cxoLob *lob, PyObject *args,
+        PyObject *keywordArgs)
+{
+    static char *keywordList[] = { "file", "offset", "open_lob", "progress",
+            "progress_interval", "decompressor", "digest", NULL };
+    PyObject *fileObj, *progressObj, *decompressorObj, *digestObj;
+    unsigned PY_LONG_LONG offset, progressInterval;
+    uint64_t size, amount, length, startTime = 0;
+    int openLob, isTraced, needsGil;
+    cxoLobTransfer transfer;
+    int done = 0;
+
+    // parse arguments
+    offset = 1;
+    openLob = 0;
+    progressObj = decompressorObj = digestObj = NULL;
+    progressInterval = CXO_LOB_PROGRESS_INTERVAL;
+    if (!PyArg_ParseTupleAndKeywords(args, keywordArgs, "O|KpOKOO",
+            keywordList, &fileObj, &offset, &openLob, &progressObj,
+            &progressInterval, &decompressorObj, &digestObj))
+        return NULL;
+    if (cxoLobTransfer_init(&transfer, lob, fileObj, 1, openLob, progressObj,
+            progressInterval, decompressorObj, "decompress", digestObj) < 0)
+        return cxoLobTransfer_finalize(&transfer, 1);
+    if (dpiLob_getSize(lob->handle, &size) < 0) {
+        cxoError_raiseAndReturnNull();
+        return cxoLobTransfer_finalize(&transfer, 1);
+    }
+
+    // perform the transfer, reacquiring the GIL only to report progress or to
+    // pass each chunk to the decompressor or digest object
+    needsGil = (transfer.codec || transfer.digest);
+    isTraced = cxoTrace_isEnabled();
+    if (isTraced)
+        startTime = cxoUtils_getMonotonicTime();
+    while (!done) {
+        Py_BEGIN_ALLOW_THREADS
+        while (1) {
+            if (offset > size) {
+                done = 1;
+                break;
+            }
+            amount = size - offset + 1;
+            if (amount > transfer.amount)
+                amount = transfer.amount;
+            length = transfer.bufferSize;
+            if (dpiLob_readBytes(lob->handle, offset, amount,
+                    transfer.buffer, &length) < 0) {
+                dpiContext_getError(cxoDpiContext, &transfer.errorInfo);
+                transfer.dpiFailed = 1;
+                break;
+            }
+            if (length == 0) {
+                done = 1;
+                break;
+            }
+            offset += amount;
+            if (needsGil) {
+                transfer.numPendingBytes = length;
+                break;
+            }
+            if (transfer.computeCrc32c)
+                transfer.crc32c = cxoUtils_crc32c(transfer.crc32c,
+                        transfer.buffer, (size_t) length);
+            if (cxoUtils_writeFile(transfer.fd, transfer.buffer,
+                    (size_t) length,
+                    cxoLobTransfer_filePosition(&transfer)) < 0) {
+                transfer.fileErrorNum = errno;
+                break;
+            }
+            transfer.numFileBytes += length;
+            transfer.numBytes += length;
+            if (cxoLobTransfer_isProgressDue(&transfer))
+                break;
+        }
+        Py_END_ALLOW_THREADS
+        if (!transfer.dpiFailed && (transfer.numPendingBytes > 0 || done) &&
+                cxoLobTransfer_processChunk(&transfer, NULL, done) < 0)
+            return cxoLobTransfer_finalize(&transfer, 1);
+        if (transfer.dpiFailed || transfer.fileErrorNum)
+            break;
+        if ((done || cxoLobTransfer_isProgressDue(&transfer)) &&
+                cxoLobTransfer_reportProgress(&transfer) < 0)
+            return cxoLobTransfer_finalize(&transfer, 1);
+    }
+    if (isTraced)
+        cxoTrace_record(CXO_TRACE_OP_LOB_READ, NULL, NULL, startTime,
+                transfer.numBytes);
+
+    return cxoLobTransfer_finalize(&transfer, 0);
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoLob_writeFromFile()
+//   Write the contents of a file to a BLOB, starting at the given offset in
+// the LOB. The entire transfer takes place without holding the GIL, except
+// when the progress callback is called or when the data must be passed to a
+// compressor or digest object. The number of bytes written is returned, along
+// with the digest of the data written to the LOB, if one was requested.
+//-----------------------------------------------------------------------------
+static PyObject *cxoLob_writeFromFile(cxoLob *lob, PyObject *args,
+        PyObject *keywordArgs)
+{
+    static char *keywordList[] = { "file", "offset", "open_lob", "progress",
+            "progress_interval", "compressor", "digest", NULL };
+    PyObject *fileObj, *progressObj, *compressorObj, *digestObj;
+    unsigned PY_LONG_LONG offset, progressInterval;
+    int openLob, isTraced, needsGil;
+    uint64_t lobOffset, startTime = 0;
+    cxoLobTransfer transfer;
+    int64_t numRead;
+    int done = 0;
+
+    // parse arguments
+    offset = 1;
+    openLob = 0;
+    progressObj = compressorObj = digestObj = NULL;
+    progressInterval = CXO_LOB_PROGRESS_INTERVAL;
+    if (!PyArg_ParseTupleAndKeywords(args, keywordArgs, "O|KpOKOO",
+            keywordList, &fileObj, &offset, &openLob, &progressObj,
+            &progressInterval, &compressorObj, &digestObj))
+        return NULL;
+    lobOffset = offset;
+    if (cxoLob_isCharacterData(lob)) {
+        cxoError_raiseFromString(cxoProgrammingErrorException,
+                "write_from_file() is only supported for BLOB");
+        return NULL;
+    }
+    if (cxoLobTransfer_init(&transfer, lob, fileObj, 0, openLob, progressObj,
+            progressInterval, compressorObj, "compress", digestObj) < 0)
+        return cxoLobTransfer_finalize(&transfer, 1);
+
+    // perform the transfer, reacquiring the GIL only to report progress or to
+    // pass each chunk to the compressor or digest object
+    needsGil = (transfer.codec || transfer.digest);
+    isTraced = cxoTrace_isEnabled();
+    if (isTraced)
+        startTime = cxoUtils_getMonotonicTime();
+    while (!done) {
+        Py_BEGIN_ALLOW_THREADS
+        while (1) {
+            numRead = cxoUtils_readFile(transfer.fd, transfer.buffer,
+                    (size_t) transfer.bufferSize,
+                    cxoLobTransfer_filePosition(&transfer));
+            if (numRead < 0) {
+                transfer.fileErrorNum = errno;
+                break;
+            }
+            if (numRead == 0) {
+                done = 1;
+                break;
+            }
+            transfer.numFileBytes += (uint64_t) numRead;
+            if ((uint64_t) numRead < transfer.bufferSize)
+                done = 1;
+            if (needsGil) {
+                transfer.numPendingBytes = (uint64_t) numRead;
+                break;
+            }
+            if (transfer.computeCrc32c)
+                transfer.crc32c = cxoUtils_crc32c(transfer.crc32c,
+                        transfer.buffer, (size_t) numRead);
+            if (dpiLob_writeBytes(lob->handle, lobOffset, transfer.buffer,
+                    (uint64_t) numRead) < 0) {
+                dpiContext_getError(cxoDpiContext, &transfer.errorInfo);
+                transfer.dpiFailed = 1;
+                break;
+            }
+            lobOffset += (uint64_t) numRead;
+            transfer.numBytes += (uint64_t) numRead;
+            if (done || cxoLobTransfer_isProgressDue(&transfer))
+                break;
+        }
+        Py_END_ALLOW_THREADS
+        if (transfer.numPendingBytes > 0 &&
+                cxoLobTransfer_processChunk(&transfer, &lobOffset, 0) < 0)
+            return cxoLobTransfer_finalize(&transfer, 1);
+        if (done && !transfer.dpiFailed && !transfer.fileErrorNum &&
+                cxoLobTransfer_processChunk(&transfer, &lobOffset, 1) < 0)
+            return cxoLobTransfer_finalize(&transfer, 1);
+        if (transfer.dpiFailed || transfer.fileErrorNum)
+            break;
+        if ((done || cxoLobTransfer_isProgressDue(&transfer)) &&
+                cxoLobTransfer_reportProgress(&transfer) < 0)
+            return cxoLobTransfer_finalize(&transfer, 1);
+    }
+    if (isTraced)
+        cxoTrace_record(CXO_TRACE_OP_LOB_WRITE, NULL, NULL, startTime,
+                transfer.numBytes);
+
+    return cxoLobTransfer_finalize(&transfer, 0);
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoLobStream_run()
+//   Transfer the range of the LOB assigned to the stream, either between the
+// LOB and memory or between the LOB and a file. This may be called on a
+// native thread so the GIL is not held and the Python interpreter must not be
+// used. The error is captured since the error buffer belongs to the calling
+// thread.
+//-----------------------------------------------------------------------------
+static void cxoLobStream_run(void *arg)
+{
+    cxoLobStream *stream = (cxoLobStream*) arg;
+    uint64_t amount, length, position;
+    int64_t filePosition;
+    char *ptr;
+
+    while (stream->numBytes < stream->amount) {
+
+        // determine the size and location of the next piece
+        position = stream->offset + stream->numBytes;
+        amount = stream->amount - stream->numBytes;
+        if (amount > stream->pieceSize)
+            amount = stream->pieceSize;
+        filePosition = -1;
+        if (stream->filePosition >= 0)
+            filePosition = stream->filePosition + (int64_t) position;
+        ptr = (stream->data) ? stream->data + position : stream->buffer;
+
+        // transfer the piece from the LOB to memory or the file
+        if (!stream->toLob) {
+            length = amount;
+            if (dpiLob_readBytes(stream->handle, position + 1, amount, ptr,
+                    &length) < 0) {
+                stream->dpiFailed = 1;
+                break;
+            }
+            if (!stream->data && cxoUtils_writeFile(stream->fd, ptr,
+                    (size_t) length, filePosition) < 0) {
+                stream->fileErrorNum = errno;
+                break;
+            }
+
+        // transfer the piece from memory or the file to the LOB
+        } else {
+            length = amount;
+            if (!stream->data) {
+                filePosition = cxoUtils_readFile(stream->fd, ptr,
+                        (size_t) amount, filePosition);
+                if (filePosition < 0) {
+                    stream->fileErrorNum = errno;
+                    break;
+                }
+                length = (uint64_t) filePosition;
+            }
+            if (length > 0 && dpiLob_writeBytes(stream->handle, position + 1,
+                    ptr, length) < 0) {
+                stream->dpiFailed = 1;
+                break;
+            }
+        }
+
+        // stop when the end of the data has been reached
+        stream->numBytes += length;
+        if (length < amount)
+            break;
+
+    }
+
+    // retain the error, if applicable
+    if (stream->dpiFailed)
+        cxoError_captureInfo(&stream->error);
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoLob_parallelTransfer()
+//   Transfer the entire contents of a BLOB or BFILE to or from an object
+// supporting the buffer protocol or a file. The data is split into ranges
+// aligned to the chunk size of the LOB which are transferred concurrently,
+// each on its own native thread. When reading, additional LOBs referring to
+// the same data (for example, fetched using other connections) may be
+// supplied, in which case the streams are distributed among them. The client
+// serializes the calls made on a connection (and a connection not created in
+// threaded mode must not be used by several threads at all), so only one
+// stream is used for each distinct connection; LOBs supplied for a connection
+// already in use are ignored. Files that do not support positioned reads and
+// writes are transferred using a single stream. The number of bytes
+// transferred is returned.
+//-----------------------------------------------------------------------------
+static PyObject *cxoLob_parallelTransfer(cxoLob *lob, PyObject *targetObj,
+        uint32_t numStreams, PyObject *lobsObj, int toLob)
+{
+    uint64_t size, otherSize, streamSize, pieceSize, startTime = 0;
+    cxoLobStream *streams, *failedStream;
+    int64_t filePosition = -1, fileSize;
+    int fd = -1, closeFd = 0;
+    uint64_t numBytes = 0;
+    uint32_t numHandles, numConns, chunkSize, i, j;
+    PyObject *lobs = NULL;
+    cxoConnection **conns;
+    dpiLob **handles;
+    cxoLob *otherLob;
+    Py_buffer view;
+    int isTraced;
+
+    // validate parameters
+    if (numStreams == 0) {
+        PyErr_SetString(PyExc_ValueError, "streams must be at least 1");
+        return NULL;
+    }
+    if (toLob && lob->dbType != cxoDbTypeBlob) {
+        cxoError_raiseFromString(cxoProgrammingErrorException,
+                "parallel_write() is only supported for BLOB");
+        return NULL;
+    } else if (!toLob && cxoLob_isCharacterData(lob)) {
+        cxoError_raiseFromString(cxoProgrammingErrorException,
+                "parallel_read() is only supported for BLOB and BFILE");
+        return NULL;
+    }
+    if (cxoLob_getTransferChunkSize(lob, &chunkSize) < 0)
+        return NULL;
+    if (!toLob && dpiLob_getSize(lob->handle, &size) < 0)
+        return cxoError_raiseAndReturnNull();
+
+    // determine the LOB locators to use, one for each distinct connection
+    numHandles = 1;
+    if (lobsObj && lobsObj != Py_None) {
+        lobs = PySequence_Fast(lobsObj, "lobs must be a sequence");
+        if (!lobs)
+            return NULL;
+        numHandles += (uint32_t) PySequence_Fast_GET_SIZE(lobs);
+    }
+    handles = PyMem_Malloc(numHandles * sizeof(dpiLob*));
+    conns = PyMem_Malloc(numHandles * sizeof(cxoConnection*));
+    if (!handles || !conns) {
+        PyMem_Free(handles);
+        PyMem_Free(conns);
+        Py_XDECREF(lobs);
+        return PyErr_NoMemory();
+    }
+    numConns = 0;
+    for (i = 0; i < numHandles; i++) {
+        otherLob = (i == 0) ? lob :
+                (cxoLob*) PySequence_Fast_GET_ITEM(lobs, i - 1);
+        if (!PyObject_TypeCheck(otherLob, &cxoPyTypeLob) ||
+                otherLob->dbType != lob->dbType) {
+            PyErr_SetString(PyExc_TypeError,
+                    "lobs must contain LOBs of the same type");
+            break;
+        }
+        if (i > 0) {
+            if (dpiLob_getSize(otherLob->handle, &otherSize) < 0) {
+                cxoError_raiseAndReturnNull();
+                break;
+            }
+            if (otherSize != size) {
+                cxoError_raiseFromString(cxoProgrammingErrorException,
+                        "lobs must all be of the same size");
+                break;
+            }
+        }
+        for (j = 0; j < numConns; j++) {
+            if (conns[j] == otherLob->connection)
+                break;
+        }
+        if (j < numConns)
+            continue;
+        handles[numConns] = otherLob->handle;
+        conns[numConns++] = otherLob->connection;
+    }
+    PyMem_Free(conns);
+    if (PyErr_Occurred()) {
+        PyMem_Free(handles);
+        Py_XDECREF(lobs);
+        return NULL;
+    }
+    if (numStreams > numConns)
+        numStreams = numConns;
+
+    // determine the target of the transfer and the amount of data to
+    // transfer; files that are accessed sequentially use a single stream
+    // and are transferred to the LOB until the end of the file is reached
+    memset(&view, 0, sizeof(view));
+    if (PyObject_CheckBuffer(targetObj)) {
+        if (PyObject_GetBuffer(targetObj, &view,
+                (toLob) ? PyBUF_SIMPLE : PyBUF_WRITABLE) < 0) {
+            PyMem_Free(handles);
+            Py_XDECREF(lobs);
+            return NULL;
+        }
+        if (toLob)
+            size = (uint64_t) view.len;
+        else if ((uint64_t) view.len < size) {
+            PyErr_SetString(PyExc_ValueError,
+                    "buffer is too small to hold the LOB");
+            PyBuffer_Release(&view);
+            PyMem_Free(handles);
+            Py_XDECREF(lobs);
+            return NULL;
+        }
+    } else {
+        if (cxoUtils_openFile(targetObj, !toLob, &fd, &closeFd) < 0) {
+            PyMem_Free(handles);
+            Py_XDECREF(lobs);
+            return NULL;
+        }
+        filePosition = cxoUtils_getFilePosition(fd);
+        if (toLob) {
+            fileSize = cxoUtils_getFileSize(fd);
+            if (filePosition < 0 || fileSize < 0)
+                filePosition = -1;
+            size = (filePosition < 0) ? UINT64_MAX :
+                    (uint64_t) (fileSize - filePosition);
+        }
+        if (filePosition < 0)
+            numStreams = 1;
+    }
+
+    // split the data into ranges aligned to the chunk size; no more streams
+    // are used than there are chunks to transfer
+    pieceSize = CXO_LOB_TRANSFER_SIZE;
+    if (pieceSize % chunkSize != 0)
+        pieceSize += chunkSize - pieceSize % chunkSize;
+    streamSize = size;
+    if (numStreams > 1) {
+        if (size / chunkSize < numStreams)
+            numStreams = (uint32_t) ((size + chunkSize - 1) / chunkSize);
+        if (numStreams == 0)
+            numStreams = 1;
+        streamSize = (size + numStreams - 1) / numStreams;
+        if (streamSize % chunkSize != 0)
+            streamSize += chunkSize - streamSize % chunkSize;
+    }
+
+    // initialize the streams
+    streams = PyMem_Malloc(numStreams * sizeof(cxoLobStream));
+    if (!streams) {
+        PyErr_NoMemory();
+        numStreams = 0;
+    } else memset(streams, 0, numStreams * sizeof(cxoLobStream));
+    for (i = 0; i < numStreams; i++) {
+        streams[i].handle = handles[i];
+        streams[i].toLob = toLob;
+        streams[i].offset = (uint64_t) i * streamSize;
+        if (streams[i].offset < size)
+            streams[i].amount = size - streams[i].offset;
+        if (streams[i].amount > streamSize)
+            streams[i].amount = streamSize;
+        streams[i].pieceSize = pieceSize;
+        streams[i].data = (char*) view.buf;
+        streams[i].fd = fd;
+        streams[i].filePosition = filePosition;
+        if (!view.buf) {
+            streams[i].buffer = PyMem_Malloc((size_t) pieceSize);
+            if (!streams[i].buffer) {
+                PyErr_NoMemory();
+                break;
+            }
+        }
+    }
+
+    // perform the transfer; the first stream is transferred on this thread,
+    // as are any streams for which a thread could not be started
+    if (!PyErr_Occurred()) {
+        isTraced = cxoTrace_isEnabled();
+        if (isTraced)
+            startTime = cxoUtils_getMonotonicTime();
+        Py_BEGIN_ALLOW_THREADS
+        for (i = 1; i < numStreams; i++)
+            streams[i].started = (cxoUtils_startThread(&streams[i].thread,
+                    cxoLobStream_run, &streams[i]) == 0);
+        for (i = 0; i < numStreams; i++) {
+            if (!streams[i].started)
+                cxoLobStream_run(&streams[i]);
+        }
+        for (i = 1; i < numStreams; i++) {
+            if (streams[i].started)
+                cxoUtils_joinThread(streams[i].thread);
+        }
+        Py_END_ALLOW_THREADS
+        failedStream = NULL;
+        for (i = 0; i < numStreams; i++) {
+            numBytes += streams[i].numBytes;
+            if (!failedStream && (streams[i].dpiFailed ||
+                    streams[i].fileErrorNum))
+                failedStream = &streams[i];
+        }
+        if (isTraced)
+            cxoTrace_record((toLob) ? CXO_TRACE_OP_LOB_WRITE :
+                    CXO_TRACE_OP_LOB_READ, NULL, NULL, startTime, numBytes);
+        if (failedStream && failedStream->dpiFailed)
+            cxoError_raiseFromInfo(&failedStream->error.info);
+        else if (failedStream) {
+            errno = failedStream->fileErrorNum;
+            PyErr_SetFromErrno(PyExc_OSError);
+        }
+        if (fd >= 0 && !closeFd && filePosition >= 0)
+            cxoUtils_setFilePosition(fd, filePosition + (int64_t) numBytes);
+    }
+
+    // release resources
+    for (i = 0; i < numStreams; i++) {
+        if (streams[i].buffer)
+            PyMem_Free(streams[i].buffer);
+    }
+    if (streams)
+        PyMem_Free(streams);
+    if (fd >= 0)
+        cxoUtils_closeFile(fd, closeFd);
+    if (view.buf)
+        PyBuffer_Release(&view);
+    PyMem_Free(handles);
+    Py_XDECREF(lobs);
+    if (PyErr_Occurred())
+        return NULL;
+    return PyLong_FromUnsignedLongLong(numBytes);
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoLob_parallelRead()
+//   Read the entire contents of a BLOB or BFILE into a writable buffer or a
+// file using concurrent streams, one for each distinct connection.
+//-----------------------------------------------------------------------------
+static PyObject *cxoLob_parallelRead(cxoLob *lob, PyObject *args,
+        PyObject *keywordArgs)
+{
+    static char *keywordList[] = { "dest", "streams", "lobs", NULL };
+    unsigned int numStreams = CXO_LOB_DEFAULT_NUM_STREAMS;
+    PyObject *destObj, *lobsObj = NULL;
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywordArgs, "O|IO", keywordList,
+            &destObj, &numStreams, &lobsObj))
+        return NULL;
+    return cxoLob_parallelTransfer(lob, destObj, numStreams, lobsObj, 0);
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoLob_parallelWrite()
+//   Write the contents of an object supporting the buffer protocol or a file
+// to a BLOB. Only one connection is involved, so a single stream is used.
+//-----------------------------------------------------------------------------
+static PyObject *cxoLob_parallelWrite(cxoLob *lob, PyObject *args,
+        PyObject *keywordArgs)
+{
+    static char *keywordList[] = { "source", "streams", NULL };
+    unsigned int numStreams = CXO_LOB_DEFAULT_NUM_STREAMS;
+    PyObject *sourceObj;
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywordArgs, "O|I", keywordList,
+            &sourceObj, &numStreams))
+        return NULL;
+    return cxoLob_parallelTransfer(lob, sourceObj, numStreams, NULL, 1);
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoLobFile_setDpiError()
+//   Retain the error that took place while reading the BFILE. The error is
+// captured since the error buffer belongs to the calling thread.
+//-----------------------------------------------------------------------------
+static void cxoLobFile_setDpiError(cxoLobFile *file)
+{
+    file->dpiFailed = 1;
+    cxoError_captureInfo(&file->error);
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoLobFile_read()
+//   Open the BFILE, read its contents into memory or into the target file and
+// close it again. This is called without holding the GIL, possibly on a
+// native thread, so the Python interpreter must not be used.
+//-----------------------------------------------------------------------------
+static void cxoLobFile_read(cxoLobFile *file)
+{
+    uint64_t size = 0, amount, length, pieceSize = 0;
+    int fd = -1;
+    char *ptr;
+
+    // open the BFILE and determine its size
+    if (dpiLob_openResource(file->handle) < 0) {
+        cxoLobFile_setDpiError(file);
+        return;
+    }
+    if (dpiLob_getSize(file->handle, &size) < 0)
+        cxoLobFile_setDpiError(file);
+
+    // allocate the buffer; when writing to a file, only a single piece is
+    // held in memory at a time
+    if (!file->dpiFailed) {
+        pieceSize = size;
+        if (file->path && pieceSize > CXO_LOB_TRANSFER_SIZE)
+            pieceSize = CXO_LOB_TRANSFER_SIZE;
+        file->buffer = PyMem_RawMalloc((size_t) (pieceSize + 1));
+        if (!file->buffer)
+            file->fileErrorNum = ENOMEM;
+        else if (file->path) {
+            fd = cxoUtils_createFile(file->path);
+            if (fd < 0)
+                file->fileErrorNum = errno;
+        }
+    }
+
+    // read the contents of the BFILE
+    while (!file->dpiFailed && !file->fileErrorNum &&
+            file->numBytes < size) {
+        amount = size - file->numBytes;
+        if (amount > pieceSize)
+            amount = pieceSize;
+        ptr = (file->path) ? file->buffer : file->buffer + file->numBytes;
+        length = amount;
+        if (dpiLob_readBytes(file->handle, file->numBytes + 1, amount, ptr,
+                &length) < 0) {
+            cxoLobFile_setDpiError(file);
+            break;
+        }
+        if (file->path && cxoUtils_writeFile(fd, ptr, (size_t) length,
+                -1) < 0) {
+            file->fileErrorNum = errno;
+            break;
+        }
+        file->numBytes += length;
+        if (length < amount)
+            break;
+    }
+
+    // release resources; an error closing the BFILE is only retained if no
+    // other error has taken place
+    if (fd >= 0)
+        cxoUtils_closeFile(fd, 1);
+    if (dpiLob_closeResource(file->handle) < 0 && !file->dpiFailed &&
+            !file->fileErrorNum)
+        cxoLobFile_setDpiError(file);
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoLobFileWorker_run()
+//   Read each of the BFILEs assigned to the worker. This may be called on a
+// native thread so the GIL is not held.
+//-----------------------------------------------------------------------------
+static void cxoLobFileWorker_run(void *arg)
+{
+    cxoLobFileWorker *worker = (cxoLobFileWorker*) arg;
+    uint32_t i;
+
+    for (i = 0; i < worker->numFiles; i++) {
+        if (worker->files[i].workerNum == worker->workerNum)
+            cxoLobFile_read(&worker->files[i]);
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoLob_prepareFiles()
+//   Validate the BFILEs to read and, if a directory was specified, determine
+// the path of the file to which each of them is written. The paths are
+// placed in the result list. BFILEs that would be written to the same file
+// are rejected before anything is read.
+//-----------------------------------------------------------------------------
+static int cxoLob_prepareFiles(PyObject *lobs, PyObject *directoryObj,
+        cxoLobFile *files, PyObject *result)
+{
+    uint32_t directoryAliasLength, fileNameLength, i, numFiles;
+    PyObject *osPathModule, *nameObj, *pathObj, *paths;
+    const char *directoryAlias, *fileName;
+    int isDuplicate;
+    cxoLob *lob;
+
+    // validate the LOBs
+    numFiles = (uint32_t) PySequence_Fast_GET_SIZE(lobs);
+    for (i = 0; i < numFiles; i++) {
+        lob = (cxoLob*) PySequence_Fast_GET_ITEM(lobs, i);
+        if (!PyObject_TypeCheck(lob, &cxoPyTypeLob) ||
+                lob->dbType != cxoDbTypeBfile) {
+            PyErr_SetString(PyExc_TypeError,
+                    "lobs must contain only BFILE values");
+            return -1;
+        }
+        files[i].handle = lob->handle;
+        files[i].connection = lob->connection;
+    }
+    if (!directoryObj || directoryObj == Py_None)
+        return 0;
+
+    // each file is named after the BFILE it contains; only the last
+    // component of the name is used so that files are never written outside
+    // of the directory
+    osPathModule = PyImport_ImportModule("os.path");
+    if (!osPathModule)
+        return -1;
+    paths = PySet_New(NULL);
+    if (!paths) {
+        Py_DECREF(osPathModule);
+        return -1;
+    }
+    for (i = 0; i < numFiles; i++) {
+        lob = (cxoLob*) PySequence_Fast_GET_ITEM(lobs, i);
+        if (dpiLob_getDirectoryAndFileName(lob->handle, &directoryAlias,
+                &directoryAliasLength, &fileName, &fileNameLength) < 0) {
+            cxoError_raiseAndReturnInt();
+            break;
+        }
+        nameObj = PyUnicode_Decode(fileName, fileNameLength,
+                lob->connection->encodingInfo.encoding, NULL);
+        if (!nameObj)
+            break;
+        pathObj = PyObject_CallMethod(osPathModule, "basename", "N",
+                nameObj);
+        if (!pathObj)
+            break;
+        nameObj = pathObj;
+        pathObj = PyObject_CallMethod(osPathModule, "join", "ON",
+                directoryObj, nameObj);
+        if (!pathObj)
+            break;
+        PyList_SET_ITEM(result, i, pathObj);
+        isDuplicate = PySet_Contains(paths, pathObj);
+        if (isDuplicate > 0)
+            cxoError_raiseFromString(cxoProgrammingErrorException,
+                    "BFILEs with the same file name cannot be written to "
+                    "the same directory");
+        if (isDuplicate != 0 || PySet_Add(paths, pathObj) < 0)
+            break;
+        files[i].path = cxoUtils_encodePath(pathObj);
+        if (!files[i].path)
+            break;
+    }
+    Py_DECREF(osPathModule);
+    Py_DECREF(paths);
+
+    return (PyErr_Occurred()) ? -1 : 0;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoLob_assignFiles()
+//   Assign the BFILEs to workers and return the number of workers required,
+// which is no more than the given number of threads. A connection that was
+// not created in threaded mode must not be used by several threads at the
+// same time, so all of the BFILEs of such a connection are assigned to the
+// same worker; BFILEs of connections created in threaded mode are spread
+// across the workers.
+//-----------------------------------------------------------------------------
+static int cxoLob_assignFiles(cxoLobFile *files, uint32_t numFiles,
+        uint32_t numThreads, uint32_t *numWorkers)
+{
+    uint32_t i, j, numGroups, numThreadedFiles;
+    cxoConnection **groups;
+
+    // each connection not created in threaded mode forms a group
+    groups = PyMem_Malloc(numFiles * sizeof(cxoConnection*));
+    if (!groups) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    numGroups = numThreadedFiles = 0;
+    for (i = 0; i < numFiles; i++) {
+        if (files[i].connection->threaded) {
+            numThreadedFiles++;
+            continue;
+        }
+        for (j = 0; j < numGroups; j++) {
+            if (groups[j] == files[i].connection)
+                break;
+        }
+        if (j == numGroups)
+            groups[numGroups++] = files[i].connection;
+        files[i].workerNum = j;
+    }
+
+    // assign the groups and the remaining BFILEs to the workers
+    *numWorkers = numGroups + numThreadedFiles;
+    if (*numWorkers > numThreads)
+        *numWorkers = numThreads;
+    for (i = 0, j = numGroups; i < numFiles; i++) {
+        if (files[i].connection->threaded)
+            files[i].workerNum = j++ % *numWorkers;
+        else files[i].workerNum %= *numWorkers;
+    }
+    PyMem_Free(groups);
+
+    return 0;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoLob_readFiles()
+//   Read the contents of a number of BFILEs concurrently, using no more than
+// the given number of native threads. Each BFILE is opened, read and closed
+// again without holding the GIL. The contents are returned in a list of
+// bytes objects or, if a directory is specified, written to files in that
+// directory, in which case a list of the paths of these files is returned.
+// The BFILEs of each connection not created in threaded mode are read on a
+// single thread.
+//-----------------------------------------------------------------------------
+PyObject *cxoLob_readFiles(PyObject *args, PyObject *keywordArgs)
+{
+    static char *keywordList[] = { "lobs", "threads", "directory", NULL };
+    unsigned int numThreads = CXO_LOB_DEFAULT_NUM_STREAMS;
+    PyObject *lobsObj, *directoryObj = NULL, *lobs, *result, *temp;
+    uint32_t numFiles, numWorkers, i;
+    cxoLobFile *files, *failedFile;
+    uint64_t numBytes, startTime = 0;
+    cxoLobFileWorker *workers;
+    int isTraced;
+
+    // parse arguments
+    if (!PyArg_ParseTupleAndKeywords(args, keywordArgs, "O|IO", keywordList,
+            &lobsObj, &numThreads, &directoryObj))
+        return NULL;
+    if (numThreads == 0) {
+        PyErr_SetString(PyExc_ValueError, "threads must be at least 1");
+        return NULL;
+    }
+    lobs = PySequence_Fast(lobsObj, "lobs must be a sequence");
+    if (!lobs)
+        return NULL;
+    numFiles = (uint32_t) PySequence_Fast_GET_SIZE(lobs);
+    result = PyList_New(numFiles);
+    if (!result || numFiles == 0) {
+        Py_DECREF(lobs);
+        return result;
+    }
+
+    // prepare the files and the workers; no more workers are used than there
+    // are files that can be read concurrently
+    numWorkers = 0;
+    workers = NULL;
+    files = PyMem_Malloc(numFiles * sizeof(cxoLobFile));
+    if (!files) {
+        PyErr_NoMemory();
+    } else {
+        memset(files, 0, numFiles * sizeof(cxoLobFile));
+        if (cxoLob_prepareFiles(lobs, directoryObj, files, result) == 0 &&
+                cxoLob_assignFiles(files, numFiles, numThreads,
+                        &numWorkers) == 0) {
+            workers = PyMem_Malloc(numWorkers * sizeof(cxoLobFileWorker));
+            if (!workers)
+                PyErr_NoMemory();
+        }
+    }
+    if (workers) {
+        memset(workers, 0, numWorkers * sizeof(cxoLobFileWorker));
+        for (i = 0; i < numWorkers; i++) {
+            workers[i].files = files;
+            workers[i].numFiles = numFiles;
+            workers[i].workerNum = i;
+        }
+    }
+
+    // read the files; the first worker runs on this thread, as do any workers
+    // for which a thread could not be started
+    if (!PyErr_Occurred()) {
+        isTraced = cxoTrace_isEnabled();
+        if (isTraced)
+            startTime = cxoUtils_getMonotonicTime();
+        Py_BEGIN_ALLOW_THREADS
+        for (i = 1; i < numWorkers; i++)
+            workers[i].started = (cxoUtils_startThread(&workers[i].thread,
+                    cxoLobFileWorker_run, &workers[i]) == 0);
+        for (i = 0; i < numWorkers; i++) {
+            if (!workers[i].started)
+                cxoLobFileWorker_run(&workers[i]);
+        }
+        for (i = 1; i < numWorkers; i++) {
+            if (workers[i].started)
+                cxoUtils_joinThread(workers[i].thread);
+        }
+        Py_END_ALLOW_THREADS
+        numBytes = 0;
+        failedFile = NULL;
+        for (i = 0; i < numFiles; i++) {
+            numBytes += files[i].numBytes;
+            if (!failedFile && (files[i].dpiFailed || files[i].fileErrorNum))
+                failedFile = &files[i];
+        }
+        if (isTraced)
+            cxoTrace_record(CXO_TRACE_OP_LOB_READ, NULL, NULL, startTime,
+                    numBytes);
+        if (failedFile && failedFile->dpiFailed)
+            cxoError_raiseFromInfo(&failedFile->error.info);
+        else if (failedFile) {
+            errno = failedFile->fileErrorNum;
+            PyErr_SetFromErrno(PyExc_OSError);
+        }
+    }
+
+    // create the bytes objects, if applicable
+    for (i = 0; !PyErr_Occurred() && i < numFiles; i++) {
+        if (files[i].path)
+            continue;
+        temp = PyBytes_FromStringAndSize(files[i].buffer,
+                (Py_ssize_t) files[i].numBytes);
+        if (temp)
+            PyList_SET_ITEM(result, i, temp);
+    }
 
-    // offset and amount are expected, both optional
-    offset = 1;
-    amount = (unsigned PY_LONG_LONG)(-1);
-    if (!PyArg_ParseTupleAndKeywords(args, keywordArgs, "|KK", keywordList,
-            &offset, &amount))
+    // release resources
+    if (files) {
+        for (i = 0; i < numFiles; i++) {
+            if (files[i].buffer)
+                PyMem_RawFree(files[i].buffer);
+            if (files[i].path)
+                PyMem_Free(files[i].path);
+        }
+        PyMem_Free(files);
+    }
+    if (workers)
+        PyMem_Free(workers);
+    Py_DECREF(lobs);
+    if (PyErr_Occurred()) {
+        Py_DECREF(result);
         return NULL;
-    return cxoLob_internalRead(lob, (uint64_t) offset, (uint64_t) amount);
+    }
+    return result;
 }
 
 
@@ -416,6 +2133,19 @@ static PyMethodDef cxoLobMethods[] = {
     { "open", (PyCFunction) cxoLob_open, METH_NOARGS },
     { "close", (PyCFunction) cxoLob_close, METH_NOARGS },
     { "read", (PyCFunction) cxoLob_read, METH_VARARGS | METH_KEYWORDS },
+    { "readinto", (PyCFunction) cxoLob_readInto,
+            METH_VARARGS | METH_KEYWORDS },
+    { "iter_chunks", (PyCFunction) cxoLob_iterChunks,
+            METH_VARARGS | METH_KEYWORDS },
+    { "reader", (PyCFunction) cxoLob_reader, METH_VARARGS | METH_KEYWORDS },
+    { "read_to_file", (PyCFunction) cxoLob_readToFile,
+            METH_VARARGS | METH_KEYWORDS },
+    { "write_from_file", (PyCFunction) cxoLob_writeFromFile,
+            METH_VARARGS | METH_KEYWORDS },
+    { "parallel_read", (PyCFunction) cxoLob_parallelRead,
+            METH_VARARGS | METH_KEYWORDS },
+    { "parallel_write", (PyCFunction) cxoLob_parallelWrite,
+            METH_VARARGS | METH_KEYWORDS },
     { "write", (PyCFunction) cxoLob_write, METH_VARARGS | METH_KEYWORDS },
     { "trim", (PyCFunction) cxoLob_trim, METH_VARARGS | METH_KEYWORDS },
     { "getchunksize", (PyCFunction) cxoLob_getChunkSize, METH_NOARGS },
@@ -450,3 +2180,584 @@ PyTypeObject cxoPyTypeLob = {
     .tp_methods = cxoLobMethods,
     .tp_members = cxoMembers
 };
+
+
+//-----------------------------------------------------------------------------
+// cxoLobChunkIter_free()
+//   Free the chunk iterator.
+//-----------------------------------------------------------------------------
+static void cxoLobChunkIter_free(cxoLobChunkIter *iter)
+{
+    if (iter->buffer) {
+        PyMem_Free(iter->buffer);
+        iter->buffer = NULL;
+    }
+    Py_CLEAR(iter->lob);
+    Py_TYPE(iter)->tp_free((PyObject*) iter);
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoLobChunkIter_next()
+//   Return the next chunk of data from the LOB. Binary data is read directly
+// into the bytes object that is returned; character data is read into the
+// buffer owned by the iterator and then decoded.
+//-----------------------------------------------------------------------------
+static PyObject *cxoLobChunkIter_next(cxoLobChunkIter *iter)
+{
+    uint64_t amount, bufferSize;
+    PyObject *result;
+
+    // determine the amount to read; iteration ends when no data remains
+    if (!iter->lob || iter->offset > iter->size)
+        return NULL;
+    amount = iter->size - iter->offset + 1;
+    if (amount > iter->amount)
+        amount = iter->amount;
+
+    // read the data
+    if (!iter->buffer) {
+        result = cxoLob_readBytes(iter->lob, iter->offset, amount);
+        if (!result)
+            return NULL;
+        bufferSize = (uint64_t) PyBytes_GET_SIZE(result);
+    } else {
+        bufferSize = iter->bufferSize;
+        if (cxoLob_readIntoBuffer(iter->lob, iter->offset, amount,
+                iter->buffer, &bufferSize) < 0)
+            return NULL;
+        result = cxoLob_decode(iter->lob, iter->buffer, bufferSize);
+        if (!result)
+            return NULL;
+    }
+
+    // if the LOB was truncated while being iterated, stop
+    if (bufferSize == 0) {
+        Py_DECREF(result);
+        Py_CLEAR(iter->lob);
+        return NULL;
+    }
+    iter->offset += amount;
+
+    return result;
+}
+
+
+//-----------------------------------------------------------------------------
+// Python type declaration
+//-----------------------------------------------------------------------------
+PyTypeObject cxoPyTypeLobChunkIter = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "cx_Oracle.LobChunkIter",
+    .tp_basicsize = sizeof(cxoLobChunkIter),
+    .tp_dealloc = (destructor) cxoLobChunkIter_free,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_iter = PyObject_SelfIter,
+    .tp_iternext = (iternextfunc) cxoLobChunkIter_next
+};
+
+
+//-----------------------------------------------------------------------------
+// cxoLobReader_free()
+//   Free the reader.
+//-----------------------------------------------------------------------------
+static void cxoLobReader_free(cxoLobReader *reader)
+{
+    if (reader->buffer) {
+        PyMem_Free(reader->buffer);
+        reader->buffer = NULL;
+    }
+    if (reader->indexPositions) {
+        PyMem_Free(reader->indexPositions);
+        reader->indexPositions = NULL;
+    }
+    if (reader->indexOffsets) {
+        PyMem_Free(reader->indexOffsets);
+        reader->indexOffsets = NULL;
+    }
+    Py_CLEAR(reader->text);
+    Py_CLEAR(reader->lob);
+    Py_TYPE(reader)->tp_free((PyObject*) reader);
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoLobReader_isOpen()
+//   Determines if the reader is open. If not, a Python exception is raised.
+//-----------------------------------------------------------------------------
+static int cxoLobReader_isOpen(cxoLobReader *reader)
+{
+    if (!reader->lob) {
+        cxoError_raiseFromString(cxoInterfaceErrorException,
+                "LOB reader is closed");
+        return -1;
+    }
+    return 0;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoLobReader_addIndexEntry()
+//   Record the offset in the LOB corresponding to the given position in the
+// text, if the position is beyond any that has already been recorded. An
+// entry is recorded for each piece read, which allows a position to be found
+// later without reading and decoding the LOB from its start. Positions in the
+// text and offsets in the LOB differ when the LOB contains characters that
+// are stored as surrogate pairs.
+//-----------------------------------------------------------------------------
+static int cxoLobReader_addIndexEntry(cxoLobReader *reader,
+        uint64_t position, uint64_t offset)
+{
+    uint32_t numEntries;
+    uint64_t *entries;
+
+    if (reader->numIndexEntries > 0 && position <=
+            reader->indexPositions[reader->numIndexEntries - 1])
+        return 0;
+    if (reader->numIndexEntries == reader->allocatedIndexEntries) {
+        numEntries = (reader->allocatedIndexEntries == 0) ? 16 :
+                reader->allocatedIndexEntries * 2;
+        entries = PyMem_Realloc(reader->indexPositions,
+                numEntries * sizeof(uint64_t));
+        if (!entries) {
+            PyErr_NoMemory();
+            return -1;
+        }
+        reader->indexPositions = entries;
+        entries = PyMem_Realloc(reader->indexOffsets,
+                numEntries * sizeof(uint64_t));
+        if (!entries) {
+            PyErr_NoMemory();
+            return -1;
+        }
+        reader->indexOffsets = entries;
+        reader->allocatedIndexEntries = numEntries;
+    }
+    reader->indexPositions[reader->numIndexEntries] = position;
+    reader->indexOffsets[reader->numIndexEntries] = offset;
+    reader->numIndexEntries++;
+    return 0;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoLobReader_load()
+//   Read and decode the piece of the LOB found at the given offset, which
+// corresponds to the given position in the text. If the offset is beyond the
+// end of the LOB, no text is retained and the end of the LOB has been
+// reached.
+//-----------------------------------------------------------------------------
+static int cxoLobReader_load(cxoLobReader *reader, uint64_t offset,
+        uint64_t position)
+{
+    uint64_t amount, bufferSize;
+
+    // reset the state
+    Py_CLEAR(reader->text);
+    reader->textIndex = 0;
+    reader->textPosition = position;
+    reader->textOffset = offset;
+    reader->nextOffset = offset;
+    if (offset > reader->size)
+        return 0;
+
+    // read the data; if the LOB was truncated, treat it as its new size
+    amount = reader->size - offset + 1;
+    if (amount > reader->amount)
+        amount = reader->amount;
+    bufferSize = reader->bufferSize;
+    if (cxoLob_readIntoBuffer(reader->lob, offset, amount, reader->buffer,
+            &bufferSize) < 0)
+        return -1;
+    if (bufferSize == 0) {
+        reader->size = offset - 1;
+        return 0;
+    }
+
+    // decode the data and record its location
+    reader->text = cxoLob_decode(reader->lob, reader->buffer, bufferSize);
+    if (!reader->text)
+        return -1;
+    reader->nextOffset = offset + amount;
+    return cxoLobReader_addIndexEntry(reader, position, offset);
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoLobReader_fill()
+//   Ensure that text is available at the current position, reading the next
+// piece of the LOB if needed. Returns 1 if text is available, 0 if the end of
+// the LOB has been reached and -1 if an exception was raised.
+//-----------------------------------------------------------------------------
+static int cxoLobReader_fill(cxoLobReader *reader)
+{
+    uint64_t position;
+
+    if (reader->text &&
+            reader->textIndex < PyUnicode_GET_LENGTH(reader->text))
+        return 1;
+    position = reader->textPosition;
+    if (reader->text)
+        position += (uint64_t) PyUnicode_GET_LENGTH(reader->text);
+    if (cxoLobReader_load(reader, reader->nextOffset, position) < 0)
+        return -1;
+    return (reader->text) ? 1 : 0;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoLobReader_take()
+//   Append the given number of characters at the current position to the
+// list and advance the position past them.
+//-----------------------------------------------------------------------------
+static int cxoLobReader_take(cxoLobReader *reader, Py_ssize_t numChars,
+        PyObject *pieces)
+{
+    PyObject *piece;
+    int status;
+
+    piece = PyUnicode_Substring(reader->text, reader->textIndex,
+            reader->textIndex + numChars);
+    if (!piece)
+        return -1;
+    status = PyList_Append(pieces, piece);
+    Py_DECREF(piece);
+    reader->textIndex += numChars;
+    return status;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoLobReader_join()
+//   Join the pieces of text together and return the result. The list of
+// pieces is released.
+//-----------------------------------------------------------------------------
+static PyObject *cxoLobReader_join(PyObject *pieces)
+{
+    PyObject *separator, *result;
+
+    if (PyList_GET_SIZE(pieces) == 1) {
+        result = PyList_GET_ITEM(pieces, 0);
+        Py_INCREF(result);
+    } else {
+        separator = PyUnicode_New(0, 0);
+        if (!separator) {
+            Py_DECREF(pieces);
+            return NULL;
+        }
+        result = PyUnicode_Join(separator, pieces);
+        Py_DECREF(separator);
+    }
+    Py_DECREF(pieces);
+    return result;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoLobReader_read()
+//   Read and return up to the given number of characters from the current
+// position. If the number of characters is negative, all of the remaining
+// text is returned. An empty string is returned at the end of the LOB.
+//-----------------------------------------------------------------------------
+static PyObject *cxoLobReader_read(cxoLobReader *reader, PyObject *args,
+        PyObject *keywordArgs)
+{
+    static char *keywordList[] = { "size", NULL };
+    Py_ssize_t size = -1, numChars;
+    PyObject *pieces;
+    int status;
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywordArgs, "|n", keywordList,
+            &size))
+        return NULL;
+    if (cxoLobReader_isOpen(reader) < 0)
+        return NULL;
+    pieces = PyList_New(0);
+    if (!pieces)
+        return NULL;
+    while (size != 0) {
+        status = cxoLobReader_fill(reader);
+        if (status < 0) {
+            Py_DECREF(pieces);
+            return NULL;
+        } else if (status == 0)
+            break;
+        numChars = PyUnicode_GET_LENGTH(reader->text) - reader->textIndex;
+        if (size > 0 && numChars > size)
+            numChars = size;
+        if (cxoLobReader_take(reader, numChars, pieces) < 0) {
+            Py_DECREF(pieces);
+            return NULL;
+        }
+        if (size > 0)
+            size -= numChars;
+    }
+    return cxoLobReader_join(pieces);
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoLobReader_internalReadLine()
+//   Return the text up to and including the next newline character, or up
+// to the given number of characters, if that is not negative. An empty string
+// is returned at the end of the LOB.
+//-----------------------------------------------------------------------------
+static PyObject *cxoLobReader_internalReadLine(cxoLobReader *reader,
+        Py_ssize_t size)
+{
+    Py_ssize_t numChars, pos, length;
+    PyObject *pieces;
+    int status;
+
+    if (cxoLobReader_isOpen(reader) < 0)
+        return NULL;
+    pieces = PyList_New(0);
+    if (!pieces)
+        return NULL;
+    while (size != 0) {
+        status = cxoLobReader_fill(reader);
+        if (status < 0) {
+            Py_DECREF(pieces);
+            return NULL;
+        } else if (status == 0)
+            break;
+        length = PyUnicode_GET_LENGTH(reader->text);
+        pos = PyUnicode_FindChar(reader->text, '\n', reader->textIndex,
+                length, 1);
+        if (pos == -2) {
+            Py_DECREF(pieces);
+            return NULL;
+        }
+        numChars = ((pos < 0) ? length : pos + 1) - reader->textIndex;
+        if (size > 0 && numChars > size) {
+            numChars = size;
+            pos = -1;
+        }
+        if (cxoLobReader_take(reader, numChars, pieces) < 0) {
+            Py_DECREF(pieces);
+            return NULL;
+        }
+        if (pos >= 0)
+            break;
+        if (size > 0)
+            size -= numChars;
+    }
+    return cxoLobReader_join(pieces);
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoLobReader_readLine()
+//   Read and return the next line of text from the current position.
+//-----------------------------------------------------------------------------
+static PyObject *cxoLobReader_readLine(cxoLobReader *reader, PyObject *args,
+        PyObject *keywordArgs)
+{
+    static char *keywordList[] = { "size", NULL };
+    Py_ssize_t size = -1;
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywordArgs, "|n", keywordList,
+            &size))
+        return NULL;
+    return cxoLobReader_internalReadLine(reader, size);
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoLobReader_seek()
+//   Change the current position in the text, which is expressed in
+// characters. The whence argument indicates whether the position is absolute
+// (0) or relative to the current position (1). The piece of the LOB
+// containing the position is located using the index of positions recorded
+// as pieces are read, so only the pieces following the nearest recorded
+// position need to be read. Positions beyond the end of the LOB are treated
+// as the end of the LOB. The new position is returned.
+//-----------------------------------------------------------------------------
+static PyObject *cxoLobReader_seek(cxoLobReader *reader, PyObject *args,
+        PyObject *keywordArgs)
+{
+    static char *keywordList[] = { "offset", "whence", NULL };
+    uint64_t target, position, offset, textLength;
+    uint32_t low, high, mid;
+    long long seekOffset;
+    int whence = 0;
+
+    // parse arguments
+    if (!PyArg_ParseTupleAndKeywords(args, keywordArgs, "L|i", keywordList,
+            &seekOffset, &whence))
+        return NULL;
+    if (cxoLobReader_isOpen(reader) < 0)
+        return NULL;
+    position = reader->textPosition + (uint64_t) reader->textIndex;
+    if (whence == 1) {
+        if (seekOffset < 0 && (uint64_t) -seekOffset > position) {
+            PyErr_SetString(PyExc_ValueError, "negative seek position");
+            return NULL;
+        }
+        target = position + (uint64_t) seekOffset;
+    } else if (whence == 0) {
+        if (seekOffset < 0) {
+            PyErr_SetString(PyExc_ValueError, "negative seek position");
+            return NULL;
+        }
+        target = (uint64_t) seekOffset;
+    } else {
+        PyErr_SetString(PyExc_ValueError, "whence must be 0 or 1");
+        return NULL;
+    }
+
+    // if the position is within the current piece, nothing needs to be read
+    textLength = (reader->text) ?
+            (uint64_t) PyUnicode_GET_LENGTH(reader->text) : 0;
+    if (target >= reader->textPosition &&
+            target <= reader->textPosition + textLength &&
+            (reader->text || target == reader->textPosition)) {
+        reader->textIndex = (Py_ssize_t) (target - reader->textPosition);
+        return PyLong_FromUnsignedLongLong(target);
+    }
+
+    // find the nearest recorded position at or before the target
+    position = 0;
+    offset = 1;
+    if (reader->numIndexEntries > 0) {
+        low = 0;
+        high = reader->numIndexEntries - 1;
+        while (low < high) {
+            mid = low + (high - low + 1) / 2;
+            if (reader->indexPositions[mid] <= target)
+                low = mid;
+            else high = mid - 1;
+        }
+        position = reader->indexPositions[low];
+        offset = reader->indexOffsets[low];
+    }
+
+    // read pieces until the one containing the target is found
+    if (cxoLobReader_load(reader, offset, position) < 0)
+        return NULL;
+    while (reader->text) {
+        textLength = (uint64_t) PyUnicode_GET_LENGTH(reader->text);
+        if (target <= reader->textPosition + textLength)
+            break;
+        if (cxoLobReader_load(reader, reader->nextOffset,
+                reader->textPosition + textLength) < 0)
+            return NULL;
+    }
+    if (reader->text)
+        reader->textIndex = (Py_ssize_t) (target - reader->textPosition);
+    return PyLong_FromUnsignedLongLong(reader->textPosition +
+            (uint64_t) reader->textIndex);
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoLobReader_tell()
+//   Return the current position in the text, in characters.
+//-----------------------------------------------------------------------------
+static PyObject *cxoLobReader_tell(cxoLobReader *reader, PyObject *args)
+{
+    if (cxoLobReader_isOpen(reader) < 0)
+        return NULL;
+    return PyLong_FromUnsignedLongLong(reader->textPosition +
+            (uint64_t) reader->textIndex);
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoLobReader_close()
+//   Close the reader, releasing the LOB and the memory used by the reader.
+//-----------------------------------------------------------------------------
+static PyObject *cxoLobReader_close(cxoLobReader *reader, PyObject *args)
+{
+    if (reader->buffer) {
+        PyMem_Free(reader->buffer);
+        reader->buffer = NULL;
+    }
+    Py_CLEAR(reader->text);
+    Py_CLEAR(reader->lob);
+    Py_RETURN_NONE;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoLobReader_contextManagerEnter()
+//   Called when the reader is used as a context manager and simply returns
+// itself as a convenience to the caller.
+//-----------------------------------------------------------------------------
+static PyObject *cxoLobReader_contextManagerEnter(cxoLobReader *reader,
+        PyObject* args)
+{
+    Py_INCREF(reader);
+    return (PyObject*) reader;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoLobReader_contextManagerExit()
+//   Called when the reader is used as a context manager and closes the
+// reader.
+//-----------------------------------------------------------------------------
+static PyObject *cxoLobReader_contextManagerExit(cxoLobReader *reader,
+        PyObject* args)
+{
+    PyObject *excType, *excValue, *excTraceback, *result;
+
+    if (!PyArg_ParseTuple(args, "OOO", &excType, &excValue, &excTraceback))
+        return NULL;
+    result = cxoLobReader_close(reader, NULL);
+    if (!result)
+        return NULL;
+    Py_DECREF(result);
+    Py_INCREF(Py_False);
+    return Py_False;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoLobReader_next()
+//   Return the next line of text from the LOB.
+//-----------------------------------------------------------------------------
+static PyObject *cxoLobReader_next(cxoLobReader *reader)
+{
+    PyObject *line;
+
+    line = cxoLobReader_internalReadLine(reader, -1);
+    if (line && PyUnicode_GET_LENGTH(line) == 0) {
+        Py_DECREF(line);
+        return NULL;
+    }
+    return line;
+}
+
+
+//-----------------------------------------------------------------------------
+// declaration of methods
+//-----------------------------------------------------------------------------
+static PyMethodDef cxoLobReaderMethods[] = {
+    { "read", (PyCFunction) cxoLobReader_read, METH_VARARGS | METH_KEYWORDS },
+    { "readline", (PyCFunction) cxoLobReader_readLine,
+            METH_VARARGS | METH_KEYWORDS },
+    { "seek", (PyCFunction) cxoLobReader_seek, METH_VARARGS | METH_KEYWORDS },
+    { "tell", (PyCFunction) cxoLobReader_tell, METH_NOARGS },
+    { "close", (PyCFunction) cxoLobReader_close, METH_NOARGS },
+    { "__enter__", (PyCFunction) cxoLobReader_contextManagerEnter,
+            METH_NOARGS },
+    { "__exit__", (PyCFunction) cxoLobReader_contextManagerExit,
+            METH_VARARGS },
+    { NULL, NULL }
+};
+
+
+//-----------------------------------------------------------------------------
+// Python type declaration
+//-----------------------------------------------------------------------------
+PyTypeObject cxoPyTypeLobReader = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "cx_Oracle.LobReader",
+    .tp_basicsize = sizeof(cxoLobReader),
+    .tp_dealloc = (destructor) cxoLobReader_free,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_iter = PyObject_SelfIter,
+    .tp_iternext = (iternextfunc) cxoLobReader_next,
+    .tp_methods = cxoLobReaderMethods
+};
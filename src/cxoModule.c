@@ -292,6 +292,63 @@ static PyObject* cxoModule_initClientLib(PyObject* self, PyObject* args,
 }
 
 
+//-----------------------------------------------------------------------------
+// cxoModule_connectMany()
+//   Create a number of standalone connections concurrently and return them in
+// a list.
+//-----------------------------------------------------------------------------
+static PyObject* cxoModule_connectMany(PyObject* self, PyObject* args,
+        PyObject* keywordArgs)
+{
+    return cxoConnection_connectMany(args, keywordArgs);
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoModule_flushTraceEvents()
+//   Deliver any trace events that have been batched to the trace hook.
+//-----------------------------------------------------------------------------
+static PyObject* cxoModule_flushTraceEvents(PyObject* self, PyObject* args)
+{
+    if (cxoTrace_flush() < 0)
+        return NULL;
+    Py_RETURN_NONE;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoModule_readBfiles()
+//   Read the contents of a number of BFILEs concurrently and return them in a
+// list (or write them to files in a directory).
+//-----------------------------------------------------------------------------
+static PyObject* cxoModule_readBfiles(PyObject* self, PyObject* args,
+        PyObject* keywordArgs)
+{
+    return cxoLob_readFiles(args, keywordArgs);
+}
+
+//-----------------------------------------------------------------------------
+// cxoModule_setTraceHook()
+//   Set the hook which is called with trace events for each blocking call
+// made by the module, or clear it if the value None is passed.
+//-----------------------------------------------------------------------------
+static PyObject* cxoModule_setTraceHook(PyObject* self, PyObject* args,
+        PyObject* keywordArgs)
+{
+    static char *keywordList[] = { "hook", "batch_size", NULL };
+    Py_ssize_t batchSize = 1;
+    PyObject *hook;
+
+    if (!PyArg_ParseTupleAndKeywords(args, keywordArgs, "O|n", keywordList,
+            &hook, &batchSize))
+        return NULL;
+    if (cxoTrace_setHook(hook, batchSize) < 0)
+        return NULL;
+
+    Py_RETURN_NONE;
+}
+
+
 //-----------------------------------------------------------------------------
 // cxoModule_time()
 //   Returns a time value suitable for binding.
@@ -348,6 +405,14 @@ static PyMethodDef cxoModuleMethods[] = {
     { "clientversion", (PyCFunction) cxoModule_clientVersion, METH_NOARGS },
     { "init_oracle_client", (PyCFunction) cxoModule_initClientLib,
             METH_VARARGS | METH_KEYWORDS },
+    { "connect_many", (PyCFunction) cxoModule_connectMany,
+            METH_VARARGS | METH_KEYWORDS },
+    { "read_bfiles", (PyCFunction) cxoModule_readBfiles,
+            METH_VARARGS | METH_KEYWORDS },
+    { "set_trace_hook", (PyCFunction) cxoModule_setTraceHook,
+            METH_VARARGS | METH_KEYWORDS },
+    { "flush_trace_events", (PyCFunction) cxoModule_flushTraceEvents,
+            METH_NOARGS },
     { NULL }
 };
 
@@ -390,6 +455,8 @@ static PyObject *cxoModule_initialize(void)
     CXO_MAKE_TYPE_READY(&cxoPyTypeError);
     CXO_MAKE_TYPE_READY(&cxoPyTypeFuture);
     CXO_MAKE_TYPE_READY(&cxoPyTypeLob);
+    CXO_MAKE_TYPE_READY(&cxoPyTypeLobChunkIter);
+    CXO_MAKE_TYPE_READY(&cxoPyTypeLobReader);
     CXO_MAKE_TYPE_READY(&cxoPyTypeMsgProps);
     CXO_MAKE_TYPE_READY(&cxoPyTypeMessage);
     CXO_MAKE_TYPE_READY(&cxoPyTypeMessageQuery);
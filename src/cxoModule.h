@@ -9,12 +9,18 @@
 //   Include file for all cx_Oracle source files.
 //-----------------------------------------------------------------------------
 
+#ifndef CXO_MODULE_H
+#define CXO_MODULE_H
+
 #define PY_SSIZE_T_CLEAN                1
 
 #include <Python.h>
 #include <structmember.h>
 #include <time.h>
 #include <dpi.h>
+#ifndef _WIN32
+#include <pthread.h>
+#endif
 
 // define macros to get the build version as a string and the driver name
 #define xstr(s)                         str(s)
@@ -25,6 +31,22 @@
 // define macro for clearing buffers
 #define cxoBuffer_clear(buf)            Py_CLEAR((buf)->obj)
 
+// define macro for determining if trace events should be recorded
+#define cxoTrace_isEnabled()            (cxoTraceHook != NULL)
+
+// define type used for native threads
+#ifdef _WIN32
+typedef void *cxoThread;
+#else
+typedef pthread_t cxoThread;
+#endif
+
+// define number of buckets in the session pool acquire wait time histogram
+#define CXO_POOL_NUM_WAIT_BUCKETS       12
+
+// define number of define variables retained by each connection for reuse
+#define CXO_CONNECTION_DEFINE_CACHE_SIZE    16
+
 
 //-----------------------------------------------------------------------------
 // Forward Declarations
@@ -37,9 +59,12 @@ typedef struct cxoDbType cxoDbType;
 typedef struct cxoDeqOptions cxoDeqOptions;
 typedef struct cxoEnqOptions cxoEnqOptions;
 typedef struct cxoError cxoError;
+typedef struct cxoErrorBuffer cxoErrorBuffer;
 typedef struct cxoFuture cxoFuture;
 typedef struct cxoJsonBuffer cxoJsonBuffer;
 typedef struct cxoLob cxoLob;
+typedef struct cxoLobChunkIter cxoLobChunkIter;
+typedef struct cxoLobReader cxoLobReader;
 typedef struct cxoMessage cxoMessage;
 typedef struct cxoMessageQuery cxoMessageQuery;
 typedef struct cxoMessageRow cxoMessageRow;
@@ -48,6 +73,10 @@ typedef struct cxoMsgProps cxoMsgProps;
 typedef struct cxoObject cxoObject;
 typedef struct cxoObjectAttr cxoObjectAttr;
 typedef struct cxoObjectType cxoObjectType;
+typedef struct cxoPoolAffinitySlot cxoPoolAffinitySlot;
+typedef struct cxoPoolQueue cxoPoolQueue;
+typedef struct cxoPoolStats cxoPoolStats;
+typedef struct cxoPoolWarmer cxoPoolWarmer;
 typedef struct cxoQueue cxoQueue;
 typedef struct cxoSessionPool cxoSessionPool;
 typedef struct cxoSodaCollection cxoSodaCollection;
@@ -55,7 +84,9 @@ typedef struct cxoSodaDatabase cxoSodaDatabase;
 typedef struct cxoSodaDoc cxoSodaDoc;
 typedef struct cxoSodaDocCursor cxoSodaDocCursor;
 typedef struct cxoSodaOperation cxoSodaOperation;
+typedef struct cxoStats cxoStats;
 typedef struct cxoSubscr cxoSubscr;
+typedef struct cxoTempLob cxoTempLob;
 typedef struct cxoVar cxoVar;
 
 
@@ -85,6 +116,8 @@ extern PyTypeObject cxoPyTypeEnqOptions;
 extern PyTypeObject cxoPyTypeError;
 extern PyTypeObject cxoPyTypeFuture;
 extern PyTypeObject cxoPyTypeLob;
+extern PyTypeObject cxoPyTypeLobChunkIter;
+extern PyTypeObject cxoPyTypeLobReader;
 extern PyTypeObject cxoPyTypeMsgProps;
 extern PyTypeObject cxoPyTypeMessage;
 extern PyTypeObject cxoPyTypeMessageQuery;
@@ -153,6 +186,9 @@ extern dpiVersionInfo cxoClientVersionInfo;
 // future object
 extern cxoFuture *cxoFutureObj;
 
+// hook to which trace events are delivered, if one has been registered
+extern PyObject *cxoTraceHook;
+
 
 //-----------------------------------------------------------------------------
 // Enumerations
@@ -199,6 +235,21 @@ typedef enum {
     CXO_OCI_ATTR_TYPE_UINT64 = 64
 } cxoOciAttrType;
 
+typedef enum {
+    CXO_TRACE_OP_PREPARE = 0,
+    CXO_TRACE_OP_PARSE,
+    CXO_TRACE_OP_EXECUTE,
+    CXO_TRACE_OP_EXECUTE_MANY,
+    CXO_TRACE_OP_FETCH,
+    CXO_TRACE_OP_COMMIT,
+    CXO_TRACE_OP_ROLLBACK,
+    CXO_TRACE_OP_LOB_READ,
+    CXO_TRACE_OP_LOB_WRITE,
+    CXO_TRACE_OP_ENQUEUE,
+    CXO_TRACE_OP_DEQUEUE,
+    CXO_TRACE_OP_ACQUIRE
+} cxoTraceOp;
+
 
 //-----------------------------------------------------------------------------
 // Structures
@@ -226,6 +277,55 @@ struct cxoError {
     char isRecoverable;
 };
 
+struct cxoErrorBuffer {
+    dpiErrorInfo info;
+    char message[3072];
+    char encoding[64];
+    char fnName[64];
+    char action[64];
+};
+
+struct cxoPoolAffinitySlot {
+    unsigned long threadId;
+    dpiConn *handle;
+    uint64_t releaseTime;
+};
+
+struct cxoPoolStats {
+    uint64_t startTime;
+    uint64_t lastUpdateTime;
+    uint64_t numAcquires;
+    uint64_t numAcquireFailures;
+    uint64_t numAcquireTimeouts;
+    uint64_t numSessionsCreated;
+    uint64_t numSessionsDestroyed;
+    uint64_t totalWaitTime;
+    uint64_t maxWaitTime;
+    uint64_t waitHistogram[CXO_POOL_NUM_WAIT_BUCKETS];
+    uint64_t busyTime;
+    uint64_t numAffinityHits;
+    uint64_t numWarmerSessionsOpened;
+    uint64_t numWarmerSessionsEvicted;
+    uint32_t busyCount;
+    uint32_t busyHighWater;
+    uint32_t openCount;
+    uint32_t openHighWater;
+};
+
+struct cxoStats {
+    uint64_t numFetches;
+    uint64_t numRowsFetched;
+    uint64_t numDefineBytes;
+    uint64_t numBindReallocations;
+    uint64_t waitTime;
+    uint64_t conversionTime;
+};
+
+struct cxoTempLob {
+    dpiLob *handle;
+    dpiOracleTypeNum oracleTypeNum;
+};
+
 struct cxoConnection {
     PyObject_HEAD
     dpiConn *handle;
@@ -235,9 +335,26 @@ struct cxoConnection {
     PyObject *username;
     PyObject *dsn;
     PyObject *version;
+    PyObject *versionInfo;
+    PyObject *encoding;
+    PyObject *nencoding;
     PyObject *tag;
     dpiEncodingInfo encodingInfo;
     int autocommit;
+    int threaded;
+    char statsEnabled;
+    char holdsLease;
+    cxoStats stats;
+    cxoVar *defineCache[CXO_CONNECTION_DEFINE_CACHE_SIZE];
+    uint32_t numCachedDefines;
+    uint32_t lobPrefetchSize;
+    cxoTempLob *tempLobs;
+    uint32_t numTempLobs;
+    uint32_t tempLobPoolSize;
+    uint64_t tempLobMaxSize;
+    uint64_t numTempLobsCreated;
+    uint64_t numTempLobsReused;
+    uint64_t numTempLobsDiscarded;
 };
 
 struct cxoCursor {
@@ -264,6 +381,13 @@ struct cxoCursor {
     char isScrollable;
     int fixupRefCursor;
     int isOpen;
+    char statsEnabled;
+    cxoStats stats;
+    PyObject *windowCache;
+    uint32_t windowCacheSize;
+    char fetchLobs;
+    uint32_t inlineLobSize;
+    char bulkLobBinds;
 };
 
 struct cxoDbType {
@@ -304,6 +428,34 @@ struct cxoLob {
     dpiLob *handle;
 };
 
+struct cxoLobChunkIter {
+    PyObject_HEAD
+    cxoLob *lob;
+    char *buffer;
+    uint64_t bufferSize;
+    uint64_t offset;
+    uint64_t amount;
+    uint64_t size;
+};
+
+struct cxoLobReader {
+    PyObject_HEAD
+    cxoLob *lob;
+    char *buffer;
+    uint64_t bufferSize;
+    uint64_t amount;
+    uint64_t size;
+    PyObject *text;
+    Py_ssize_t textIndex;
+    uint64_t textPosition;
+    uint64_t textOffset;
+    uint64_t nextOffset;
+    uint64_t *indexPositions;
+    uint64_t *indexOffsets;
+    uint32_t numIndexEntries;
+    uint32_t allocatedIndexEntries;
+};
+
 struct cxoMessage {
     PyObject_HEAD
     cxoSubscr *subscription;
@@ -400,6 +552,19 @@ struct cxoSessionPool {
     PyObject *name;
     PyObject *sessionCallback;
     PyTypeObject *connectionType;
+    cxoPoolStats stats;
+    cxoPoolWarmer *warmer;
+    cxoPoolQueue *queue;
+    int threaded;
+    int threadAffinity;
+    uint32_t affinityTimeout;
+    cxoPoolAffinitySlot *affinitySlots;
+    uint32_t numAffinitySlots;
+    uint32_t numAllocatedAffinitySlots;
+    uint64_t nextAffinitySweep;
+    PyObject *affinityLocal;
+    PyObject *sessionStates;
+    PyObject *sessionDefaults;
 };
 
 struct cxoSodaCollection {
@@ -477,6 +642,9 @@ struct cxoVar {
     cxoTransformNum transformNum;
     dpiNativeTypeNum nativeTypeNum;
     cxoDbType *dbType;
+    uint32_t inlineLobSize;
+    dpiLob **pooledLobs;
+    int lobPoolDisabled;
 };
 
 
@@ -486,8 +654,24 @@ struct cxoVar {
 int cxoBuffer_fromObject(cxoBuffer *buf, PyObject *obj, const char *encoding);
 int cxoBuffer_init(cxoBuffer *buf);
 
+dpiLob *cxoConnection_acquireTempLob(cxoConnection *conn,
+        dpiOracleTypeNum oracleTypeNum);
+int cxoConnection_cacheDefine(cxoConnection *conn, cxoVar *var);
+void cxoConnection_clearDefineCache(cxoConnection *conn);
+void cxoConnection_clearTempLobPool(cxoConnection *conn);
+PyObject *cxoConnection_connectMany(PyObject *args, PyObject *keywordArgs);
+cxoVar *cxoConnection_getCachedDefine(cxoConnection *conn,
+        cxoTransformNum transformNum, uint32_t size, uint32_t numElements);
 int cxoConnection_getSodaFlags(cxoConnection *conn, uint32_t *flags);
 int cxoConnection_isConnected(cxoConnection *conn);
+PyObject *cxoConnection_newFromHandle(cxoSessionPool *pool, dpiConn *handle);
+PyObject *cxoConnection_newFromPool(cxoSessionPool *pool,
+        PyObject *usernameObj, PyObject *passwordObj, PyObject *cclassObj,
+        uint32_t purity, PyObject *tagObj, int matchAnyTag,
+        PyObject *shardingKeyObj, PyObject *superShardingKeyObj);
+void cxoConnection_releaseTempLob(cxoConnection *conn, dpiLob *handle,
+        dpiOracleTypeNum oracleTypeNum);
+int cxoConnection_setLobPrefetchSize(cxoConnection *conn, uint32_t size);
 
 int cxoCursor_performBind(cxoCursor *cursor);
 int cxoCursor_setBindVariables(cxoCursor *cursor, PyObject *parameters,
@@ -502,6 +686,7 @@ cxoDeqOptions *cxoDeqOptions_new(cxoConnection *connection,
 cxoEnqOptions *cxoEnqOptions_new(cxoConnection *connection,
         dpiEnqOptions *handle);
 
+void cxoError_captureInfo(cxoErrorBuffer *buffer);
 cxoError *cxoError_newFromInfo(dpiErrorInfo *errorInfo);
 int cxoError_raiseAndReturnInt(void);
 PyObject *cxoError_raiseAndReturnNull(void);
@@ -512,8 +697,10 @@ PyObject *cxoError_raiseFromString(PyObject *exceptionType,
 void cxoJsonBuffer_free(cxoJsonBuffer *buf);
 int cxoJsonBuffer_fromObject(cxoJsonBuffer *buf, PyObject *obj);
 
+PyObject *cxoLob_getInlineValue(cxoLob *lob, uint64_t maxSize);
 PyObject *cxoLob_new(cxoConnection *connection, cxoDbType *dbType,
         dpiLob *handle);
+PyObject *cxoLob_readFiles(PyObject *args, PyObject *keywordArgs);
 
 cxoMsgProps *cxoMsgProps_new(cxoConnection*, dpiMsgProps *handle);
 
@@ -530,6 +717,44 @@ cxoObjectType *cxoObjectType_newByName(cxoConnection *connection,
 
 cxoQueue *cxoQueue_new(cxoConnection *conn, dpiQueue *handle);
 
+void cxoPoolQueue_close(cxoSessionPool *pool);
+int cxoPoolQueue_enter(cxoSessionPool *pool, int32_t priority);
+void cxoPoolQueue_free(cxoPoolQueue *queue);
+PyObject *cxoPoolQueue_getReservations(cxoPoolQueue *queue);
+void cxoPoolQueue_getStats(cxoPoolQueue *queue, uint32_t *numWaiters,
+        uint64_t *numWaits, uint64_t *numTimeouts);
+void cxoPoolQueue_grant(cxoSessionPool *pool);
+void cxoPoolQueue_leave(cxoSessionPool *pool);
+cxoPoolQueue *cxoPoolQueue_new(PyObject *reservations);
+
+void cxoPoolWarmer_free(cxoPoolWarmer *warmer);
+uint32_t cxoPoolWarmer_getHealthCheckInterval(cxoPoolWarmer *warmer);
+void cxoPoolWarmer_getHealthStats(cxoPoolWarmer *warmer,
+        uint64_t *numHealthChecks, uint64_t *numSessionsEvicted);
+int cxoPoolWarmer_getSessionStats(cxoPoolWarmer *warmer,
+        uint64_t *numSessionsOpened, uint64_t *numSessionsEvicted,
+        uint32_t *openCount);
+uint32_t cxoPoolWarmer_getSpare(cxoPoolWarmer *warmer);
+cxoPoolWarmer *cxoPoolWarmer_new(cxoSessionPool *pool, int prewarm,
+        uint32_t spare, uint32_t healthCheckInterval);
+void cxoPoolWarmer_setHealthCheckInterval(cxoPoolWarmer *warmer,
+        uint32_t healthCheckInterval);
+void cxoPoolWarmer_setStats(cxoPoolWarmer *warmer, uint64_t numHealthChecks,
+        uint64_t numSessionsOpened, uint64_t numSessionsEvicted);
+void cxoPoolWarmer_setLimits(cxoPoolWarmer *warmer, uint32_t minSessions,
+        uint32_t maxSessions, uint32_t sessionIncrement);
+void cxoPoolWarmer_setSpare(cxoPoolWarmer *warmer, uint32_t spare);
+
+int cxoSessionPool_cacheConnection(cxoSessionPool *pool, cxoConnection *conn);
+void cxoSessionPool_detachConnection(cxoConnection *conn);
+void cxoSessionPool_recordAcquire(cxoSessionPool *pool, uint64_t startTime,
+        int32_t errorCode);
+void cxoSessionPool_recordNewSession(cxoSessionPool *pool);
+
+int cxoSessionState_apply(cxoConnection *conn, cxoSessionPool *pool,
+        PyObject *tag);
+PyObject *cxoSessionState_getTag(cxoSessionPool *pool, PyObject *state);
+
 cxoSodaCollection *cxoSodaCollection_new(cxoSodaDatabase *db,
         dpiSodaColl *handle);
 
@@ -542,8 +767,16 @@ cxoSodaDocCursor *cxoSodaDocCursor_new(cxoSodaDatabase *db,
 
 cxoSodaOperation *cxoSodaOperation_new(cxoSodaCollection *collection);
 
+void cxoStats_add(cxoStats *stats, const cxoStats *delta);
+PyObject *cxoStats_toDict(const cxoStats *stats);
+
 void cxoSubscr_callback(cxoSubscr *subscr, dpiSubscrMessage *message);
 
+int cxoTrace_flush(void);
+void cxoTrace_record(cxoTraceOp op, PyObject *statement, PyObject *tag,
+        uint64_t startTime, uint64_t numRows);
+int cxoTrace_setHook(PyObject *hook, Py_ssize_t batchSize);
+
 PyObject *cxoTransform_dateFromTicks(PyObject *args);
 int cxoTransform_fromPython(cxoTransformNum transformNum,
         dpiNativeTypeNum *nativeTypeNum, PyObject *pyValue,
@@ -566,19 +799,37 @@ PyObject *cxoTransform_toPython(cxoTransformNum transformNum,
         cxoConnection *connection, cxoObjectType *objType,
         dpiDataBuffer *dbValue, const char *encodingErrors);
 
+void cxoUtils_closeFile(int fd, int closeFd);
 PyObject *cxoUtils_convertOciAttrToPythonValue(unsigned attrType,
         dpiDataBuffer *value, uint32_t valueLength, const char *encoding);
 int cxoUtils_convertPythonValueToOciAttr(PyObject *value, unsigned attrType,
         cxoBuffer *buffer, dpiDataBuffer *ociBuffer, void **ociValue,
         uint32_t *ociValueLength, const char *encoding);
+uint32_t cxoUtils_crc32c(uint32_t crc, const char *data, size_t length);
+int cxoUtils_createFile(const void *path);
+void cxoUtils_detachThread(cxoThread thread);
+void *cxoUtils_encodePath(PyObject *pathObj);
 PyObject *cxoUtils_formatString(const char *format, PyObject *args);
 const char *cxoUtils_getAdjustedEncoding(const char *encoding);
+int64_t cxoUtils_getFilePosition(int fd);
+int64_t cxoUtils_getFileSize(int fd);
 int cxoUtils_getModuleAndName(PyTypeObject *type, PyObject **module,
         PyObject **name);
+uint64_t cxoUtils_getMonotonicTime(void);
 int cxoUtils_initializeDPI(dpiContextCreateParams *params);
+void cxoUtils_joinThread(cxoThread thread);
+int cxoUtils_openFile(PyObject *fileObj, int forWriting, int *fd,
+        int *closeFd);
 int cxoUtils_processJsonArg(PyObject *arg, cxoBuffer *buffer);
 int cxoUtils_processSodaDocArg(cxoSodaDatabase *db, PyObject *arg,
         dpiSodaDoc **handle);
+int64_t cxoUtils_readFile(int fd, char *buffer, size_t size,
+        int64_t position);
+void cxoUtils_setFilePosition(int fd, int64_t position);
+void cxoUtils_sleep(uint32_t milliseconds);
+int cxoUtils_startThread(cxoThread *thread, void (*func)(void*), void *arg);
+int cxoUtils_writeFile(int fd, const char *buffer, size_t size,
+        int64_t position);
 
 int cxoVar_bind(cxoVar *var, cxoCursor *cursor, PyObject *name, uint32_t pos);
 int cxoVar_check(PyObject *object);
@@ -592,3 +843,6 @@ cxoVar *cxoVar_newByType(cxoCursor *cursor, PyObject *value,
 cxoVar *cxoVar_newByValue(cxoCursor *cursor, PyObject *value,
         Py_ssize_t numElements);
 int cxoVar_setValue(cxoVar *var, uint32_t arrayPos, PyObject *value);
+int cxoVar_setValueLob(cxoVar *var, uint32_t arrayPos, cxoBuffer *buffer);
+
+#endif
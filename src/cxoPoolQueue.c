@@ -0,0 +1,342 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2021, Oracle and/or its affiliates. All rights reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// cxoPoolQueue.c
+//   Defines routines for the queue placed in front of a session pool so that
+// callers waiting for a session are served in order of priority (and in the
+// order in which they arrived within each priority) instead of the arbitrary
+// order used by the pool itself. A number of sessions may also be reserved
+// for callers with a priority higher than a given priority. The state of the
+// queue is protected by the GIL; each waiter blocks on its own lock with the
+// GIL released until a session is granted to it.
+//-----------------------------------------------------------------------------
+
+#include "cxoModule.h"
+
+//-----------------------------------------------------------------------------
+// structure used for sessions reserved for callers of higher priority
+//-----------------------------------------------------------------------------
+typedef struct {
+    int32_t priority;
+    uint32_t numSessions;
+} cxoPoolQueueReservation;
+
+//-----------------------------------------------------------------------------
+// structure used for each caller waiting in the queue; these are allocated on
+// the stack of the waiting caller
+//-----------------------------------------------------------------------------
+typedef struct cxoPoolQueueWaiter {
+    struct cxoPoolQueueWaiter *next;
+    PyThread_type_lock lock;
+    int32_t priority;
+    int granted;
+} cxoPoolQueueWaiter;
+
+//-----------------------------------------------------------------------------
+// structure used for managing the queue
+//-----------------------------------------------------------------------------
+struct cxoPoolQueue {
+    cxoPoolQueueReservation *reservations;
+    uint32_t numReservations;
+    cxoPoolQueueWaiter *waiters;
+    uint32_t numWaiters;
+    uint32_t numLeased;
+    uint64_t numWaits;
+    uint64_t numTimeouts;
+    int closed;
+};
+
+
+//-----------------------------------------------------------------------------
+// cxoPoolQueue_getLimit()
+//   Return the number of sessions that may be leased to callers of the given
+// priority. A reservation keyed by a priority holds its sessions back for
+// callers of a higher priority, so the sessions of every reservation keyed by
+// the caller's priority or above are excluded.
+//-----------------------------------------------------------------------------
+static uint32_t cxoPoolQueue_getLimit(cxoSessionPool *pool, int32_t priority)
+{
+    cxoPoolQueue *queue = pool->queue;
+    uint32_t i, numReserved;
+
+    numReserved = 0;
+    for (i = 0; i < queue->numReservations; i++) {
+        if (queue->reservations[i].priority >= priority)
+            numReserved += queue->reservations[i].numSessions;
+    }
+    if (numReserved >= pool->maxSessions)
+        return 0;
+    return pool->maxSessions - numReserved;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoPoolQueue_close()
+//   Mark the queue as closed and grant sessions to all waiters so that they
+// receive the error raised by the closed pool instead of waiting forever.
+//-----------------------------------------------------------------------------
+void cxoPoolQueue_close(cxoSessionPool *pool)
+{
+    pool->queue->closed = 1;
+    cxoPoolQueue_grant(pool);
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoPoolQueue_enter()
+//   Lease a session to the caller, waiting in the queue if the limit for the
+// caller's priority has been reached or callers ahead of it are already
+// waiting. The pool's get mode and wait timeout determine how long to wait.
+//-----------------------------------------------------------------------------
+int cxoPoolQueue_enter(cxoSessionPool *pool, int32_t priority)
+{
+    cxoPoolQueueWaiter waiter, **link;
+    cxoPoolQueue *queue = pool->queue;
+    uint32_t waitTimeout = 0;
+    PY_TIMEOUT_T timeout;
+    dpiPoolGetMode mode;
+    PyLockStatus status;
+    char message[100];
+
+    // if no one is waiting and a session is available, lease it immediately
+    if (queue->closed || (!queue->waiters &&
+            queue->numLeased < cxoPoolQueue_getLimit(pool, priority))) {
+        queue->numLeased++;
+        return 0;
+    }
+
+    // determine how long to wait; sessions are always leased when the pool
+    // is allowed to exceed its maximum and never waited for if the pool does
+    // not wait at all
+    if (dpiPool_getGetMode(pool->handle, &mode) < 0)
+        return cxoError_raiseAndReturnInt();
+    if (mode == DPI_MODE_POOL_GET_FORCEGET) {
+        queue->numLeased++;
+        return 0;
+    }
+    timeout = -1;
+    if (mode == DPI_MODE_POOL_GET_NOWAIT) {
+        timeout = 0;
+    } else if (mode == DPI_MODE_POOL_GET_TIMEDWAIT) {
+        if (dpiPool_getWaitTimeout(pool->handle, &waitTimeout) < 0)
+            return cxoError_raiseAndReturnInt();
+        timeout = (PY_TIMEOUT_T) waitTimeout * 1000;
+    }
+
+    // add the waiter to the queue after all waiters of the same or higher
+    // priority
+    if (timeout != 0) {
+        waiter.lock = PyThread_allocate_lock();
+        if (!waiter.lock) {
+            PyErr_NoMemory();
+            return -1;
+        }
+        PyThread_acquire_lock(waiter.lock, WAIT_LOCK);
+        waiter.priority = priority;
+        waiter.granted = 0;
+        link = &queue->waiters;
+        while (*link && (*link)->priority >= priority)
+            link = &(*link)->next;
+        waiter.next = *link;
+        *link = &waiter;
+        queue->numWaiters++;
+        queue->numWaits++;
+
+        // wait for a session to be granted
+        Py_BEGIN_ALLOW_THREADS
+        status = PyThread_acquire_lock_timed(waiter.lock, timeout, 0);
+        Py_END_ALLOW_THREADS
+        if (status == PY_LOCK_ACQUIRED)
+            PyThread_release_lock(waiter.lock);
+        PyThread_free_lock(waiter.lock);
+        if (waiter.granted)
+            return 0;
+
+        // the wait timed out; remove the waiter from the queue and let any
+        // waiters behind it proceed if they are able to
+        link = &queue->waiters;
+        while (*link != &waiter)
+            link = &(*link)->next;
+        *link = waiter.next;
+        queue->numWaiters--;
+        cxoPoolQueue_grant(pool);
+    }
+
+    queue->numTimeouts++;
+    snprintf(message, sizeof(message),
+            "no session of priority %d available within the wait timeout",
+            (int) priority);
+    cxoError_raiseFromString(cxoDatabaseErrorException, message);
+    return -1;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoPoolQueue_free()
+//   Free the memory associated with the queue. No callers can be waiting
+// since each of them holds a reference to the pool.
+//-----------------------------------------------------------------------------
+void cxoPoolQueue_free(cxoPoolQueue *queue)
+{
+    if (queue->reservations)
+        PyMem_Free(queue->reservations);
+    PyMem_Free(queue);
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoPoolQueue_getReservations()
+//   Return a dictionary mapping each priority to the number of sessions
+// reserved for callers of higher priority.
+//-----------------------------------------------------------------------------
+PyObject *cxoPoolQueue_getReservations(cxoPoolQueue *queue)
+{
+    PyObject *dict, *key, *value;
+    uint32_t i;
+    int status;
+
+    dict = PyDict_New();
+    if (!dict)
+        return NULL;
+    for (i = 0; i < queue->numReservations; i++) {
+        key = PyLong_FromLong(queue->reservations[i].priority);
+        if (!key) {
+            Py_DECREF(dict);
+            return NULL;
+        }
+        value = PyLong_FromUnsignedLong(queue->reservations[i].numSessions);
+        if (!value) {
+            Py_DECREF(key);
+            Py_DECREF(dict);
+            return NULL;
+        }
+        status = PyDict_SetItem(dict, key, value);
+        Py_DECREF(key);
+        Py_DECREF(value);
+        if (status < 0) {
+            Py_DECREF(dict);
+            return NULL;
+        }
+    }
+
+    return dict;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoPoolQueue_getStats()
+//   Return the number of callers currently waiting, the number of callers
+// that have had to wait and the number of callers whose wait timed out.
+//-----------------------------------------------------------------------------
+void cxoPoolQueue_getStats(cxoPoolQueue *queue, uint32_t *numWaiters,
+        uint64_t *numWaits, uint64_t *numTimeouts)
+{
+    *numWaiters = queue->numWaiters;
+    *numWaits = queue->numWaits;
+    *numTimeouts = queue->numTimeouts;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoPoolQueue_grant()
+//   Grant sessions to the waiters at the head of the queue for as long as
+// the limit for their priority has not been reached. This is called whenever
+// a session is returned or the maximum number of sessions changes.
+//-----------------------------------------------------------------------------
+void cxoPoolQueue_grant(cxoSessionPool *pool)
+{
+    cxoPoolQueue *queue = pool->queue;
+    cxoPoolQueueWaiter *waiter;
+
+    while (queue->waiters) {
+        waiter = queue->waiters;
+        if (!queue->closed && queue->numLeased >=
+                cxoPoolQueue_getLimit(pool, waiter->priority))
+            break;
+        queue->waiters = waiter->next;
+        queue->numWaiters--;
+        queue->numLeased++;
+        waiter->granted = 1;
+        PyThread_release_lock(waiter->lock);
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoPoolQueue_leave()
+//   Return the session leased to a caller and grant it to the next waiter,
+// if applicable.
+//-----------------------------------------------------------------------------
+void cxoPoolQueue_leave(cxoSessionPool *pool)
+{
+    if (pool->queue->numLeased > 0)
+        pool->queue->numLeased--;
+    cxoPoolQueue_grant(pool);
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoPoolQueue_new()
+//   Create a new queue. The reservations, if specified, are expected to be a
+// dictionary mapping a priority to the number of sessions that callers of
+// that priority or lower may not use.
+//-----------------------------------------------------------------------------
+cxoPoolQueue *cxoPoolQueue_new(PyObject *reservations)
+{
+    PyObject *key, *value;
+    cxoPoolQueue *queue;
+    Py_ssize_t pos;
+    long priority;
+
+    // allocate the queue
+    queue = PyMem_Malloc(sizeof(cxoPoolQueue));
+    if (!queue) {
+        PyErr_NoMemory();
+        return NULL;
+    }
+    memset(queue, 0, sizeof(cxoPoolQueue));
+    if (!reservations || reservations == Py_None)
+        return queue;
+
+    // populate the reservations
+    if (!PyDict_Check(reservations)) {
+        PyErr_SetString(PyExc_TypeError, "reservations must be a dictionary");
+        cxoPoolQueue_free(queue);
+        return NULL;
+    }
+    if (PyDict_Size(reservations) > 0) {
+        queue->reservations = PyMem_Malloc(PyDict_Size(reservations) *
+                sizeof(cxoPoolQueueReservation));
+        if (!queue->reservations) {
+            PyErr_NoMemory();
+            cxoPoolQueue_free(queue);
+            return NULL;
+        }
+    }
+    pos = 0;
+    while (PyDict_Next(reservations, &pos, &key, &value)) {
+        if (!PyLong_Check(key) || !PyLong_Check(value)) {
+            PyErr_SetString(PyExc_TypeError,
+                    "reservations must map integer priorities to integers");
+            cxoPoolQueue_free(queue);
+            return NULL;
+        }
+        priority = PyLong_AsLong(key);
+        if (!PyErr_Occurred() && (priority < INT32_MIN ||
+                priority > INT32_MAX))
+            PyErr_SetString(PyExc_OverflowError, "priority out of range");
+        queue->reservations[queue->numReservations].priority =
+                (int32_t) priority;
+        queue->reservations[queue->numReservations].numSessions =
+                (uint32_t) PyLong_AsUnsignedLong(value);
+        if (PyErr_Occurred()) {
+            cxoPoolQueue_free(queue);
+            return NULL;
+        }
+        queue->numReservations++;
+    }
+
+    return queue;
+}
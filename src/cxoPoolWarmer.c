@@ -0,0 +1,566 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2021, Oracle and/or its affiliates. All rights reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// cxoPoolWarmer.c
+//   Defines routines for maintaining the sessions in a session pool on native
+// background threads. Sessions are opened in parallel up to the minimum
+// number of sessions when the pool is created and are then replenished so
+// that a number of spare (idle) sessions remain available as sessions are
+// acquired. Idle sessions may also be checked periodically so that dead
+// sessions are dropped before they are handed out. Sessions are only acquired
+// when the pool appears able to supply them without waiting; as the
+// application may acquire sessions at the same time, a thread may still end
+// up waiting on the pool, so the closing of the pool waits only a limited
+// time for the background thread to stop. As sessions are acquired without
+// credentials, only homogeneous pools are supported. The threads never make
+// use of the Python interpreter.
+//-----------------------------------------------------------------------------
+
+#include "cxoModule.h"
+
+// maximum number of sessions that are opened in parallel
+#define CXO_POOL_WARMER_MAX_THREADS         16
+
+// number of milliseconds between checks of the number of idle sessions
+#define CXO_POOL_WARMER_POLL_INTERVAL       100
+
+// number of milliseconds to wait for a response when checking a session
+#define CXO_POOL_WARMER_PING_TIMEOUT        5000
+
+// maximum number of idle sessions that are checked at the same time
+#define CXO_POOL_WARMER_CHECK_BATCH_SIZE    4
+
+// number of milliseconds to wait for the background thread to stop
+#define CXO_POOL_WARMER_STOP_TIMEOUT        5000
+
+// number of milliseconds between checks of whether the thread has stopped
+#define CXO_POOL_WARMER_STOP_POLL_INTERVAL  10
+
+//-----------------------------------------------------------------------------
+// structure used for managing the background thread; if the thread does not
+// stop in time when the pool is closed it is detached and the structure is
+// then freed by the thread itself, so it is not allocated by Python
+//-----------------------------------------------------------------------------
+struct cxoPoolWarmer {
+    dpiPool *handle;
+    volatile uint32_t minSessions;
+    volatile uint32_t maxSessions;
+    volatile uint32_t sessionIncrement;
+    volatile uint32_t spare;
+    volatile uint32_t healthCheckInterval;
+    volatile uint64_t numHealthChecks;
+    volatile uint64_t numSessionsEvicted;
+    volatile int stop;
+    uint64_t numSessionsOpened;
+    uint32_t numPendingChanges;
+    int prewarm;
+    int finished;
+    int detached;
+    PyThread_type_lock lock;
+    cxoThread thread;
+};
+
+//-----------------------------------------------------------------------------
+// structure used for passing state to the helper threads opening sessions
+//-----------------------------------------------------------------------------
+typedef struct {
+    cxoPoolWarmer *warmer;
+    cxoThread thread;
+    dpiConn *conn;
+    int started;
+    int check;
+    int isHealthy;
+    int isNew;
+} cxoPoolWarmerSession;
+
+
+//-----------------------------------------------------------------------------
+// cxoPoolWarmer_beginChange()
+//   Note that the number of open sessions in the pool may be about to change
+// because of the background thread. Until the change has been counted, the
+// number of open sessions is not consistent with the counts of sessions
+// opened and evicted by the thread.
+//-----------------------------------------------------------------------------
+static void cxoPoolWarmer_beginChange(cxoPoolWarmer *warmer)
+{
+    PyThread_acquire_lock(warmer->lock, WAIT_LOCK);
+    warmer->numPendingChanges++;
+    PyThread_release_lock(warmer->lock);
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoPoolWarmer_endChange()
+//   Count the sessions opened or evicted by a change that has completed.
+//-----------------------------------------------------------------------------
+static void cxoPoolWarmer_endChange(cxoPoolWarmer *warmer,
+        uint32_t numOpened, uint32_t numEvicted)
+{
+    PyThread_acquire_lock(warmer->lock, WAIT_LOCK);
+    warmer->numPendingChanges--;
+    warmer->numSessionsOpened += numOpened;
+    warmer->numSessionsEvicted += numEvicted;
+    PyThread_release_lock(warmer->lock);
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoPoolWarmer_openSession()
+//   Acquire a session from the pool on a helper thread. The connection is
+// left NULL if the session could not be acquired. Unless the session is to be
+// checked, a new session is requested. If requested, the session is checked
+// with a round trip to the database, limited by a call timeout where the
+// client supports one, so that a session silently dropped by a firewall does
+// not block the thread until the network times out.
+//-----------------------------------------------------------------------------
+static void cxoPoolWarmer_openSession(void *arg)
+{
+    cxoPoolWarmerSession *session = (cxoPoolWarmerSession*) arg;
+    dpiConnCreateParams params;
+
+    session->isHealthy = 1;
+    session->isNew = 0;
+    if (dpiContext_initConnCreateParams(cxoDpiContext, &params) < 0) {
+        session->conn = NULL;
+        return;
+    }
+    if (!session->check)
+        params.purity = DPI_PURITY_NEW;
+    cxoPoolWarmer_beginChange(session->warmer);
+    if (dpiPool_acquireConnection(session->warmer->handle, NULL, 0, NULL, 0,
+            &params, &session->conn) < 0) {
+        cxoPoolWarmer_endChange(session->warmer, 0, 0);
+        session->conn = NULL;
+        return;
+    }
+    session->isNew = params.outNewSession;
+    cxoPoolWarmer_endChange(session->warmer, (session->isNew) ? 1 : 0, 0);
+    if (session->check) {
+        dpiConn_setCallTimeout(session->conn, CXO_POOL_WARMER_PING_TIMEOUT);
+        session->isHealthy = (dpiConn_ping(session->conn) == DPI_SUCCESS);
+        if (session->isHealthy)
+            dpiConn_setCallTimeout(session->conn, 0);
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoPoolWarmer_getAvailable()
+//   Return the number of sessions that can be acquired from the pool without
+// waiting: the number of idle sessions when they are to be checked and the
+// number of sessions that can still be created otherwise. This takes the
+// place of a no-wait acquire, which cannot be requested for a single call;
+// since the application may acquire sessions after this check, it does not
+// guarantee that the acquire will not wait.
+//-----------------------------------------------------------------------------
+static uint32_t cxoPoolWarmer_getAvailable(cxoPoolWarmer *warmer, int check)
+{
+    uint32_t openCount, busyCount;
+
+    if (dpiPool_getOpenCount(warmer->handle, &openCount) < 0 ||
+            dpiPool_getBusyCount(warmer->handle, &busyCount) < 0)
+        return 0;
+    if (check)
+        return (openCount > busyCount) ? openCount - busyCount : 0;
+    return (warmer->maxSessions > openCount) ?
+            warmer->maxSessions - openCount : 0;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoPoolWarmer_fill()
+//   Open the specified number of new sessions in parallel or, if requested,
+// check the specified number of idle sessions in parallel, dropping those
+// that fail the check. Each session is held until all of the sessions in the
+// batch have been acquired so that the pool cannot hand out the same session
+// twice; the sessions are then returned to the pool. An idle session handed
+// out when a new one was requested is held until all of the sessions have
+// been opened. No more sessions are acquired in each batch than the pool
+// appears able to supply without waiting. Returns the number of sessions that
+// were opened or checked.
+//-----------------------------------------------------------------------------
+static uint32_t cxoPoolWarmer_fill(cxoPoolWarmer *warmer,
+        uint32_t numSessions, int check)
+{
+    cxoPoolWarmerSession sessions[CXO_POOL_WARMER_MAX_THREADS];
+    uint32_t i, numThreads, numBatchAcquired, numBatchDone, numHeld = 0;
+    uint32_t numDone = 0;
+    dpiConn *heldConns[CXO_POOL_WARMER_MAX_THREADS];
+
+    while (numSessions > 0 && !warmer->stop &&
+            numHeld < CXO_POOL_WARMER_MAX_THREADS) {
+
+        // start one thread for each session in the batch
+        numThreads = (numSessions < CXO_POOL_WARMER_MAX_THREADS) ?
+                numSessions : CXO_POOL_WARMER_MAX_THREADS;
+        i = cxoPoolWarmer_getAvailable(warmer, check);
+        if (i < numThreads)
+            numThreads = i;
+        if (numThreads == 0)
+            break;
+        for (i = 0; i < numThreads; i++) {
+            sessions[i].warmer = warmer;
+            sessions[i].conn = NULL;
+            sessions[i].check = check;
+            sessions[i].started = (cxoUtils_startThread(&sessions[i].thread,
+                    cxoPoolWarmer_openSession, &sessions[i]) == 0);
+        }
+
+        // wait for the threads to complete, then return the sessions
+        numBatchAcquired = numBatchDone = 0;
+        for (i = 0; i < numThreads; i++) {
+            if (sessions[i].started)
+                cxoUtils_joinThread(sessions[i].thread);
+        }
+        for (i = 0; i < numThreads; i++) {
+            if (!sessions[i].conn)
+                continue;
+            numBatchAcquired++;
+            if (!check && !sessions[i].isNew &&
+                    numHeld < CXO_POOL_WARMER_MAX_THREADS) {
+                heldConns[numHeld++] = sessions[i].conn;
+                continue;
+            }
+            if (sessions[i].isHealthy) {
+                dpiConn_close(sessions[i].conn, DPI_MODE_CONN_CLOSE_DEFAULT,
+                        NULL, 0);
+            } else {
+                cxoPoolWarmer_beginChange(warmer);
+                dpiConn_close(sessions[i].conn, DPI_MODE_CONN_CLOSE_DROP,
+                        NULL, 0);
+                cxoPoolWarmer_endChange(warmer, 0, 1);
+            }
+            dpiConn_release(sessions[i].conn);
+            if (check || sessions[i].isNew)
+                numBatchDone++;
+        }
+        numDone += numBatchDone;
+
+        // stop if no session could be acquired in order to avoid flooding
+        // the database with connection requests while it is unavailable
+        if (numBatchAcquired == 0)
+            break;
+        numSessions -= numBatchDone;
+    }
+
+    // return any idle sessions that were held
+    for (i = 0; i < numHeld; i++) {
+        dpiConn_close(heldConns[i], DPI_MODE_CONN_CLOSE_DEFAULT, NULL, 0);
+        dpiConn_release(heldConns[i]);
+    }
+
+    return numDone;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoPoolWarmer_replenish()
+//   Open sessions if the number of idle sessions in the pool has dropped below
+// the number of spare sessions requested, without exceeding the maximum
+// number of sessions permitted in the pool. Only the shortfall is acquired;
+// new sessions are requested so that the idle sessions remain available to
+// the application.
+//-----------------------------------------------------------------------------
+static void cxoPoolWarmer_replenish(cxoPoolWarmer *warmer)
+{
+    uint32_t openCount, busyCount, idleCount, numSessions, spare;
+
+    spare = warmer->spare;
+    if (spare == 0 ||
+            dpiPool_getOpenCount(warmer->handle, &openCount) < 0 ||
+            dpiPool_getBusyCount(warmer->handle, &busyCount) < 0)
+        return;
+    idleCount = (openCount > busyCount) ? openCount - busyCount : 0;
+    if (idleCount >= spare || openCount >= warmer->maxSessions)
+        return;
+    numSessions = spare - idleCount;
+    if (numSessions > warmer->maxSessions - openCount)
+        numSessions = warmer->maxSessions - openCount;
+    cxoPoolWarmer_fill(warmer, numSessions, 0);
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoPoolWarmer_checkHealth()
+//   Check the idle sessions in the pool in small batches, dropping those that
+// fail the check. Only a few idle sessions are taken out of the pool at a time
+// and never more than are idle when the batch starts, so the application can
+// still acquire the remaining sessions without waiting. Releasing the healthy
+// sessions back to the pool resets the time they were last used, so the pool
+// does not check them again when they are acquired, provided the interval
+// between health checks is shorter than the ping interval of the pool. The
+// number of health checks is the number of sessions actually checked.
+//-----------------------------------------------------------------------------
+static void cxoPoolWarmer_checkHealth(cxoPoolWarmer *warmer)
+{
+    uint32_t numSessions, batchSize, numChecked;
+
+    numSessions = cxoPoolWarmer_getAvailable(warmer, 1);
+    while (numSessions > 0 && !warmer->stop) {
+        batchSize = (numSessions < CXO_POOL_WARMER_CHECK_BATCH_SIZE) ?
+                numSessions : CXO_POOL_WARMER_CHECK_BATCH_SIZE;
+        numChecked = cxoPoolWarmer_fill(warmer, batchSize, 1);
+        if (numChecked == 0)
+            break;
+        warmer->numHealthChecks += numChecked;
+        numSessions -= (numChecked < numSessions) ? numChecked : numSessions;
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoPoolWarmer_release()
+//   Release the resources held by the warmer. This may be called without
+// holding the GIL.
+//-----------------------------------------------------------------------------
+static void cxoPoolWarmer_release(cxoPoolWarmer *warmer)
+{
+    dpiPool_release(warmer->handle);
+    PyThread_free_lock(warmer->lock);
+    free(warmer);
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoPoolWarmer_run()
+//   Main routine of the background thread. If requested, the pool is first
+// filled up to the minimum number of sessions, after which the minimum is set
+// on the pool itself so that the sessions are maintained. The number of idle
+// sessions is then checked periodically until the thread is stopped. If the
+// thread was detached while stopping, it releases the warmer itself.
+//-----------------------------------------------------------------------------
+static void cxoPoolWarmer_run(void *arg)
+{
+    cxoPoolWarmer *warmer = (cxoPoolWarmer*) arg;
+    uint64_t now, lastHealthCheck;
+    int detached;
+
+    if (warmer->prewarm) {
+        cxoPoolWarmer_fill(warmer, warmer->minSessions, 0);
+        if (!warmer->stop) {
+            cxoPoolWarmer_beginChange(warmer);
+            dpiPool_reconfigure(warmer->handle, warmer->minSessions,
+                    warmer->maxSessions, warmer->sessionIncrement);
+            cxoPoolWarmer_endChange(warmer, 0, 0);
+        }
+    }
+    lastHealthCheck = cxoUtils_getMonotonicTime();
+    while (!warmer->stop) {
+        if (warmer->healthCheckInterval > 0) {
+            now = cxoUtils_getMonotonicTime();
+            if (now - lastHealthCheck >=
+                    (uint64_t) warmer->healthCheckInterval * 1000000000ULL) {
+                cxoPoolWarmer_checkHealth(warmer);
+                lastHealthCheck = cxoUtils_getMonotonicTime();
+            }
+        }
+        cxoPoolWarmer_replenish(warmer);
+        cxoUtils_sleep(CXO_POOL_WARMER_POLL_INTERVAL);
+    }
+    PyThread_acquire_lock(warmer->lock, WAIT_LOCK);
+    warmer->finished = 1;
+    detached = warmer->detached;
+    PyThread_release_lock(warmer->lock);
+    if (detached)
+        cxoPoolWarmer_release(warmer);
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoPoolWarmer_free()
+//   Stop the background thread and free the memory associated with it. The
+// GIL is released while waiting for the thread since it may be in the middle
+// of opening sessions. The thread may be waiting on the pool for a session
+// that only the application can release, so if it does not stop in time it is
+// detached and left to release the warmer itself once the wait ends (at the
+// latest, when the pool is closed).
+//-----------------------------------------------------------------------------
+void cxoPoolWarmer_free(cxoPoolWarmer *warmer)
+{
+    int finished, detached;
+    uint64_t deadline;
+    cxoThread thread;
+
+    warmer->stop = 1;
+    thread = warmer->thread;
+    Py_BEGIN_ALLOW_THREADS
+    deadline = cxoUtils_getMonotonicTime() +
+            (uint64_t) CXO_POOL_WARMER_STOP_TIMEOUT * 1000000ULL;
+    while (1) {
+        PyThread_acquire_lock(warmer->lock, WAIT_LOCK);
+        finished = warmer->finished;
+        detached = (!finished && cxoUtils_getMonotonicTime() >= deadline);
+        warmer->detached = detached;
+        PyThread_release_lock(warmer->lock);
+        if (finished || detached)
+            break;
+        cxoUtils_sleep(CXO_POOL_WARMER_STOP_POLL_INTERVAL);
+    }
+    if (finished) {
+        cxoUtils_joinThread(thread);
+        cxoPoolWarmer_release(warmer);
+    } else {
+        cxoUtils_detachThread(thread);
+    }
+    Py_END_ALLOW_THREADS
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoPoolWarmer_new()
+//   Start a background thread for the pool. If the pool is to be pre-warmed
+// it is expected to have been created with no sessions. The health check
+// interval is in seconds; zero disables health checks.
+//-----------------------------------------------------------------------------
+cxoPoolWarmer *cxoPoolWarmer_new(cxoSessionPool *pool, int prewarm,
+        uint32_t spare, uint32_t healthCheckInterval)
+{
+    cxoPoolWarmer *warmer;
+
+    warmer = malloc(sizeof(cxoPoolWarmer));
+    if (!warmer) {
+        PyErr_NoMemory();
+        return NULL;
+    }
+    warmer->lock = PyThread_allocate_lock();
+    if (!warmer->lock) {
+        free(warmer);
+        PyErr_NoMemory();
+        return NULL;
+    }
+    warmer->handle = pool->handle;
+    warmer->minSessions = pool->minSessions;
+    warmer->maxSessions = pool->maxSessions;
+    warmer->sessionIncrement = pool->sessionIncrement;
+    warmer->spare = spare;
+    warmer->healthCheckInterval = healthCheckInterval;
+    warmer->numHealthChecks = 0;
+    warmer->numSessionsEvicted = 0;
+    warmer->numSessionsOpened = 0;
+    warmer->numPendingChanges = 0;
+    warmer->stop = 0;
+    warmer->prewarm = prewarm;
+    warmer->finished = 0;
+    warmer->detached = 0;
+    if (dpiPool_addRef(warmer->handle) < 0) {
+        PyThread_free_lock(warmer->lock);
+        free(warmer);
+        return (cxoPoolWarmer*) cxoError_raiseAndReturnNull();
+    }
+    if (cxoUtils_startThread(&warmer->thread, cxoPoolWarmer_run,
+            warmer) < 0) {
+        cxoPoolWarmer_release(warmer);
+        cxoError_raiseFromString(cxoOperationalErrorException,
+                "unable to start thread for session pool");
+        return NULL;
+    }
+
+    return warmer;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoPoolWarmer_getHealthCheckInterval()
+//   Return the number of seconds between health checks of idle sessions.
+//-----------------------------------------------------------------------------
+uint32_t cxoPoolWarmer_getHealthCheckInterval(cxoPoolWarmer *warmer)
+{
+    return warmer->healthCheckInterval;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoPoolWarmer_getHealthStats()
+//   Return the number of idle sessions that have been checked and the number
+// of sessions that were dropped because they failed a health check.
+//-----------------------------------------------------------------------------
+void cxoPoolWarmer_getHealthStats(cxoPoolWarmer *warmer,
+        uint64_t *numHealthChecks, uint64_t *numSessionsEvicted)
+{
+    *numHealthChecks = warmer->numHealthChecks;
+    *numSessionsEvicted = warmer->numSessionsEvicted;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoPoolWarmer_getSessionStats()
+//   Return the number of sessions opened and evicted by the background thread
+// and the number of sessions open in the pool. If the thread is in the middle
+// of a change to the number of open sessions, or the number of open sessions
+// cannot be determined, 0 is returned since the number of open sessions may
+// not be consistent with the counts; otherwise, 1 is returned.
+//-----------------------------------------------------------------------------
+int cxoPoolWarmer_getSessionStats(cxoPoolWarmer *warmer,
+        uint64_t *numSessionsOpened, uint64_t *numSessionsEvicted,
+        uint32_t *openCount)
+{
+    int isConsistent;
+
+    PyThread_acquire_lock(warmer->lock, WAIT_LOCK);
+    *numSessionsOpened = warmer->numSessionsOpened;
+    *numSessionsEvicted = warmer->numSessionsEvicted;
+    isConsistent = (warmer->numPendingChanges == 0 &&
+            dpiPool_getOpenCount(warmer->handle, openCount) == 0);
+    PyThread_release_lock(warmer->lock);
+    return isConsistent;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoPoolWarmer_getSpare()
+//   Return the number of spare sessions maintained by the background thread.
+//-----------------------------------------------------------------------------
+uint32_t cxoPoolWarmer_getSpare(cxoPoolWarmer *warmer)
+{
+    return warmer->spare;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoPoolWarmer_setHealthCheckInterval()
+//   Set the number of seconds between health checks of idle sessions.
+//-----------------------------------------------------------------------------
+void cxoPoolWarmer_setHealthCheckInterval(cxoPoolWarmer *warmer,
+        uint32_t healthCheckInterval)
+{
+    warmer->healthCheckInterval = healthCheckInterval;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoPoolWarmer_setStats()
+//   Set the statistics of the background thread, such as when it is
+// restarted after the pool could not be closed.
+//-----------------------------------------------------------------------------
+void cxoPoolWarmer_setStats(cxoPoolWarmer *warmer, uint64_t numHealthChecks,
+        uint64_t numSessionsOpened, uint64_t numSessionsEvicted)
+{
+    warmer->numHealthChecks = numHealthChecks;
+    warmer->numSessionsOpened = numSessionsOpened;
+    warmer->numSessionsEvicted = numSessionsEvicted;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoPoolWarmer_setLimits()
+//   Set the limits of the pool after it has been reconfigured.
+//-----------------------------------------------------------------------------
+void cxoPoolWarmer_setLimits(cxoPoolWarmer *warmer, uint32_t minSessions,
+        uint32_t maxSessions, uint32_t sessionIncrement)
+{
+    warmer->minSessions = minSessions;
+    warmer->maxSessions = maxSessions;
+    warmer->sessionIncrement = sessionIncrement;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoPoolWarmer_setSpare()
+//   Set the number of spare sessions maintained by the background thread.
+//-----------------------------------------------------------------------------
+void cxoPoolWarmer_setSpare(cxoPoolWarmer *warmer, uint32_t spare)
+{
+    warmer->spare = spare;
+}
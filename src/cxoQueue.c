@@ -102,13 +102,14 @@ static PyObject *cxoQueue_repr(cxoQueue *queue)
 int cxoQueue_deqHelper(cxoQueue *queue, uint32_t *numProps,
         cxoMsgProps **props)
 {
+    int ok, status, isTraced;
     uint32_t bufferLength, i, j;
+    uint64_t startTime = 0;
     dpiMsgProps **handles;
     dpiObject *objHandle;
     const char *buffer;
     cxoMsgProps *temp;
     cxoObject *obj;
-    int ok, status;
 
     // use the same array to store the intermediate values provided by ODPI-C;
     // by doing so there is no need to allocate an additional array and any
@@ -116,11 +117,19 @@ int cxoQueue_deqHelper(cxoQueue *queue, uint32_t *numProps,
     handles = (dpiMsgProps**) props;
 
     // perform dequeue
+    isTraced = cxoTrace_isEnabled();
+    if (isTraced)
+        startTime = cxoUtils_getMonotonicTime();
     Py_BEGIN_ALLOW_THREADS
     status = dpiQueue_deqMany(queue->handle, numProps, handles);
     Py_END_ALLOW_THREADS
     if (status < 0)
-        return cxoError_raiseAndReturnInt();
+        cxoError_raiseAndReturnInt();
+    if (isTraced)
+        cxoTrace_record(CXO_TRACE_OP_DEQUEUE, queue->name, NULL, startTime,
+                (status < 0) ? 0 : *numProps);
+    if (status < 0)
+        return -1;
 
     // create objects that are returned to the user
     for (i = 0; i < *numProps; i++) {
@@ -175,10 +184,11 @@ int cxoQueue_enqHelper(cxoQueue *queue, uint32_t numProps,
         cxoMsgProps **props)
 {
     dpiMsgProps **handles, *tempHandle;
+    uint64_t startTime = 0;
+    int status, isTraced;
     cxoBuffer buffer;
     cxoObject *obj;
     uint32_t i;
-    int status;
 
     // use the same array to store the intermediate values required by ODPI-C;
     // by doing so there is no need to allocate an additional array
@@ -217,11 +227,19 @@ int cxoQueue_enqHelper(cxoQueue *queue, uint32_t numProps,
     }
 
     // perform enqueue
+    isTraced = cxoTrace_isEnabled();
+    if (isTraced)
+        startTime = cxoUtils_getMonotonicTime();
     Py_BEGIN_ALLOW_THREADS
     status = dpiQueue_enqMany(queue->handle, numProps, handles);
     Py_END_ALLOW_THREADS
     if (status < 0)
-        return cxoError_raiseAndReturnInt();
+        cxoError_raiseAndReturnInt();
+    if (isTraced)
+        cxoTrace_record(CXO_TRACE_OP_ENQUEUE, queue->name, NULL, startTime,
+                (status < 0) ? 0 : numProps);
+    if (status < 0)
+        return -1;
 
     return 0;
 }
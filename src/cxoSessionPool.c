@@ -18,6 +18,22 @@
 int cxoSessionPool_reconfigureHelper(cxoSessionPool *pool,
         const char *attrName, PyObject *value);
 
+// OCI handle type and attribute used to determine if a transaction is in
+// progress on a session without a round trip to the database
+#define CXO_OCI_HTYPE_SESSION                   9
+#define CXO_OCI_ATTR_TRANSACTION_IN_PROGRESS    484
+
+// interval (in nanoseconds) between checks for sessions retained for threads
+// that have been idle for longer than the affinity timeout
+#define CXO_POOL_AFFINITY_SWEEP_INTERVAL        1000000000ULL
+
+// upper bounds (in nanoseconds) of the buckets in the acquire wait time
+// histogram; the last bucket has no upper bound
+static const uint64_t cxoSessionPoolWaitBuckets[] = {
+    100000ULL, 500000ULL, 1000000ULL, 5000000ULL, 10000000ULL, 50000000ULL,
+    100000000ULL, 500000000ULL, 1000000000ULL, 5000000000ULL, 10000000000ULL
+};
+
 
 //-----------------------------------------------------------------------------
 // cxoSessionPool_new()
@@ -30,6 +46,430 @@ static PyObject *cxoSessionPool_new(PyTypeObject *type, PyObject *args,
 }
 
 
+//-----------------------------------------------------------------------------
+// cxoSessionPool_adjustBusyCount()
+//   Adjust the number of sessions held by the application after a session has
+// been acquired or released. The busy time is the sum of the number of busy
+// sessions over time and is used to calculate the time-weighted average. No
+// calls are made to ODPI-C so this is cheap enough for every acquire and
+// release.
+//-----------------------------------------------------------------------------
+static void cxoSessionPool_adjustBusyCount(cxoSessionPool *pool, int delta)
+{
+    cxoPoolStats *stats = &pool->stats;
+    uint64_t now;
+
+    now = cxoUtils_getMonotonicTime();
+    stats->busyTime += (now - stats->lastUpdateTime) * stats->busyCount;
+    stats->lastUpdateTime = now;
+    if (delta < 0 && stats->busyCount < (uint32_t) -delta)
+        stats->busyCount = 0;
+    else stats->busyCount += delta;
+    if (stats->busyCount > stats->busyHighWater)
+        stats->busyHighWater = stats->busyCount;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoSessionPool_syncOpenCount()
+//   Bring the number of open sessions up to date with the number reported by
+// the pool. Sessions created by acquires and destroyed by drop() are counted
+// as they happen, as are the sessions opened and evicted by the background
+// thread; any remaining difference is due to sessions opened or closed by the
+// pool itself (such as the additional sessions of an increment or sessions
+// closed after being idle for the timeout) and is counted as sessions created
+// or destroyed, respectively.
+//-----------------------------------------------------------------------------
+static void cxoSessionPool_syncOpenCount(cxoSessionPool *pool)
+{
+    uint64_t numOpened, numEvicted, delta;
+    cxoPoolStats *stats = &pool->stats;
+    uint32_t openCount;
+    int isConsistent;
+
+    // count the sessions opened and evicted by the background thread; the
+    // number of open sessions is only compared with the counts if the thread
+    // is not in the middle of changing it
+    if (pool->warmer) {
+        isConsistent = cxoPoolWarmer_getSessionStats(pool->warmer, &numOpened,
+                &numEvicted, &openCount);
+        delta = numOpened - stats->numWarmerSessionsOpened;
+        stats->numSessionsCreated += delta;
+        stats->openCount += (uint32_t) delta;
+        delta = numEvicted - stats->numWarmerSessionsEvicted;
+        stats->numSessionsDestroyed += delta;
+        stats->openCount = (stats->openCount > delta) ?
+                stats->openCount - (uint32_t) delta : 0;
+        stats->numWarmerSessionsOpened = numOpened;
+        stats->numWarmerSessionsEvicted = numEvicted;
+        if (!isConsistent)
+            return;
+    } else if (!pool->handle ||
+            dpiPool_getOpenCount(pool->handle, &openCount) < 0) {
+        return;
+    }
+    if (openCount > stats->openCount)
+        stats->numSessionsCreated += openCount - stats->openCount;
+    else stats->numSessionsDestroyed += stats->openCount - openCount;
+    stats->openCount = openCount;
+    if (openCount > stats->openHighWater)
+        stats->openHighWater = openCount;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoSessionPool_updateStats()
+//   Bring the statistics that depend on the number of busy and open sessions
+// in the pool up to date. This is only done when the statistics are
+// requested, since it requires calls to ODPI-C. Sessions retained for thread
+// affinity are not considered busy.
+//-----------------------------------------------------------------------------
+static void cxoSessionPool_updateStats(cxoSessionPool *pool)
+{
+    cxoPoolStats *stats = &pool->stats;
+    uint32_t busyCount;
+
+    if (!pool->handle || dpiPool_getBusyCount(pool->handle, &busyCount) < 0)
+        return;
+    busyCount = (busyCount > pool->numAffinitySlots) ?
+            busyCount - pool->numAffinitySlots : 0;
+    cxoSessionPool_adjustBusyCount(pool,
+            (int) busyCount - (int) stats->busyCount);
+    cxoSessionPool_syncOpenCount(pool);
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoSessionPool_recordNewSession()
+//   Record that an acquire was given a newly created session. The number of
+// open sessions is brought up to date at the same time so that the high
+// water mark reflects the growth of the pool as it happens; this requires a
+// call to ODPI-C but creating the session was far more expensive.
+//-----------------------------------------------------------------------------
+void cxoSessionPool_recordNewSession(cxoSessionPool *pool)
+{
+    pool->stats.numSessionsCreated++;
+    pool->stats.openCount++;
+    cxoSessionPool_syncOpenCount(pool);
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoSessionPool_recordAcquire()
+//   Record an attempt to acquire a session from the pool which started at the
+// given time. The error code is zero if the attempt was successful.
+//-----------------------------------------------------------------------------
+void cxoSessionPool_recordAcquire(cxoSessionPool *pool, uint64_t startTime,
+        int32_t errorCode)
+{
+    cxoPoolStats *stats = &pool->stats;
+    uint64_t waitTime;
+    uint32_t i;
+
+    waitTime = cxoUtils_getMonotonicTime() - startTime;
+    stats->numAcquires++;
+    stats->totalWaitTime += waitTime;
+    if (waitTime > stats->maxWaitTime)
+        stats->maxWaitTime = waitTime;
+    for (i = 0; i < CXO_POOL_NUM_WAIT_BUCKETS - 1; i++) {
+        if (waitTime <= cxoSessionPoolWaitBuckets[i])
+            break;
+    }
+    stats->waitHistogram[i]++;
+    if (errorCode != 0) {
+        stats->numAcquireFailures++;
+        if (errorCode == 24457 || errorCode == 24459)
+            stats->numAcquireTimeouts++;
+    } else cxoSessionPool_adjustBusyCount(pool, 1);
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoSessionPool_releaseHandle()
+//   Release a session retained for a thread back to the pool. Errors are
+// ignored since there is nothing the caller can do about them.
+//-----------------------------------------------------------------------------
+static void cxoSessionPool_releaseHandle(dpiConn *handle)
+{
+    Py_BEGIN_ALLOW_THREADS
+    dpiConn_close(handle, DPI_MODE_CONN_CLOSE_DEFAULT, NULL, 0);
+    dpiConn_release(handle);
+    Py_END_ALLOW_THREADS
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoSessionPool_reclaimAffinity()
+//   Release the sessions retained for threads that have been idle for longer
+// than the affinity timeout back to the pool, or all of them if requested.
+// Slots are removed before the GIL is released so the array may safely be
+// modified by other threads while each session is being released.
+//-----------------------------------------------------------------------------
+static void cxoSessionPool_reclaimAffinity(cxoSessionPool *pool, int all)
+{
+    cxoPoolAffinitySlot *slot;
+    uint64_t now, timeout;
+    dpiConn *handle;
+    uint32_t i;
+
+    now = cxoUtils_getMonotonicTime();
+    timeout = (uint64_t) pool->affinityTimeout * 1000000000ULL;
+    pool->nextAffinitySweep = now + CXO_POOL_AFFINITY_SWEEP_INTERVAL;
+    i = 0;
+    while (i < pool->numAffinitySlots) {
+        slot = &pool->affinitySlots[i];
+        if (!all && now - slot->releaseTime < timeout) {
+            i++;
+            continue;
+        }
+        handle = slot->handle;
+        *slot = pool->affinitySlots[--pool->numAffinitySlots];
+        cxoSessionPool_releaseHandle(handle);
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoSessionPool_popAffinity()
+//   Return the session retained for the calling thread, if one exists and has
+// not been idle for longer than the affinity timeout; otherwise, NULL is
+// returned. The shared pool is not consulted.
+//-----------------------------------------------------------------------------
+static dpiConn *cxoSessionPool_popAffinity(cxoSessionPool *pool)
+{
+    unsigned long threadId = PyThread_get_thread_ident();
+    cxoPoolAffinitySlot *slot;
+    uint64_t now, idleTime;
+    dpiConn *handle;
+    uint32_t i;
+
+    now = cxoUtils_getMonotonicTime();
+    if (now >= pool->nextAffinitySweep)
+        cxoSessionPool_reclaimAffinity(pool, 0);
+    for (i = 0; i < pool->numAffinitySlots; i++) {
+        slot = &pool->affinitySlots[i];
+        if (slot->threadId != threadId)
+            continue;
+        handle = slot->handle;
+        idleTime = now - slot->releaseTime;
+        *slot = pool->affinitySlots[--pool->numAffinitySlots];
+        if (idleTime < (uint64_t) pool->affinityTimeout * 1000000000ULL)
+            return handle;
+        cxoSessionPool_releaseHandle(handle);
+        break;
+    }
+    return NULL;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoSessionPool_makeRoom()
+//   Release the session retained for the thread that has been idle the
+// longest back to the pool if the pool has no idle sessions and cannot open
+// any more. This is called before a session is acquired from the pool so that
+// the caller does not wait for, or fail to get, a session while retained
+// sessions sit unused.
+//-----------------------------------------------------------------------------
+static void cxoSessionPool_makeRoom(cxoSessionPool *pool)
+{
+    uint32_t i, oldest, openCount, busyCount;
+    dpiConn *handle;
+
+    if (pool->numAffinitySlots == 0 ||
+            dpiPool_getOpenCount(pool->handle, &openCount) < 0 ||
+            dpiPool_getBusyCount(pool->handle, &busyCount) < 0 ||
+            openCount < pool->maxSessions || busyCount < openCount)
+        return;
+    oldest = 0;
+    for (i = 1; i < pool->numAffinitySlots; i++) {
+        if (pool->affinitySlots[i].releaseTime <
+                pool->affinitySlots[oldest].releaseTime)
+            oldest = i;
+    }
+    handle = pool->affinitySlots[oldest].handle;
+    pool->affinitySlots[oldest] =
+            pool->affinitySlots[--pool->numAffinitySlots];
+    cxoSessionPool_releaseHandle(handle);
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoSessionPool_threadExited()
+//   Called when the token placed in the thread-local storage of the pool by
+// cxoSessionPool_watchThread() is destroyed, which happens when the thread
+// exits or when the pool itself is freed. The session retained for the
+// thread, if any, is released back to the pool. The GIL is not released since
+// the thread is being torn down; releasing an untagged session without a
+// transaction in progress does not require a round trip.
+//-----------------------------------------------------------------------------
+static void cxoSessionPool_threadExited(PyObject *token)
+{
+    cxoSessionPool *pool;
+    unsigned long threadId;
+    dpiConn *handle;
+    uint32_t i;
+
+    pool = (cxoSessionPool*) PyCapsule_GetPointer(token, NULL);
+    threadId = (unsigned long) (uintptr_t) PyCapsule_GetContext(token);
+    if (!pool)
+        return;
+    for (i = 0; i < pool->numAffinitySlots; i++) {
+        if (pool->affinitySlots[i].threadId != threadId)
+            continue;
+        handle = pool->affinitySlots[i].handle;
+        pool->affinitySlots[i] =
+                pool->affinitySlots[--pool->numAffinitySlots];
+        dpiConn_close(handle, DPI_MODE_CONN_CLOSE_DEFAULT, NULL, 0);
+        dpiConn_release(handle);
+        break;
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoSessionPool_watchThread()
+//   Ensure that the session retained for the calling thread is released when
+// the thread exits. A token is placed in thread-local storage owned by the
+// pool the first time a session is retained for the thread; the token is
+// destroyed by Python when the thread exits. The token refers to the pool
+// without holding a reference since it cannot outlive the thread-local
+// storage, which is freed with the pool.
+//-----------------------------------------------------------------------------
+static int cxoSessionPool_watchThread(cxoSessionPool *pool,
+        unsigned long threadId)
+{
+    PyObject *module, *token;
+    int status;
+
+    // create the thread-local storage, if needed
+    if (!pool->affinityLocal) {
+        module = PyImport_ImportModule("_thread");
+        if (!module)
+            return -1;
+        pool->affinityLocal = PyObject_CallMethod(module, "_local", NULL);
+        Py_DECREF(module);
+        if (!pool->affinityLocal)
+            return -1;
+    }
+
+    // nothing to do if the thread is already being watched
+    token = PyObject_GetAttrString(pool->affinityLocal, "token");
+    if (token) {
+        Py_DECREF(token);
+        return 0;
+    }
+    if (!PyErr_ExceptionMatches(PyExc_AttributeError))
+        return -1;
+    PyErr_Clear();
+
+    // create the token and place it in thread-local storage
+    token = PyCapsule_New(pool, NULL, cxoSessionPool_threadExited);
+    if (!token)
+        return -1;
+    if (PyCapsule_SetContext(token, (void*) (uintptr_t) threadId) < 0) {
+        Py_DECREF(token);
+        return -1;
+    }
+    status = PyObject_SetAttrString(pool->affinityLocal, "token", token);
+    Py_DECREF(token);
+    return status;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoSessionPool_cacheConnection()
+//   Retain the session used by the connection for the calling thread instead
+// of releasing it back to the pool, if thread affinity is enabled, the
+// connection is open and was acquired from this pool, the connection is not
+// tagged and no session is already retained for the thread. Any transaction
+// in progress is rolled back first. Any cursors of the connection can no
+// longer be used but their statements remain open on the retained session
+// until they are closed or freed. Returns 1 if the session was retained, 0
+// if the connection should be released normally and -1 on error.
+//-----------------------------------------------------------------------------
+int cxoSessionPool_cacheConnection(cxoSessionPool *pool, cxoConnection *conn)
+{
+    unsigned long threadId = PyThread_get_thread_ident();
+    cxoPoolAffinitySlot *slot;
+    uint32_t i, valueLength;
+    dpiDataBuffer value;
+    int status;
+
+    // determine if the session can be retained
+    if (!pool->threadAffinity || pool->affinityTimeout == 0 ||
+            !pool->handle || !conn->handle || conn->sessionPool != pool ||
+            (conn->tag && conn->tag != Py_None))
+        return 0;
+    for (i = 0; i < pool->numAffinitySlots; i++) {
+        if (pool->affinitySlots[i].threadId == threadId)
+            return 0;
+    }
+
+    // roll back any transaction in progress; if this cannot be determined or
+    // the rollback fails, the connection is released normally
+    if (dpiConn_getOciAttr(conn->handle, CXO_OCI_HTYPE_SESSION,
+            CXO_OCI_ATTR_TRANSACTION_IN_PROGRESS, &value, &valueLength) < 0)
+        return 0;
+    if (value.asBoolean) {
+        Py_BEGIN_ALLOW_THREADS
+        status = dpiConn_rollback(conn->handle);
+        Py_END_ALLOW_THREADS
+        if (status < 0)
+            return 0;
+    }
+
+    // add a slot for the thread, enlarging the array if needed
+    if (cxoSessionPool_watchThread(pool, threadId) < 0)
+        return -1;
+    if (pool->numAffinitySlots == pool->numAllocatedAffinitySlots) {
+        slot = PyMem_Realloc(pool->affinitySlots,
+                (pool->numAllocatedAffinitySlots + 8) *
+                sizeof(cxoPoolAffinitySlot));
+        if (!slot) {
+            PyErr_NoMemory();
+            return -1;
+        }
+        pool->affinitySlots = slot;
+        pool->numAllocatedAffinitySlots += 8;
+    }
+    slot = &pool->affinitySlots[pool->numAffinitySlots++];
+    slot->threadId = threadId;
+    slot->handle = conn->handle;
+    slot->releaseTime = cxoUtils_getMonotonicTime();
+
+    // the connection object no longer refers to the session
+    conn->handle = NULL;
+    cxoSessionPool_detachConnection(conn);
+    return 1;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoSessionPool_detachConnection()
+//   Detach the connection from the session pool from which it was acquired
+// after its session has been released. Any define variables and temporary
+// LOBs retained by the connection are released and if the connection was
+// leased a session by the pool's priority queue, the lease is returned so
+// that the next waiter can proceed (thread affinity cannot be combined with
+// the queue, so a retained session never holds a lease). The session is no
+// longer counted as busy in the statistics of the pool.
+//-----------------------------------------------------------------------------
+void cxoSessionPool_detachConnection(cxoConnection *conn)
+{
+    cxoSessionPool *pool = conn->sessionPool;
+
+    cxoConnection_clearDefineCache(conn);
+    cxoConnection_clearTempLobPool(conn);
+    if (pool && conn->holdsLease && pool->queue)
+        cxoPoolQueue_leave(pool);
+    conn->holdsLease = 0;
+    conn->sessionPool = NULL;
+    if (pool)
+        cxoSessionPool_adjustBusyCount(pool, -1);
+    Py_XDECREF(pool);
+}
+
+
 //-----------------------------------------------------------------------------
 // cxoSessionPool_init()
 //   Initialize the session pool object.
@@ -41,14 +481,16 @@ static int cxoSessionPool_init(cxoSessionPool *pool, PyObject *args,
     uint32_t waitTimeoutDeprecated, maxSessionsPerShardDeprecated;
     cxoBuffer userNameBuffer, passwordBuffer, dsnBuffer, editionBuffer;
     PyObject *usernameObj, *dsnObj, *sessionCallbackObj, *passwordObj;
-    PyObject *editionObj, *sessionCallbackObjDeprecated;
+    PyObject *editionObj, *sessionCallbackObjDeprecated, *reservationsObj;
     dpiCommonCreateParams dpiCommonParams;
     uint32_t maxLifetimeSessionDeprecated;
     dpiPoolCreateParams dpiCreateParams;
     cxoBuffer sessionCallbackBuffer;
-    int status, threaded, events;
+    int status, threaded, events, prewarm, threadAffinity, priorityQueue;
+    uint32_t affinityTimeout;
     PyTypeObject *connectionType;
     unsigned int stmtCacheSize;
+    uint32_t spare, healthCheckInterval;
     const char *encoding;
 
     // define keyword arguments
@@ -59,12 +501,14 @@ static int cxoSessionPool_init(cxoSessionPool *pool, PyObject *args,
             "session_callback", "max_sessions_per_shard",
             "soda_metadata_cache", "stmtcachesize", "ping_interval",
             "waitTimeout", "maxLifetimeSession", "sessionCallback",
-            "maxSessionsPerShard",
-            NULL };
+            "maxSessionsPerShard", "prewarm", "spare", "thread_affinity",
+            "affinity_timeout", "health_check_interval", "priority_queue",
+            "reservations", NULL };
 
     // parse arguments and keywords
     usernameObj = passwordObj = dsnObj = editionObj = Py_None;
     sessionCallbackObj = sessionCallbackObjDeprecated = passwordObj = NULL;
+    reservationsObj = NULL;
     connectionType = &cxoPyTypeConnection;
     minSessions = 1;
     maxSessions = 2;
@@ -73,6 +517,9 @@ static int cxoSessionPool_init(cxoSessionPool *pool, PyObject *args,
     waitTimeoutDeprecated = maxLifetimeSessionDeprecated = 0;
     maxSessionsPerShardDeprecated = 0;
     stmtCacheSize = DPI_DEFAULT_STMT_CACHE_SIZE;
+    threaded = events = prewarm = threadAffinity = priorityQueue = 0;
+    spare = healthCheckInterval = 0;
+    affinityTimeout = 60;
     if (cxoUtils_initializeDPI(NULL) < 0)
         return -1;
     if (dpiContext_initCommonCreateParams(cxoDpiContext, &dpiCommonParams) < 0)
@@ -80,7 +527,7 @@ static int cxoSessionPool_init(cxoSessionPool *pool, PyObject *args,
     if (dpiContext_initPoolCreateParams(cxoDpiContext, &dpiCreateParams) < 0)
         return cxoError_raiseAndReturnInt();
     if (!PyArg_ParseTupleAndKeywords(args, keywordArgs,
-            "|OOOiiiOpbpppssOiiiOipIiiiOi", keywordList, &usernameObj,
+            "|OOOiiiOpbpppssOiiiOipIiiiOipIpIIpO", keywordList, &usernameObj,
             &passwordObj, &dsnObj, &minSessions, &maxSessions,
             &sessionIncrement, &connectionType, &threaded,
             &dpiCreateParams.getMode, &events, &dpiCreateParams.homogeneous,
@@ -91,7 +538,9 @@ static int cxoSessionPool_init(cxoSessionPool *pool, PyObject *args,
             &dpiCommonParams.sodaMetadataCache, &stmtCacheSize,
             &dpiCreateParams.pingInterval, &waitTimeoutDeprecated,
             &maxLifetimeSessionDeprecated, &sessionCallbackObjDeprecated,
-            &maxSessionsPerShardDeprecated))
+            &maxSessionsPerShardDeprecated, &prewarm, &spare,
+            &threadAffinity, &affinityTimeout, &healthCheckInterval,
+            &priorityQueue, &reservationsObj))
         return -1;
     if (!PyType_Check(connectionType)) {
         cxoError_raiseFromString(cxoProgrammingErrorException,
@@ -103,6 +552,8 @@ static int cxoSessionPool_init(cxoSessionPool *pool, PyObject *args,
                 "connectiontype must be a subclass of Connection");
         return -1;
     }
+    if (prewarm || spare > 0 || healthCheckInterval > 0)
+        threaded = 1;
     if (threaded)
         dpiCommonParams.createMode |= DPI_MODE_CREATE_THREADED;
     if (events)
@@ -145,6 +596,37 @@ static int cxoSessionPool_init(cxoSessionPool *pool, PyObject *args,
         maxSessionsPerShard = maxSessionsPerShardDeprecated;
     }
 
+    // sessions opened in the background have not been passed to a Python
+    // session callback, so the two cannot be combined
+    if ((prewarm || spare > 0 || healthCheckInterval > 0) &&
+            sessionCallbackObj && PyCallable_Check(sessionCallbackObj)) {
+        cxoError_raiseFromString(cxoProgrammingErrorException,
+                "prewarm, spare and health_check_interval cannot be used "
+                "with a callable session_callback");
+        return -1;
+    }
+
+    // sessions opened in the background are acquired without credentials,
+    // so heterogeneous pools are not supported
+    if ((prewarm || spare > 0 || healthCheckInterval > 0) &&
+            !dpiCreateParams.homogeneous) {
+        cxoError_raiseFromString(cxoProgrammingErrorException,
+                "prewarm, spare and health_check_interval require a "
+                "homogeneous pool");
+        return -1;
+    }
+
+    // sessions retained for thread affinity remain busy in the pool without
+    // holding a lease from the priority queue, so the queue would grant
+    // leases that the pool cannot satisfy
+    if (threadAffinity && (priorityQueue ||
+            (reservationsObj && reservationsObj != Py_None))) {
+        cxoError_raiseFromString(cxoProgrammingErrorException,
+                "thread_affinity cannot be used with priority_queue or "
+                "reservations");
+        return -1;
+    }
+
     // initialize the object's members
     Py_INCREF(connectionType);
     pool->connectionType = connectionType;
@@ -157,9 +639,20 @@ static int cxoSessionPool_init(cxoSessionPool *pool, PyObject *args,
     pool->sessionIncrement = sessionIncrement;
     pool->homogeneous = dpiCreateParams.homogeneous;
     pool->externalAuth = dpiCreateParams.externalAuth;
+    pool->threaded = threaded;
+    pool->threadAffinity = threadAffinity;
+    pool->affinityTimeout = affinityTimeout;
     Py_XINCREF(sessionCallbackObj);
     pool->sessionCallback = sessionCallbackObj;
 
+    // create the queue used for serving callers in order of priority, if
+    // applicable
+    if (priorityQueue || (reservationsObj && reservationsObj != Py_None)) {
+        pool->queue = cxoPoolQueue_new(reservationsObj);
+        if (!pool->queue)
+            return -1;
+    }
+
     // populate parameters
     encoding = cxoUtils_getAdjustedEncoding(dpiCommonParams.encoding);
     cxoBuffer_init(&userNameBuffer);
@@ -181,7 +674,7 @@ static int cxoSessionPool_init(cxoSessionPool *pool, PyObject *args,
         cxoBuffer_clear(&sessionCallbackBuffer);
         return -1;
     }
-    dpiCreateParams.minSessions = minSessions;
+    dpiCreateParams.minSessions = (prewarm) ? 0 : minSessions;
     dpiCreateParams.maxSessions = maxSessions;
     dpiCreateParams.sessionIncrement = sessionIncrement;
     dpiCreateParams.plsqlFixupCallback = sessionCallbackBuffer.ptr;
@@ -218,6 +711,19 @@ static int cxoSessionPool_init(cxoSessionPool *pool, PyObject *args,
     if (!pool->name)
         return -1;
 
+    // start keeping track of statistics
+    pool->stats.startTime = pool->stats.lastUpdateTime =
+            cxoUtils_getMonotonicTime();
+    cxoSessionPool_updateStats(pool);
+
+    // start maintaining sessions in the background, if applicable
+    if (prewarm || spare > 0 || healthCheckInterval > 0) {
+        pool->warmer = cxoPoolWarmer_new(pool, prewarm, spare,
+                healthCheckInterval);
+        if (!pool->warmer)
+            return -1;
+    }
+
     return 0;
 }
 
@@ -228,6 +734,20 @@ static int cxoSessionPool_init(cxoSessionPool *pool, PyObject *args,
 //-----------------------------------------------------------------------------
 static void cxoSessionPool_free(cxoSessionPool *pool)
 {
+    if (pool->warmer) {
+        cxoPoolWarmer_free(pool->warmer);
+        pool->warmer = NULL;
+    }
+    if (pool->affinitySlots) {
+        cxoSessionPool_reclaimAffinity(pool, 1);
+        PyMem_Free(pool->affinitySlots);
+        pool->affinitySlots = NULL;
+    }
+    Py_CLEAR(pool->affinityLocal);
+    if (pool->queue) {
+        cxoPoolQueue_free(pool->queue);
+        pool->queue = NULL;
+    }
     if (pool->handle) {
         dpiPool_release(pool->handle);
         pool->handle = NULL;
@@ -236,6 +756,8 @@ static void cxoSessionPool_free(cxoSessionPool *pool)
     Py_CLEAR(pool->dsn);
     Py_CLEAR(pool->name);
     Py_CLEAR(pool->sessionCallback);
+    Py_CLEAR(pool->sessionStates);
+    Py_CLEAR(pool->sessionDefaults);
     Py_TYPE(pool)->tp_free((PyObject*) pool);
 }
 
@@ -248,36 +770,132 @@ static PyObject *cxoSessionPool_acquire(cxoSessionPool *pool, PyObject *args,
         PyObject *keywordArgs)
 {
     static char *keywordList[] = { "user", "password", "cclass", "purity",
-            "tag", "matchanytag", "shardingkey", "supershardingkey", NULL };
-    PyObject *createKeywordArgs, *result, *cclassObj, *purityObj, *tagObj;
-    PyObject *shardingKeyObj, *superShardingKeyObj;
-    Py_ssize_t usernameLength, passwordLength;
-    char *username, *password;
-    PyObject *matchAnyTagObj;
+            "tag", "matchanytag", "shardingkey", "supershardingkey", "state",
+            "priority", NULL };
+    PyObject *createKeywordArgs, *result, *cclassObj, *tagObj, *stateObj;
+    PyObject *shardingKeyObj, *superShardingKeyObj, *stateTagObj;
+    PyObject *usernameObj, *passwordObj;
+    int matchAnyTag, isTraced, priority;
+    uint64_t startTime = 0;
+    dpiConn *handle = NULL;
+    uint32_t purity;
 
     // parse arguments
-    if (!PyArg_ParseTupleAndKeywords(args, keywordArgs, "|s#s#OOOOOO",
-            keywordList, &username, &usernameLength, &password,
-            &passwordLength, &cclassObj, &purityObj, &tagObj, &matchAnyTagObj,
-            &shardingKeyObj, &superShardingKeyObj))
+    usernameObj = passwordObj = cclassObj = tagObj = NULL;
+    shardingKeyObj = superShardingKeyObj = stateObj = stateTagObj = NULL;
+    purity = DPI_PURITY_DEFAULT;
+    matchAnyTag = priority = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, keywordArgs, "|OOOiOpOOOi",
+            keywordList, &usernameObj, &passwordObj, &cclassObj, &purity,
+            &tagObj, &matchAnyTag, &shardingKeyObj, &superShardingKeyObj,
+            &stateObj, &priority))
         return NULL;
+    if (priority != 0 && !pool->queue) {
+        cxoError_raiseFromString(cxoProgrammingErrorException,
+                "priority requires a pool created with priority_queue=True "
+                "or reservations");
+        return NULL;
+    }
+
+    // if session state is requested, its fingerprint is used as the tag and
+    // any session is accepted since the differences are applied afterwards
+    if (stateObj && stateObj != Py_None) {
+        if (tagObj && tagObj != Py_None) {
+            cxoError_raiseFromString(cxoProgrammingErrorException,
+                    "tag and state cannot both be specified");
+            return NULL;
+        }
+        if (pool->sessionCallback && PyCallable_Check(pool->sessionCallback)) {
+            cxoError_raiseFromString(cxoProgrammingErrorException,
+                    "state cannot be used with a callable session_callback");
+            return NULL;
+        }
+        stateTagObj = cxoSessionState_getTag(pool, stateObj);
+        if (!stateTagObj)
+            return NULL;
+        tagObj = stateTagObj;
+        matchAnyTag = 1;
+    }
 
-    // create arguments
-    if (keywordArgs)
-        createKeywordArgs = PyDict_Copy(keywordArgs);
-    else createKeywordArgs = PyDict_New();
-    if (!createKeywordArgs)
+    // wait for the priority queue to lease a session, if applicable; the time
+    // spent waiting is included in the time traced for the acquire
+    isTraced = cxoTrace_isEnabled();
+    if (isTraced || pool->threadAffinity || pool->queue)
+        startTime = cxoUtils_getMonotonicTime();
+    if (pool->queue && cxoPoolQueue_enter(pool, priority) < 0) {
+        Py_XDECREF(stateTagObj);
         return NULL;
-    if (PyDict_SetItemString(createKeywordArgs, "pool",
-            (PyObject*) pool) < 0) {
+    }
+
+    // connections of the default type are acquired directly; subclasses
+    // require the type to be called with the pool added to the arguments;
+    // if thread affinity is enabled and no special session was requested the
+    // session last released by the calling thread is used, if available;
+    // otherwise, a session retained for another thread is released if the
+    // pool would have to wait for one
+    if (pool->threadAffinity && pool->connectionType == &cxoPyTypeConnection &&
+            !usernameObj && !passwordObj && !cclassObj && !tagObj &&
+            !shardingKeyObj && !superShardingKeyObj && !matchAnyTag &&
+            purity == DPI_PURITY_DEFAULT)
+        handle = cxoSessionPool_popAffinity(pool);
+    if (!handle && pool->threadAffinity)
+        cxoSessionPool_makeRoom(pool);
+    if (handle) {
+        result = cxoConnection_newFromHandle(pool, handle);
+        pool->stats.numAffinityHits++;
+        cxoSessionPool_recordAcquire(pool, startTime, 0);
+    } else if (pool->connectionType == &cxoPyTypeConnection) {
+        result = cxoConnection_newFromPool(pool, usernameObj, passwordObj,
+                cclassObj, purity, tagObj, matchAnyTag, shardingKeyObj,
+                superShardingKeyObj);
+    } else {
+        if (keywordArgs)
+            createKeywordArgs = PyDict_Copy(keywordArgs);
+        else createKeywordArgs = PyDict_New();
+        if (!createKeywordArgs) {
+            if (pool->queue)
+                cxoPoolQueue_leave(pool);
+            Py_XDECREF(stateTagObj);
+            return NULL;
+        }
+        if (PyDict_SetItemString(createKeywordArgs, "pool",
+                (PyObject*) pool) < 0 ||
+                (PyDict_GetItemString(createKeywordArgs, "priority") &&
+                PyDict_DelItemString(createKeywordArgs, "priority") < 0) ||
+                (stateTagObj &&
+                (PyDict_DelItemString(createKeywordArgs, "state") < 0 ||
+                PyDict_SetItemString(createKeywordArgs, "tag",
+                        stateTagObj) < 0 ||
+                PyDict_SetItemString(createKeywordArgs, "matchanytag",
+                        Py_True) < 0))) {
+            Py_DECREF(createKeywordArgs);
+            if (pool->queue)
+                cxoPoolQueue_leave(pool);
+            Py_XDECREF(stateTagObj);
+            return NULL;
+        }
+        result = PyObject_Call( (PyObject*) pool->connectionType, args,
+                createKeywordArgs);
         Py_DECREF(createKeywordArgs);
-        return NULL;
+    }
+    if (isTraced)
+        cxoTrace_record(CXO_TRACE_OP_ACQUIRE, pool->name, NULL, startTime, 0);
+
+    // the session leased by the priority queue is returned when the
+    // connection is released
+    if (pool->queue) {
+        if (result)
+            ((cxoConnection*) result)->holdsLease = 1;
+        else cxoPoolQueue_leave(pool);
     }
 
-    // create the connection object
-    result = PyObject_Call( (PyObject*) pool->connectionType, args,
-            createKeywordArgs);
-    Py_DECREF(createKeywordArgs);
+    // apply the differences in session state, if applicable
+    if (stateTagObj) {
+        if (result && cxoSessionState_apply((cxoConnection*) result, pool,
+                stateTagObj) < 0)
+            Py_CLEAR(result);
+        Py_DECREF(stateTagObj);
+    }
 
     return result;
 }
@@ -291,8 +909,12 @@ static PyObject *cxoSessionPool_close(cxoSessionPool *pool, PyObject *args,
         PyObject *keywordArgs)
 {
     static char *keywordList[] = { "force", NULL };
-    uint32_t closeMode;
-    int status, force;
+    uint32_t closeMode, spare = 0, healthCheckInterval = 0;
+    uint64_t numHealthChecks = 0, numSessionsEvicted = 0;
+    PyObject *excType, *excValue, *excTraceback;
+    uint64_t numSessionsOpened = 0;
+    int status, force, hadWarmer;
+    uint32_t openCount;
 
     // parse arguments
     force = 0;
@@ -302,12 +924,47 @@ static PyObject *cxoSessionPool_close(cxoSessionPool *pool, PyObject *args,
     closeMode = (force) ? DPI_MODE_POOL_CLOSE_FORCE :
             DPI_MODE_POOL_CLOSE_DEFAULT;
 
-    // close pool
+    // stop opening sessions in the background and release any sessions
+    // retained for threads; the settings of the background thread are
+    // retained so that it can be restarted if the pool cannot be closed
+    hadWarmer = (pool->warmer != NULL);
+    if (hadWarmer) {
+        spare = cxoPoolWarmer_getSpare(pool->warmer);
+        healthCheckInterval =
+                cxoPoolWarmer_getHealthCheckInterval(pool->warmer);
+        cxoPoolWarmer_getHealthStats(pool->warmer, &numHealthChecks,
+                &numSessionsEvicted);
+        cxoPoolWarmer_getSessionStats(pool->warmer, &numSessionsOpened,
+                &numSessionsEvicted, &openCount);
+        cxoPoolWarmer_free(pool->warmer);
+        pool->warmer = NULL;
+    }
+    cxoSessionPool_reclaimAffinity(pool, 1);
+
+    // close pool; if this fails the pool remains usable, so the background
+    // thread is restarted, keeping the error raised by the close
     Py_BEGIN_ALLOW_THREADS
     status = dpiPool_close(pool->handle, closeMode);
     Py_END_ALLOW_THREADS
-    if (status < 0)
-        return cxoError_raiseAndReturnNull();
+    if (status < 0) {
+        cxoError_raiseAndReturnNull();
+        if (hadWarmer) {
+            PyErr_Fetch(&excType, &excValue, &excTraceback);
+            pool->warmer = cxoPoolWarmer_new(pool, 0, spare,
+                    healthCheckInterval);
+            if (pool->warmer)
+                cxoPoolWarmer_setStats(pool->warmer, numHealthChecks,
+                        numSessionsOpened, numSessionsEvicted);
+            else PyErr_WriteUnraisable((PyObject*) pool);
+            PyErr_Restore(excType, excValue, excTraceback);
+        }
+        return NULL;
+    }
+
+    // wake any callers waiting in the priority queue; they will fail to
+    // acquire a session from the closed pool
+    if (pool->queue)
+        cxoPoolQueue_close(pool);
 
     Py_RETURN_NONE;
 }
@@ -334,9 +991,12 @@ static PyObject *cxoSessionPool_drop(cxoSessionPool *pool, PyObject *args)
     Py_END_ALLOW_THREADS
     if (status < 0)
         return cxoError_raiseAndReturnNull();
+    pool->stats.numSessionsDestroyed++;
+    if (pool->stats.openCount > 0)
+        pool->stats.openCount--;
 
     // mark connection as closed
-    Py_CLEAR(connection->sessionPool);
+    cxoSessionPool_detachConnection(connection);
     dpiConn_release(connection->handle);
     connection->handle = NULL;
     Py_RETURN_NONE;
@@ -353,12 +1013,13 @@ static PyObject *cxoSessionPool_reconfigure(cxoSessionPool *pool,
     PyObject *timeout, *waitTimeout, *maxLifetimeSession, *maxSessionsPerShard;
     PyObject *sodaMetadataCache, *stmtcachesize, *pingInterval, *getMode;
     uint32_t minSessions, maxSessions, sessionIncrement;
+    PyObject *spare, *healthCheckInterval;
 
     // define keyword arguments
     static char *keywordList[] = { "min", "max", "increment", "getmode",
             "timeout", "wait_timeout", "max_lifetime_session",
             "max_sessions_per_shard", "soda_metadata_cache", "stmtcachesize",
-            "ping_interval", NULL };
+            "ping_interval", "spare", "health_check_interval", NULL };
 
     // set up default values
     minSessions = pool->minSessions;
@@ -366,13 +1027,14 @@ static PyObject *cxoSessionPool_reconfigure(cxoSessionPool *pool,
     sessionIncrement = pool->sessionIncrement;
     timeout = waitTimeout = maxLifetimeSession = maxSessionsPerShard = NULL;
     sodaMetadataCache = stmtcachesize = pingInterval = getMode = NULL;
+    spare = healthCheckInterval = NULL;
 
     // parse arguments and keywords
-    if (!PyArg_ParseTupleAndKeywords(args, keywordArgs, "|iiiOOOOOOOO",
+    if (!PyArg_ParseTupleAndKeywords(args, keywordArgs, "|iiiOOOOOOOOOO",
             keywordList, &minSessions, &maxSessions, &sessionIncrement,
             &getMode, &timeout, &waitTimeout, &maxLifetimeSession,
             &maxSessionsPerShard, &sodaMetadataCache, &stmtcachesize,
-            &pingInterval))
+            &pingInterval, &spare, &healthCheckInterval))
         return NULL;
 
     // perform reconfiguration of the pool itself if needed
@@ -384,6 +1046,11 @@ static PyObject *cxoSessionPool_reconfigure(cxoSessionPool *pool,
         pool->minSessions = minSessions;
         pool->maxSessions = maxSessions;
         pool->sessionIncrement = sessionIncrement;
+        if (pool->warmer)
+            cxoPoolWarmer_setLimits(pool->warmer, minSessions, maxSessions,
+                    sessionIncrement);
+        if (pool->queue)
+            cxoPoolQueue_grant(pool);
     }
 
     // adjust attributes
@@ -409,6 +1076,11 @@ static PyObject *cxoSessionPool_reconfigure(cxoSessionPool *pool,
     if (cxoSessionPool_reconfigureHelper(pool, "ping_interval",
             pingInterval) < 0)
         return NULL;
+    if (cxoSessionPool_reconfigureHelper(pool, "spare", spare) < 0)
+        return NULL;
+    if (cxoSessionPool_reconfigureHelper(pool, "health_check_interval",
+            healthCheckInterval) < 0)
+        return NULL;
 
     Py_RETURN_NONE;
 }
@@ -449,6 +1121,20 @@ static PyObject *cxoSessionPool_release(cxoSessionPool *pool, PyObject *args,
     if (!PyArg_ParseTupleAndKeywords(args, keywordArgs, "O!|O",
             keywordList, &cxoPyTypeConnection, &conn, &tagObj))
         return NULL;
+    if (cxoConnection_isConnected(conn) < 0)
+        return NULL;
+    if (conn->sessionPool != pool) {
+        cxoError_raiseFromString(cxoProgrammingErrorException,
+                "connection was not acquired from this pool");
+        return NULL;
+    }
+    if (!tagObj || tagObj == Py_None) {
+        status = cxoSessionPool_cacheConnection(pool, conn);
+        if (status < 0)
+            return NULL;
+        if (status > 0)
+            Py_RETURN_NONE;
+    }
     if (!tagObj)
         tagObj = conn->tag;
     if (cxoBuffer_fromObject(&tagBuffer, tagObj,
@@ -466,7 +1152,7 @@ static PyObject *cxoSessionPool_release(cxoSessionPool *pool, PyObject *args,
         return cxoError_raiseAndReturnNull();
 
     // mark connection as closed
-    Py_CLEAR(conn->sessionPool);
+    cxoSessionPool_detachConnection(conn);
     dpiConn_release(conn->handle);
     conn->handle = NULL;
     Py_RETURN_NONE;
@@ -536,6 +1222,21 @@ static PyObject *cxoSessionPool_getGetMode(cxoSessionPool *pool, void *unused)
 }
 
 
+//-----------------------------------------------------------------------------
+// cxoSessionPool_getHealthCheckInterval()
+//   Return the number of seconds between health checks of the idle sessions
+// in the pool.
+//-----------------------------------------------------------------------------
+static PyObject *cxoSessionPool_getHealthCheckInterval(cxoSessionPool *pool,
+        void *unused)
+{
+    if (!pool->warmer)
+        return PyLong_FromLong(0);
+    return PyLong_FromUnsignedLong(
+            cxoPoolWarmer_getHealthCheckInterval(pool->warmer));
+}
+
+
 //-----------------------------------------------------------------------------
 // cxoSessionPool_getMaxLifetimeSession()
 //   Return the maximum lifetime session of connections in the session pool.
@@ -610,6 +1311,104 @@ static PyObject *cxoSessionPool_getStmtCacheSize(cxoSessionPool *pool,
 }
 
 
+//-----------------------------------------------------------------------------
+// cxoSessionPool_getReservations()
+//   Return the number of sessions reserved for callers of higher priority
+// than each priority, or None if the pool does not use a priority queue.
+//-----------------------------------------------------------------------------
+static PyObject *cxoSessionPool_getReservations(cxoSessionPool *pool,
+        void *unused)
+{
+    if (!pool->queue)
+        Py_RETURN_NONE;
+    return cxoPoolQueue_getReservations(pool->queue);
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoSessionPool_getSpare()
+//   Return the number of idle sessions that are kept open in the background.
+//-----------------------------------------------------------------------------
+static PyObject *cxoSessionPool_getSpare(cxoSessionPool *pool, void *unused)
+{
+    if (!pool->warmer)
+        return PyLong_FromLong(0);
+    return PyLong_FromUnsignedLong(cxoPoolWarmer_getSpare(pool->warmer));
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoSessionPool_getStats()
+//   Return a dictionary containing a snapshot of the statistics for the
+// session pool. Times are returned in seconds.
+//-----------------------------------------------------------------------------
+static PyObject *cxoSessionPool_getStats(cxoSessionPool *pool, void *unused)
+{
+    PyObject *dict, *histogram, *bucket;
+    uint64_t numHealthChecks = 0, numSessionsEvicted = 0;
+    uint64_t numQueueWaits = 0, numQueueTimeouts = 0;
+    uint32_t numQueued = 0;
+    cxoPoolStats *stats = &pool->stats;
+    double elapsedTime, busyAverage;
+    uint32_t i;
+
+    // bring the statistics up to date
+    cxoSessionPool_updateStats(pool);
+    elapsedTime = (double) (stats->lastUpdateTime - stats->startTime) / 1e9;
+    busyAverage = (elapsedTime > 0) ?
+            (double) stats->busyTime / 1e9 / elapsedTime : 0;
+
+    // create the histogram as a list of (upper bound, count) tuples
+    histogram = PyList_New(CXO_POOL_NUM_WAIT_BUCKETS);
+    if (!histogram)
+        return NULL;
+    for (i = 0; i < CXO_POOL_NUM_WAIT_BUCKETS; i++) {
+        if (i < CXO_POOL_NUM_WAIT_BUCKETS - 1)
+            bucket = Py_BuildValue("(dK)",
+                    (double) cxoSessionPoolWaitBuckets[i] / 1e9,
+                    (unsigned long long) stats->waitHistogram[i]);
+        else bucket = Py_BuildValue("(OK)", Py_None,
+                (unsigned long long) stats->waitHistogram[i]);
+        if (!bucket) {
+            Py_DECREF(histogram);
+            return NULL;
+        }
+        PyList_SET_ITEM(histogram, i, bucket);
+    }
+
+    // create the dictionary
+    if (pool->warmer)
+        cxoPoolWarmer_getHealthStats(pool->warmer, &numHealthChecks,
+                &numSessionsEvicted);
+    if (pool->queue)
+        cxoPoolQueue_getStats(pool->queue, &numQueued, &numQueueWaits,
+                &numQueueTimeouts);
+    dict = Py_BuildValue("{sKsKsKsKsKsdsdsNsIsIsdsIsIsdsKsKsKsIsKsK}",
+            "acquires", (unsigned long long) stats->numAcquires,
+            "acquire_failures", (unsigned long long) stats->numAcquireFailures,
+            "acquire_timeouts", (unsigned long long) stats->numAcquireTimeouts,
+            "sessions_created", (unsigned long long) stats->numSessionsCreated,
+            "sessions_destroyed",
+                    (unsigned long long) stats->numSessionsDestroyed,
+            "wait_time", (double) stats->totalWaitTime / 1e9,
+            "max_wait_time", (double) stats->maxWaitTime / 1e9,
+            "wait_histogram", histogram,
+            "busy", stats->busyCount,
+            "busy_high_water", stats->busyHighWater,
+            "busy_average", busyAverage,
+            "opened", stats->openCount,
+            "opened_high_water", stats->openHighWater,
+            "elapsed_time", elapsedTime,
+            "affinity_hits", (unsigned long long) stats->numAffinityHits,
+            "health_checks", (unsigned long long) numHealthChecks,
+            "sessions_evicted", (unsigned long long) numSessionsEvicted,
+            "queued", numQueued,
+            "queue_waits", (unsigned long long) numQueueWaits,
+            "queue_timeouts", (unsigned long long) numQueueTimeouts);
+    return dict;
+}
+
+
 //-----------------------------------------------------------------------------
 // cxoSessionPool_getTimeout()
 //   Return the timeout for connections in the session pool.
@@ -721,6 +1520,97 @@ static int cxoSessionPool_setSodaMetadataCache(cxoSessionPool *pool,
 }
 
 
+//-----------------------------------------------------------------------------
+// cxoSessionPool_startWarmer()
+//   Start the thread that maintains sessions in the background, if it has not
+// already been started. This requires a homogeneous pool created in threaded
+// mode.
+//-----------------------------------------------------------------------------
+static int cxoSessionPool_startWarmer(cxoSessionPool *pool)
+{
+    if (pool->warmer)
+        return 0;
+    if (!pool->threaded) {
+        cxoError_raiseFromString(cxoProgrammingErrorException,
+                "maintaining sessions in the background requires a pool "
+                "created with threaded=True");
+        return -1;
+    }
+    if (pool->sessionCallback && PyCallable_Check(pool->sessionCallback)) {
+        cxoError_raiseFromString(cxoProgrammingErrorException,
+                "maintaining sessions in the background cannot be used with "
+                "a callable session_callback");
+        return -1;
+    }
+    if (!pool->homogeneous) {
+        cxoError_raiseFromString(cxoProgrammingErrorException,
+                "maintaining sessions in the background requires a "
+                "homogeneous pool");
+        return -1;
+    }
+    pool->stats.numWarmerSessionsOpened = 0;
+    pool->stats.numWarmerSessionsEvicted = 0;
+    pool->warmer = cxoPoolWarmer_new(pool, 0, 0, 0);
+    if (!pool->warmer)
+        return -1;
+    return 0;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoSessionPool_setHealthCheckInterval()
+//   Set the number of seconds between health checks of the idle sessions in
+// the pool. The background thread is started the first time a value greater
+// than zero is set.
+//-----------------------------------------------------------------------------
+static int cxoSessionPool_setHealthCheckInterval(cxoSessionPool *pool,
+        PyObject *value, void *unused)
+{
+    uint32_t cValue;
+
+    if (!PyLong_Check(value)) {
+        PyErr_SetString(PyExc_TypeError, "value must be an integer");
+        return -1;
+    }
+    cValue = PyLong_AsUnsignedLong(value);
+    if (PyErr_Occurred())
+        return -1;
+    if (cValue > 0 && cxoSessionPool_startWarmer(pool) < 0)
+        return -1;
+    if (pool->warmer)
+        cxoPoolWarmer_setHealthCheckInterval(pool->warmer, cValue);
+
+    return 0;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoSessionPool_setSpare()
+//   Set the number of idle sessions that are kept open in the background. The
+// background thread is started the first time a number greater than zero is
+// set.
+//-----------------------------------------------------------------------------
+static int cxoSessionPool_setSpare(cxoSessionPool *pool, PyObject *value,
+        void *unused)
+{
+    uint32_t cValue;
+
+    if (!PyLong_Check(value)) {
+        PyErr_SetString(PyExc_TypeError, "value must be an integer");
+        return -1;
+    }
+    cValue = PyLong_AsUnsignedLong(value);
+    if (PyErr_Occurred())
+        return -1;
+    if (cValue > 0 && cxoSessionPool_startWarmer(pool) < 0)
+        return -1;
+    if (pool->warmer)
+        cxoPoolWarmer_setSpare(pool->warmer, cValue);
+
+    return 0;
+}
+
+
 //-----------------------------------------------------------------------------
 // cxoSessionPool_setStmtCacheSize()
 //   Set the default size of the statement cache used for connections that are
@@ -785,6 +1675,10 @@ static PyMemberDef cxoMembers[] = {
     { "increment", T_INT, offsetof(cxoSessionPool, sessionIncrement),
             READONLY },
     { "homogeneous", T_INT, offsetof(cxoSessionPool, homogeneous), READONLY },
+    { "thread_affinity", T_INT, offsetof(cxoSessionPool, threadAffinity),
+            READONLY },
+    { "affinity_timeout", T_UINT, offsetof(cxoSessionPool, affinityTimeout),
+            0 },
     { NULL }
 };
 
@@ -795,18 +1689,25 @@ static PyMemberDef cxoMembers[] = {
 static PyGetSetDef cxoCalcMembers[] = {
     { "opened", (getter) cxoSessionPool_getOpenCount, 0, 0, 0 },
     { "busy", (getter) cxoSessionPool_getBusyCount, 0, 0, 0 },
+    { "stats", (getter) cxoSessionPool_getStats, 0, 0, 0 },
     { "timeout", (getter) cxoSessionPool_getTimeout,
             (setter) cxoSessionPool_setTimeout, 0, 0 },
     { "getmode", (getter) cxoSessionPool_getGetMode,
             (setter) cxoSessionPool_setGetMode, 0, 0 },
+    { "health_check_interval",
+            (getter) cxoSessionPool_getHealthCheckInterval,
+            (setter) cxoSessionPool_setHealthCheckInterval, 0, 0 },
     { "max_lifetime_session", (getter) cxoSessionPool_getMaxLifetimeSession,
             (setter) cxoSessionPool_setMaxLifetimeSession, 0, 0 },
     { "max_sessions_per_shard", (getter) cxoSessionPool_getMaxSessionsPerShard,
             (setter) cxoSessionPool_setMaxSessionsPerShard, 0, 0 },
     { "ping_interval", (getter) cxoSessionPool_getPingInterval,
             (setter) cxoSessionPool_setPingInterval, 0, 0 },
+    { "reservations", (getter) cxoSessionPool_getReservations, 0, 0, 0 },
     { "soda_metadata_cache", (getter) cxoSessionPool_getSodaMetadataCache,
             (setter) cxoSessionPool_setSodaMetadataCache, 0, 0 },
+    { "spare", (getter) cxoSessionPool_getSpare,
+            (setter) cxoSessionPool_setSpare, 0, 0 },
     { "stmtcachesize", (getter) cxoSessionPool_getStmtCacheSize,
             (setter) cxoSessionPool_setStmtCacheSize, 0, 0 },
     { "wait_timeout", (getter) cxoSessionPool_getWaitTimeout,
@@ -0,0 +1,554 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2021, Oracle and/or its affiliates. All rights reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// cxoSessionState.c
+//   Defines routines for managing declarative session state for sessions
+// acquired from a session pool. The state is a dictionary of NLS parameters,
+// the current schema and end-to-end tracing attributes. A fingerprint of the
+// state is used as the session tag and the state of each fingerprint is
+// retained by the pool so that only the differences between the state of the
+// session that was acquired and the requested state need to be applied. The
+// default values of NLS parameters are retained by the pool as well so that
+// parameters which are no longer requested can be restored.
+//-----------------------------------------------------------------------------
+
+#include "cxoModule.h"
+
+// prefix used for tags that are fingerprints of session state
+#define CXO_SESSION_STATE_TAG_PREFIX        "cxo_state="
+
+// SQL used to determine the default values of NLS parameters
+#define CXO_SESSION_STATE_GET_NLS \
+        "select lower(parameter), value from nls_session_parameters"
+
+// PL/SQL used to apply NLS parameters and to restore the current schema
+#define CXO_SESSION_STATE_SET_NLS \
+        "dbms_session.set_nls(:%d, :%d); "
+#define CXO_SESSION_STATE_RESET_SCHEMA \
+        "execute immediate 'alter session set current_schema = ' || " \
+        "dbms_assert.enquote_name(sys_context('userenv', 'session_user')); "
+
+//-----------------------------------------------------------------------------
+// attributes which are set on the session handle and are sent to the
+// database with the next round trip
+//-----------------------------------------------------------------------------
+typedef struct {
+    const char *name;
+    int (*setter)(dpiConn *conn, const char *value, uint32_t valueLength);
+} cxoSessionStateAttr;
+
+static const cxoSessionStateAttr cxoSessionStateAttrs[] = {
+    { "action", dpiConn_setAction },
+    { "client_identifier", dpiConn_setClientIdentifier },
+    { "client_info", dpiConn_setClientInfo },
+    { "current_schema", dpiConn_setCurrentSchema },
+    { "module", dpiConn_setModule },
+    { NULL, NULL }
+};
+
+
+//-----------------------------------------------------------------------------
+// cxoSessionState_findAttr()
+//   Return the attribute with the given name or NULL if the name does not
+// refer to an attribute set on the session handle.
+//-----------------------------------------------------------------------------
+static const cxoSessionStateAttr *cxoSessionState_findAttr(const char *name)
+{
+    const cxoSessionStateAttr *attr;
+
+    for (attr = cxoSessionStateAttrs; attr->name; attr++) {
+        if (strcmp(attr->name, name) == 0)
+            return attr;
+    }
+    return NULL;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoSessionState_checkKey()
+//   Check that the key is a supported name: either the name of an attribute
+// set on the session handle or the name of an NLS parameter. NLS parameter
+// names may only contain letters, digits and underscores since they are
+// passed to ALTER SESSION.
+//-----------------------------------------------------------------------------
+static int cxoSessionState_checkKey(const char *name)
+{
+    const char *ptr;
+
+    if (cxoSessionState_findAttr(name))
+        return 0;
+    if (strncmp(name, "nls_", 4) == 0 && name[4]) {
+        for (ptr = name + 4; *ptr; ptr++) {
+            if (!Py_ISALNUM(*ptr) && *ptr != '_')
+                break;
+        }
+        if (!*ptr)
+            return 0;
+    }
+    cxoError_raiseFromString(cxoProgrammingErrorException,
+            "unsupported session state key");
+    return -1;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoSessionState_hash()
+//   Add the bytes to the 64-bit FNV-1a hash. A hash is used instead of the
+// Python hash since the fingerprint must be stable across processes when
+// sessions are shared using DRCP.
+//-----------------------------------------------------------------------------
+static uint64_t cxoSessionState_hash(uint64_t hash, const char *ptr,
+        Py_ssize_t size)
+{
+    Py_ssize_t i;
+
+    for (i = 0; i < size; i++) {
+        hash ^= (unsigned char) ptr[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoSessionState_getTag()
+//   Validate the requested state and return the tag that identifies it. Keys
+// are compared without regard to case. The state is registered with the pool
+// so that it can be used to determine the differences to apply when a session
+// with the tag is acquired again later.
+//-----------------------------------------------------------------------------
+PyObject *cxoSessionState_getTag(cxoSessionPool *pool, PyObject *state)
+{
+    PyObject *normalizedState, *keys, *key, *value, *tag;
+    Py_ssize_t i, pos, keySize, valueSize;
+    const char *keyPtr, *valuePtr;
+    char tagBuffer[40];
+    uint64_t hash;
+
+    // normalize the keys of the state and validate them and their values
+    if (!PyDict_Check(state)) {
+        PyErr_SetString(PyExc_TypeError, "state must be a dictionary");
+        return NULL;
+    }
+    normalizedState = PyDict_New();
+    if (!normalizedState)
+        return NULL;
+    pos = 0;
+    while (PyDict_Next(state, &pos, &key, &value)) {
+        if (!PyUnicode_Check(key) || !PyUnicode_Check(value)) {
+            Py_DECREF(normalizedState);
+            PyErr_SetString(PyExc_TypeError,
+                    "session state keys and values must be strings");
+            return NULL;
+        }
+        key = PyObject_CallMethod(key, "lower", NULL);
+        if (!key) {
+            Py_DECREF(normalizedState);
+            return NULL;
+        }
+        keyPtr = PyUnicode_AsUTF8(key);
+        if (!keyPtr || cxoSessionState_checkKey(keyPtr) < 0 ||
+                PyDict_SetItem(normalizedState, key, value) < 0) {
+            Py_DECREF(normalizedState);
+            Py_DECREF(key);
+            return NULL;
+        }
+        Py_DECREF(key);
+    }
+
+    // calculate the fingerprint of the keys and values in sorted order
+    keys = PyDict_Keys(normalizedState);
+    if (!keys || PyList_Sort(keys) < 0) {
+        Py_XDECREF(keys);
+        Py_DECREF(normalizedState);
+        return NULL;
+    }
+    hash = 14695981039346656037ULL;
+    for (i = 0; i < PyList_GET_SIZE(keys); i++) {
+        key = PyList_GET_ITEM(keys, i);
+        value = PyDict_GetItem(normalizedState, key);
+        keyPtr = PyUnicode_AsUTF8AndSize(key, &keySize);
+        valuePtr = PyUnicode_AsUTF8AndSize(value, &valueSize);
+        if (!keyPtr || !valuePtr) {
+            Py_DECREF(keys);
+            Py_DECREF(normalizedState);
+            return NULL;
+        }
+        hash = cxoSessionState_hash(hash, keyPtr, keySize + 1);
+        hash = cxoSessionState_hash(hash, valuePtr, valueSize + 1);
+    }
+    Py_DECREF(keys);
+    snprintf(tagBuffer, sizeof(tagBuffer), "%s%016llx",
+            CXO_SESSION_STATE_TAG_PREFIX, (unsigned long long) hash);
+    tag = PyUnicode_FromString(tagBuffer);
+    if (!tag) {
+        Py_DECREF(normalizedState);
+        return NULL;
+    }
+
+    // register the state with the pool
+    if (!pool->sessionStates) {
+        pool->sessionStates = PyDict_New();
+        if (!pool->sessionStates) {
+            Py_DECREF(normalizedState);
+            Py_DECREF(tag);
+            return NULL;
+        }
+    }
+    if (PyDict_SetItem(pool->sessionStates, tag, normalizedState) < 0) {
+        Py_DECREF(normalizedState);
+        Py_DECREF(tag);
+        return NULL;
+    }
+    Py_DECREF(normalizedState);
+
+    return tag;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoSessionState_setAttr()
+//   Set the attribute on the session handle. The value is sent to the
+// database with the next round trip.
+//-----------------------------------------------------------------------------
+static int cxoSessionState_setAttr(cxoConnection *conn,
+        const cxoSessionStateAttr *attr, PyObject *value)
+{
+    cxoBuffer buffer;
+    int status;
+
+    if (cxoBuffer_fromObject(&buffer, value, conn->encodingInfo.encoding) < 0)
+        return -1;
+    status = (*attr->setter)(conn->handle, (buffer.ptr) ? buffer.ptr : "",
+            buffer.size);
+    cxoBuffer_clear(&buffer);
+    if (status < 0)
+        return cxoError_raiseAndReturnInt();
+    return 0;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoSessionState_addNls()
+//   Add the statement that sets the NLS parameter to the PL/SQL block, along
+// with the values to bind to it. The value is passed as a quoted literal as
+// required by dbms_session.set_nls().
+//-----------------------------------------------------------------------------
+static int cxoSessionState_addNls(PyObject *lines, PyObject *bindValues,
+        PyObject *key, PyObject *value)
+{
+    PyObject *line, *escapedValue, *quotedValue;
+    Py_ssize_t pos;
+    int status;
+
+    pos = PyList_GET_SIZE(bindValues) + 1;
+    line = PyUnicode_FromFormat(CXO_SESSION_STATE_SET_NLS, (int) pos,
+            (int) pos + 1);
+    if (!line)
+        return -1;
+    status = PyList_Append(lines, line);
+    Py_DECREF(line);
+    if (status < 0)
+        return -1;
+    escapedValue = PyObject_CallMethod(value, "replace", "ss", "'", "''");
+    if (!escapedValue)
+        return -1;
+    quotedValue = PyUnicode_FromFormat("'%U'", escapedValue);
+    Py_DECREF(escapedValue);
+    if (!quotedValue)
+        return -1;
+    status = PyList_Append(bindValues, key);
+    if (status == 0)
+        status = PyList_Append(bindValues, quotedValue);
+    Py_DECREF(quotedValue);
+    return status;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoSessionState_execute()
+//   Execute the PL/SQL block containing the given lines in a single round
+// trip, binding the given string values by position.
+//-----------------------------------------------------------------------------
+static int cxoSessionState_execute(cxoConnection *conn, PyObject *lines,
+        PyObject *bindValues)
+{
+    PyObject *separator, *body, *sql;
+    Py_ssize_t i, numBinds;
+    cxoBuffer sqlBuffer, *buffers;
+    uint32_t numQueryColumns;
+    dpiStmt *stmt;
+    dpiData data;
+    int status;
+
+    // build the PL/SQL block
+    separator = PyUnicode_FromString("");
+    if (!separator)
+        return -1;
+    body = PyUnicode_Join(separator, lines);
+    Py_DECREF(separator);
+    if (!body)
+        return -1;
+    sql = PyUnicode_FromFormat("begin %Uend;", body);
+    Py_DECREF(body);
+    if (!sql)
+        return -1;
+    status = cxoBuffer_fromObject(&sqlBuffer, sql,
+            conn->encodingInfo.encoding);
+    Py_DECREF(sql);
+    if (status < 0)
+        return -1;
+
+    // convert the values to bind
+    numBinds = PyList_GET_SIZE(bindValues);
+    buffers = PyMem_Malloc(numBinds * sizeof(cxoBuffer));
+    if (!buffers) {
+        cxoBuffer_clear(&sqlBuffer);
+        PyErr_NoMemory();
+        return -1;
+    }
+    for (i = 0; i < numBinds; i++)
+        cxoBuffer_init(&buffers[i]);
+    for (i = 0; i < numBinds && status == 0; i++)
+        status = cxoBuffer_fromObject(&buffers[i],
+                PyList_GET_ITEM(bindValues, i), conn->encodingInfo.encoding);
+
+    // prepare the statement, bind the values and execute it
+    if (status == 0) {
+        if (dpiConn_prepareStmt(conn->handle, 0, sqlBuffer.ptr,
+                sqlBuffer.size, NULL, 0, &stmt) < 0) {
+            status = cxoError_raiseAndReturnInt();
+        } else {
+            data.isNull = 0;
+            for (i = 0; i < numBinds && status == 0; i++) {
+                data.value.asBytes.ptr = (char*) buffers[i].ptr;
+                data.value.asBytes.length = buffers[i].size;
+                data.value.asBytes.encoding = NULL;
+                if (dpiStmt_bindValueByPos(stmt, (uint32_t) i + 1,
+                        DPI_NATIVE_TYPE_BYTES, &data) < 0)
+                    status = cxoError_raiseAndReturnInt();
+            }
+            if (status == 0) {
+                Py_BEGIN_ALLOW_THREADS
+                status = dpiStmt_execute(stmt, DPI_MODE_EXEC_DEFAULT,
+                        &numQueryColumns);
+                Py_END_ALLOW_THREADS
+                if (status < 0)
+                    cxoError_raiseAndReturnInt();
+            }
+            dpiStmt_release(stmt);
+        }
+    }
+
+    // clean up
+    for (i = 0; i < numBinds; i++)
+        cxoBuffer_clear(&buffers[i]);
+    PyMem_Free(buffers);
+    cxoBuffer_clear(&sqlBuffer);
+    return status;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoSessionState_captureDefaults()
+//   Retain the values of the NLS parameters of the session that have not been
+// changed by the state currently applied to it, since these are the values
+// established when the session was created. This is done in a single round
+// trip and only when an NLS parameter is about to be changed for which no
+// default value is known yet. Requested parameters which are not found are
+// recorded with the value None so that they are not queried again.
+//-----------------------------------------------------------------------------
+static int cxoSessionState_captureDefaults(cxoConnection *conn,
+        cxoSessionPool *pool, PyObject *requested, PyObject *current)
+{
+    uint32_t numQueryColumns, bufferRowIndex;
+    dpiNativeTypeNum nativeTypeNum;
+    dpiData *keyData, *valueData;
+    PyObject *key, *value;
+    int found, status;
+    dpiStmt *stmt;
+    Py_ssize_t pos;
+
+    // create the dictionary of default values, if needed
+    if (!pool->sessionDefaults) {
+        pool->sessionDefaults = PyDict_New();
+        if (!pool->sessionDefaults)
+            return -1;
+    }
+
+    // query the values of the NLS parameters of the session
+    if (dpiConn_prepareStmt(conn->handle, 0, CXO_SESSION_STATE_GET_NLS,
+            strlen(CXO_SESSION_STATE_GET_NLS), NULL, 0, &stmt) < 0)
+        return cxoError_raiseAndReturnInt();
+    Py_BEGIN_ALLOW_THREADS
+    status = dpiStmt_execute(stmt, DPI_MODE_EXEC_DEFAULT, &numQueryColumns);
+    Py_END_ALLOW_THREADS
+    if (status < 0)
+        cxoError_raiseAndReturnInt();
+    while (status == 0) {
+        Py_BEGIN_ALLOW_THREADS
+        status = dpiStmt_fetch(stmt, &found, &bufferRowIndex);
+        Py_END_ALLOW_THREADS
+        if (status < 0 ||
+                (found && (dpiStmt_getQueryValue(stmt, 1, &nativeTypeNum,
+                        &keyData) < 0 ||
+                dpiStmt_getQueryValue(stmt, 2, &nativeTypeNum,
+                        &valueData) < 0))) {
+            status = cxoError_raiseAndReturnInt();
+            break;
+        }
+        if (!found)
+            break;
+        if (keyData->isNull || valueData->isNull)
+            continue;
+        key = PyUnicode_Decode(keyData->value.asBytes.ptr,
+                keyData->value.asBytes.length, conn->encodingInfo.encoding,
+                NULL);
+        if (!key) {
+            status = -1;
+            break;
+        }
+        if ((!current || !PyDict_GetItem(current, key)) &&
+                !PyDict_GetItem(pool->sessionDefaults, key)) {
+            value = PyUnicode_Decode(valueData->value.asBytes.ptr,
+                    valueData->value.asBytes.length,
+                    conn->encodingInfo.encoding, NULL);
+            if (!value || PyDict_SetItem(pool->sessionDefaults, key,
+                    value) < 0)
+                status = -1;
+            Py_XDECREF(value);
+        }
+        Py_DECREF(key);
+    }
+    dpiStmt_release(stmt);
+
+    // record requested parameters that were not found
+    pos = 0;
+    while (status == 0 && PyDict_Next(requested, &pos, &key, &value)) {
+        if (!cxoSessionState_findAttr(PyUnicode_AsUTF8(key)) &&
+                !PyDict_GetItem(pool->sessionDefaults, key))
+            status = PyDict_SetItem(pool->sessionDefaults, key, Py_None);
+    }
+
+    return status;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoSessionState_apply()
+//   Bring the session state of the connection in line with the state that
+// is identified by the given tag, which must have been returned by
+// cxoSessionState_getTag(). Nothing is done if the session already has the
+// tag. Otherwise, the state identified by the session's tag (if known) is
+// compared with the requested state and only the differences are applied.
+// Attributes are set on the session handle and are sent to the database with
+// the next round trip; NLS parameters are set and the current schema is
+// restored (if no longer requested) in a single PL/SQL block. NLS parameters
+// that are no longer requested are restored to their default values. On
+// success the tag is set on the connection so that it is retained when the
+// session is released back to the pool.
+//-----------------------------------------------------------------------------
+int cxoSessionState_apply(cxoConnection *conn, cxoSessionPool *pool,
+        PyObject *tag)
+{
+    PyObject *requested, *current, *key, *value, *currentValue;
+    PyObject *lines, *bindValues, *resetLine, *defaultValue;
+    const cxoSessionStateAttr *attr;
+    int status, needDefaults;
+    Py_ssize_t pos;
+
+    // nothing to do if the session already has the requested state
+    if (conn->tag && conn->tag != Py_None) {
+        status = PyObject_RichCompareBool(conn->tag, tag, Py_EQ);
+        if (status != 0)
+            return (status < 0) ? -1 : 0;
+    }
+    requested = PyDict_GetItem(pool->sessionStates, tag);
+    current = NULL;
+    if (conn->tag && conn->tag != Py_None)
+        current = PyDict_GetItem(pool->sessionStates, conn->tag);
+
+    // retain the default values of NLS parameters that are about to be
+    // changed for the first time
+    needDefaults = 0;
+    pos = 0;
+    while (!needDefaults && PyDict_Next(requested, &pos, &key, &value)) {
+        if (cxoSessionState_findAttr(PyUnicode_AsUTF8(key)) ||
+                (current && PyDict_GetItem(current, key)))
+            continue;
+        if (!pool->sessionDefaults ||
+                !PyDict_GetItem(pool->sessionDefaults, key))
+            needDefaults = 1;
+    }
+    if (needDefaults && cxoSessionState_captureDefaults(conn, pool,
+            requested, current) < 0)
+        return -1;
+
+    // determine the differences
+    lines = PyList_New(0);
+    if (!lines)
+        return -1;
+    bindValues = PyList_New(0);
+    if (!bindValues) {
+        Py_DECREF(lines);
+        return -1;
+    }
+    status = 0;
+    pos = 0;
+    while (status == 0 && PyDict_Next(requested, &pos, &key, &value)) {
+        if (current) {
+            currentValue = PyDict_GetItem(current, key);
+            if (currentValue) {
+                status = PyObject_RichCompareBool(currentValue, value, Py_EQ);
+                if (status != 0) {
+                    status = (status < 0) ? -1 : 0;
+                    continue;
+                }
+            }
+        }
+        attr = cxoSessionState_findAttr(PyUnicode_AsUTF8(key));
+        if (attr)
+            status = cxoSessionState_setAttr(conn, attr, value);
+        else status = cxoSessionState_addNls(lines, bindValues, key, value);
+    }
+    pos = 0;
+    while (status == 0 && current &&
+            PyDict_Next(current, &pos, &key, &value)) {
+        if (PyDict_GetItem(requested, key))
+            continue;
+        attr = cxoSessionState_findAttr(PyUnicode_AsUTF8(key));
+        if (!attr) {
+            defaultValue = (pool->sessionDefaults) ?
+                    PyDict_GetItem(pool->sessionDefaults, key) : NULL;
+            if (defaultValue && defaultValue != Py_None)
+                status = cxoSessionState_addNls(lines, bindValues, key,
+                        defaultValue);
+            continue;
+        }
+        if (attr->setter == dpiConn_setCurrentSchema) {
+            resetLine = PyUnicode_FromString(CXO_SESSION_STATE_RESET_SCHEMA);
+            if (!resetLine) {
+                status = -1;
+                break;
+            }
+            status = PyList_Append(lines, resetLine);
+            Py_DECREF(resetLine);
+        } else status = cxoSessionState_setAttr(conn, attr, NULL);
+    }
+
+    // apply the differences that require a round trip
+    if (status == 0 && PyList_GET_SIZE(lines) > 0)
+        status = cxoSessionState_execute(conn, lines, bindValues);
+    Py_DECREF(lines);
+    Py_DECREF(bindValues);
+    if (status < 0)
+        return -1;
+
+    // the session now has the requested state
+    Py_XDECREF(conn->tag);
+    Py_INCREF(tag);
+    conn->tag = tag;
+    return 0;
+}
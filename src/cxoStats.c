@@ -0,0 +1,75 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2021, Oracle and/or its affiliates. All rights reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// cxoStats.c
+//   Defines routines for managing the execution statistics collected by
+// cursors and aggregated by connections.
+//-----------------------------------------------------------------------------
+
+#include "cxoModule.h"
+
+//-----------------------------------------------------------------------------
+// cxoStats_add()
+//   Add the counters found in the delta to the statistics.
+//-----------------------------------------------------------------------------
+void cxoStats_add(cxoStats *stats, const cxoStats *delta)
+{
+    stats->numFetches += delta->numFetches;
+    stats->numRowsFetched += delta->numRowsFetched;
+    stats->numDefineBytes += delta->numDefineBytes;
+    stats->numBindReallocations += delta->numBindReallocations;
+    stats->waitTime += delta->waitTime;
+    stats->conversionTime += delta->conversionTime;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoStats_setItem()
+//   Set an item in the dictionary and release the reference to the value.
+//-----------------------------------------------------------------------------
+static int cxoStats_setItem(PyObject *dict, const char *key, PyObject *value)
+{
+    int status;
+
+    if (!value)
+        return -1;
+    status = PyDict_SetItemString(dict, key, value);
+    Py_DECREF(value);
+    return status;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoStats_toDict()
+//   Return a dictionary containing a snapshot of the statistics. Times are
+// returned in seconds.
+//-----------------------------------------------------------------------------
+PyObject *cxoStats_toDict(const cxoStats *stats)
+{
+    PyObject *dict;
+
+    dict = PyDict_New();
+    if (!dict)
+        return NULL;
+    if (cxoStats_setItem(dict, "fetch_calls",
+                    PyLong_FromUnsignedLongLong(stats->numFetches)) < 0 ||
+            cxoStats_setItem(dict, "rows_fetched",
+                    PyLong_FromUnsignedLongLong(stats->numRowsFetched)) < 0 ||
+            cxoStats_setItem(dict, "define_bytes",
+                    PyLong_FromUnsignedLongLong(stats->numDefineBytes)) < 0 ||
+            cxoStats_setItem(dict, "bind_reallocations",
+                    PyLong_FromUnsignedLongLong(
+                            stats->numBindReallocations)) < 0 ||
+            cxoStats_setItem(dict, "wait_time",
+                    PyFloat_FromDouble((double) stats->waitTime / 1e9)) < 0 ||
+            cxoStats_setItem(dict, "conversion_time",
+                    PyFloat_FromDouble(
+                            (double) stats->conversionTime / 1e9)) < 0) {
+        Py_DECREF(dict);
+        return NULL;
+    }
+
+    return dict;
+}
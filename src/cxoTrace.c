@@ -0,0 +1,179 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2021, Oracle and/or its affiliates. All rights reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// cxoTrace.c
+//   Defines routines for delivering trace events for blocking calls to a
+// hook registered by the application. When no hook is registered the only
+// cost incurred by callers is a check of the global hook pointer. Operations
+// performed by the hook itself are not traced.
+//-----------------------------------------------------------------------------
+
+#include "cxoModule.h"
+
+//-----------------------------------------------------------------------------
+// Globals
+//-----------------------------------------------------------------------------
+PyObject *cxoTraceHook = NULL;
+static PyObject *cxoTraceEvents = NULL;
+static Py_ssize_t cxoTraceBatchSize = 1;
+static PyObject *cxoTraceDeliveringKey = NULL;
+static const char *cxoTraceOpNames[] = {
+    "prepare",
+    "parse",
+    "execute",
+    "executemany",
+    "fetch",
+    "commit",
+    "rollback",
+    "lob_read",
+    "lob_write",
+    "enqueue",
+    "dequeue",
+    "acquire"
+};
+
+
+//-----------------------------------------------------------------------------
+// cxoTrace_isDelivering()
+//   Return a boolean indicating if the calling thread is currently delivering
+// events to the hook. This is tracked in the thread state dictionary since
+// the hook may release the GIL and other threads must still be traced.
+//-----------------------------------------------------------------------------
+static int cxoTrace_isDelivering(void)
+{
+    PyObject *dict;
+
+    dict = PyThreadState_GetDict();
+    return (dict && PyDict_GetItem(dict, cxoTraceDeliveringKey) != NULL);
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoTrace_deliver()
+//   Deliver the events (a single event or a list of events) to the hook. Any
+// exception raised by the hook is reported as unraisable since the tracing
+// of an operation must not change its outcome. While the hook is being
+// called, the calling thread is marked as delivering so that any operations
+// performed by the hook are not traced, which would otherwise recurse.
+//-----------------------------------------------------------------------------
+static void cxoTrace_deliver(PyObject *hook, PyObject *events)
+{
+    PyObject *result, *dict;
+
+    dict = PyThreadState_GetDict();
+    if (!dict || PyDict_SetItem(dict, cxoTraceDeliveringKey, Py_True) < 0) {
+        PyErr_WriteUnraisable(hook);
+        return;
+    }
+    Py_INCREF(hook);
+    result = PyObject_CallFunctionObjArgs(hook, events, NULL);
+    if (!result)
+        PyErr_WriteUnraisable(hook);
+    Py_XDECREF(result);
+    Py_DECREF(hook);
+    if (PyDict_DelItem(dict, cxoTraceDeliveringKey) < 0)
+        PyErr_WriteUnraisable(hook);
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoTrace_flush()
+//   Deliver any events that have been batched to the hook. Nothing is done
+// if called by the hook itself; the events are delivered by a later flush.
+//-----------------------------------------------------------------------------
+int cxoTrace_flush(void)
+{
+    PyObject *events;
+
+    if (!cxoTraceHook || !cxoTraceEvents ||
+            PyList_GET_SIZE(cxoTraceEvents) == 0 || cxoTrace_isDelivering())
+        return 0;
+    events = cxoTraceEvents;
+    cxoTraceEvents = PyList_New(0);
+    if (!cxoTraceEvents) {
+        cxoTraceEvents = events;
+        return -1;
+    }
+    cxoTrace_deliver(cxoTraceHook, events);
+    Py_DECREF(events);
+    return 0;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoTrace_record()
+//   Record an event for an operation that started at the specified time. The
+// statement and tag may be NULL if not applicable to the operation. Any
+// exception raised by the operation being traced is preserved; since the hook
+// may make calls into ODPI-C, callers must raise any ODPI-C error before
+// recording the event.
+//-----------------------------------------------------------------------------
+void cxoTrace_record(cxoTraceOp op, PyObject *statement, PyObject *tag,
+        uint64_t startTime, uint64_t numRows)
+{
+    PyObject *event, *excType, *excValue, *excTraceback;
+    double elapsed;
+
+    if (!cxoTraceHook || cxoTrace_isDelivering())
+        return;
+    elapsed = (double) (cxoUtils_getMonotonicTime() - startTime) / 1e9;
+    PyErr_Fetch(&excType, &excValue, &excTraceback);
+    event = Py_BuildValue("(sOOdK)", cxoTraceOpNames[op],
+            (statement) ? statement : Py_None, (tag) ? tag : Py_None,
+            elapsed, (unsigned long long) numRows);
+    if (!event) {
+        PyErr_WriteUnraisable(cxoTraceHook);
+    } else if (cxoTraceBatchSize <= 1) {
+        cxoTrace_deliver(cxoTraceHook, event);
+    } else if (PyList_Append(cxoTraceEvents, event) < 0) {
+        PyErr_WriteUnraisable(cxoTraceHook);
+    } else if (PyList_GET_SIZE(cxoTraceEvents) >= cxoTraceBatchSize) {
+        if (cxoTrace_flush() < 0)
+            PyErr_WriteUnraisable(cxoTraceHook);
+    }
+    Py_XDECREF(event);
+    PyErr_Restore(excType, excValue, excTraceback);
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoTrace_setHook()
+//   Set (or clear, if the hook is None) the hook to which trace events are
+// delivered. If the batch size is greater than one, events are accumulated
+// and delivered to the hook as a list once the batch size is reached;
+// otherwise, each event is delivered to the hook as soon as it occurs. Any
+// events batched for a previous hook are delivered to it first.
+//-----------------------------------------------------------------------------
+int cxoTrace_setHook(PyObject *hook, Py_ssize_t batchSize)
+{
+    if (hook != Py_None && !PyCallable_Check(hook)) {
+        PyErr_SetString(PyExc_TypeError, "expecting a callable or None");
+        return -1;
+    }
+    if (batchSize < 1) {
+        PyErr_SetString(PyExc_ValueError, "batch_size must be at least 1");
+        return -1;
+    }
+    if (!cxoTraceDeliveringKey) {
+        cxoTraceDeliveringKey =
+                PyUnicode_InternFromString("cx_Oracle.trace_delivering");
+        if (!cxoTraceDeliveringKey)
+            return -1;
+    }
+    if (cxoTrace_flush() < 0)
+        return -1;
+    if (batchSize > 1 && !cxoTraceEvents) {
+        cxoTraceEvents = PyList_New(0);
+        if (!cxoTraceEvents)
+            return -1;
+    }
+    Py_CLEAR(cxoTraceHook);
+    if (hook != Py_None) {
+        Py_INCREF(hook);
+        cxoTraceHook = hook;
+    }
+    cxoTraceBatchSize = batchSize;
+    return 0;
+}
@@ -299,12 +299,8 @@ int cxoTransform_fromPython(cxoTransformNum transformNum,
             if (cxoBuffer_fromObject(buffer, pyValue, encoding) < 0)
                 return -1;
             if (var) {
-                Py_BEGIN_ALLOW_THREADS
-                status = dpiLob_setFromBytes(dbValue->asLOB, buffer->ptr,
-                        buffer->size);
-                Py_END_ALLOW_THREADS
-                if (status < 0)
-                    return cxoError_raiseAndReturnInt();
+                if (cxoVar_setValueLob(var, arrayPos, buffer) < 0)
+                    return -1;
             } else {
                 *nativeTypeNum = DPI_NATIVE_TYPE_BYTES;
                 dbValue->asBytes.ptr = (char*) buffer->ptr;
@@ -9,6 +9,25 @@
 
 #include "cxoModule.h"
 
+#include <errno.h>
+#include <fcntl.h>
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//-----------------------------------------------------------------------------
+// structure used to pass the function and argument to a native thread
+//-----------------------------------------------------------------------------
+typedef struct {
+    void (*func)(void*);
+    void *arg;
+} cxoThreadStart;
+
 //-----------------------------------------------------------------------------
 // cxoUtils_convertOciAttrToPythonValue()
 //   Convert the OCI attribute value to an equivalent Python value using the
@@ -197,6 +216,421 @@ int cxoUtils_getModuleAndName(PyTypeObject *type, PyObject **module,
 }
 
 
+//-----------------------------------------------------------------------------
+// cxoUtils_getMonotonicTime()
+//   Return the value of a monotonic clock in nanoseconds. This is used for
+// measuring elapsed times only; the value itself has no meaning. It may be
+// called without holding the GIL.
+//-----------------------------------------------------------------------------
+uint64_t cxoUtils_getMonotonicTime(void)
+{
+#ifdef _WIN32
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+
+    if (frequency.QuadPart == 0)
+        QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (uint64_t) ((double) counter.QuadPart * 1e9 /
+            (double) frequency.QuadPart);
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000 + (uint64_t) ts.tv_nsec;
+#endif
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoUtils_closeFile()
+//   Close a file opened by cxoUtils_openFile(), if it was opened by that
+// function. The GIL need not be held by the caller.
+//-----------------------------------------------------------------------------
+void cxoUtils_closeFile(int fd, int closeFd)
+{
+    if (!closeFd)
+        return;
+#ifdef _WIN32
+    _close(fd);
+#else
+    close(fd);
+#endif
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoUtils_crc32c()
+//   Update the CRC-32C (Castagnoli) checksum with the given data and return
+// the new checksum; the initial checksum is zero. The lookup table is built on
+// the first call, which must be made while holding the GIL; subsequent calls
+// need not hold it.
+//-----------------------------------------------------------------------------
+uint32_t cxoUtils_crc32c(uint32_t crc, const char *data, size_t length)
+{
+    static uint32_t table[256];
+    static int tableInitialized = 0;
+    const unsigned char *ptr = (const unsigned char*) data;
+    uint32_t i, j, value;
+
+    if (!tableInitialized) {
+        for (i = 0; i < 256; i++) {
+            value = i;
+            for (j = 0; j < 8; j++)
+                value = (value & 1) ? (value >> 1) ^ 0x82F63B78 : value >> 1;
+            table[i] = value;
+        }
+        tableInitialized = 1;
+    }
+    crc = ~crc;
+    while (length-- > 0)
+        crc = table[(crc ^ *ptr++) & 0xff] ^ (crc >> 8);
+    return ~crc;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoUtils_createFile()
+//   Create (or truncate) the file with the given path, which must have been
+// returned by cxoUtils_encodePath(), and open it for writing. On error, -1 is
+// returned and errno is set; no Python exception is raised, so this may be
+// called without holding the GIL.
+//-----------------------------------------------------------------------------
+int cxoUtils_createFile(const void *path)
+{
+    int flags = O_WRONLY | O_CREAT | O_TRUNC;
+#ifdef _WIN32
+    return _wopen((const wchar_t*) path, flags | _O_BINARY,
+            _S_IREAD | _S_IWRITE);
+#else
+    int fd;
+
+    do {
+        fd = open((const char*) path, flags, 0666);
+    } while (fd < 0 && errno == EINTR);
+    return fd;
+#endif
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoUtils_encodePath()
+//   Return a copy of the given path (str, bytes or path-like object) encoded
+// in the form expected by the operating system, so that the file can later be
+// created without holding the GIL. The copy must be freed by the caller with
+// PyMem_Free(); NULL is returned if an exception was raised.
+//-----------------------------------------------------------------------------
+void *cxoUtils_encodePath(PyObject *pathObj)
+{
+    PyObject *encodedPathObj;
+    void *path;
+#ifndef _WIN32
+    Py_ssize_t size;
+#endif
+
+#ifdef _WIN32
+    if (!PyUnicode_FSDecoder(pathObj, &encodedPathObj))
+        return NULL;
+    path = PyUnicode_AsWideCharString(encodedPathObj, NULL);
+#else
+    if (!PyUnicode_FSConverter(pathObj, &encodedPathObj))
+        return NULL;
+    size = PyBytes_GET_SIZE(encodedPathObj) + 1;
+    path = PyMem_Malloc((size_t) size);
+    if (!path)
+        PyErr_NoMemory();
+    else memcpy(path, PyBytes_AS_STRING(encodedPathObj), (size_t) size);
+#endif
+    Py_DECREF(encodedPathObj);
+    return path;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoUtils_getFilePosition()
+//   Return the current position of the file, or -1 if the file does not
+// support positioned reads and writes, in which case it is read or written
+// sequentially instead.
+//-----------------------------------------------------------------------------
+int64_t cxoUtils_getFilePosition(int fd)
+{
+#ifdef _WIN32
+    return -1;
+#else
+    return (int64_t) lseek(fd, 0, SEEK_CUR);
+#endif
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoUtils_getFileSize()
+//   Return the size of the file, or -1 if the size cannot be determined or
+// the file does not support positioned reads and writes.
+//-----------------------------------------------------------------------------
+int64_t cxoUtils_getFileSize(int fd)
+{
+#ifdef _WIN32
+    return -1;
+#else
+    struct stat info;
+
+    if (fstat(fd, &info) < 0 || !S_ISREG(info.st_mode))
+        return -1;
+    return (int64_t) info.st_size;
+#endif
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoUtils_openFile()
+//   Return a file descriptor for the given object, which may be a path (str,
+// bytes or path-like object), a file descriptor or an object with a fileno()
+// method. Paths are opened for reading or for writing (creating or truncating
+// the file as needed) and must be closed again by the caller; the flag
+// closeFd is set to indicate this.
+//-----------------------------------------------------------------------------
+int cxoUtils_openFile(PyObject *fileObj, int forWriting, int *fd,
+        int *closeFd)
+{
+    PyObject *pathObj;
+    int flags;
+#ifdef _WIN32
+    wchar_t *path;
+#endif
+
+    // file descriptors and objects with a fileno() method are used directly
+    *closeFd = 0;
+    if (!PyUnicode_Check(fileObj) && !PyBytes_Check(fileObj) &&
+            !PyObject_HasAttrString(fileObj, "__fspath__")) {
+        *fd = PyObject_AsFileDescriptor(fileObj);
+        return (*fd < 0) ? -1 : 0;
+    }
+
+    // otherwise, open the file
+    flags = (forWriting) ? O_WRONLY | O_CREAT | O_TRUNC : O_RDONLY;
+#ifdef _WIN32
+    if (!PyUnicode_FSDecoder(fileObj, &pathObj))
+        return -1;
+    path = PyUnicode_AsWideCharString(pathObj, NULL);
+    if (!path) {
+        Py_DECREF(pathObj);
+        return -1;
+    }
+    Py_BEGIN_ALLOW_THREADS
+    *fd = _wopen(path, flags | _O_BINARY, _S_IREAD | _S_IWRITE);
+    Py_END_ALLOW_THREADS
+    PyMem_Free(path);
+#else
+    if (!PyUnicode_FSConverter(fileObj, &pathObj))
+        return -1;
+    Py_BEGIN_ALLOW_THREADS
+    *fd = open(PyBytes_AS_STRING(pathObj), flags, 0666);
+    Py_END_ALLOW_THREADS
+#endif
+    if (*fd < 0) {
+        PyErr_SetFromErrnoWithFilenameObject(PyExc_OSError, fileObj);
+        Py_DECREF(pathObj);
+        return -1;
+    }
+    Py_DECREF(pathObj);
+    *closeFd = 1;
+    return 0;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoUtils_readFile()
+//   Read up to the given number of bytes from the file at the given position,
+// or from the current position if the position is negative. Fewer bytes are
+// returned only when the end of the file is reached. On error, -1 is returned
+// and errno is set; no Python exception is raised, so this may be called
+// without holding the GIL.
+//-----------------------------------------------------------------------------
+int64_t cxoUtils_readFile(int fd, char *buffer, size_t size,
+        int64_t position)
+{
+    int64_t numRead, totalRead = 0;
+
+    while ((size_t) totalRead < size) {
+#ifdef _WIN32
+        numRead = _read(fd, buffer + totalRead,
+                (unsigned) min(size - totalRead, INT_MAX));
+#else
+        if (position >= 0)
+            numRead = pread(fd, buffer + totalRead, size - totalRead,
+                    (off_t) (position + totalRead));
+        else numRead = read(fd, buffer + totalRead, size - totalRead);
+        if (numRead < 0 && errno == EINTR)
+            continue;
+#endif
+        if (numRead < 0)
+            return -1;
+        if (numRead == 0)
+            break;
+        totalRead += numRead;
+    }
+
+    return totalRead;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoUtils_setFilePosition()
+//   Set the position of the file after it has been accessed with positioned
+// reads or writes, so that it is left as though it had been read or written
+// sequentially. Nothing is done if positioned access was not used.
+//-----------------------------------------------------------------------------
+void cxoUtils_setFilePosition(int fd, int64_t position)
+{
+#ifndef _WIN32
+    if (position >= 0)
+        lseek(fd, (off_t) position, SEEK_SET);
+#endif
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoUtils_writeFile()
+//   Write all of the given bytes to the file at the given position, or at
+// the current position if the position is negative. On error, -1 is returned
+// and errno is set; no Python exception is raised, so this may be called
+// without holding the GIL.
+//-----------------------------------------------------------------------------
+int cxoUtils_writeFile(int fd, const char *buffer, size_t size,
+        int64_t position)
+{
+    int64_t numWritten;
+    size_t totalWritten = 0;
+
+    while (totalWritten < size) {
+#ifdef _WIN32
+        numWritten = _write(fd, buffer + totalWritten,
+                (unsigned) min(size - totalWritten, INT_MAX));
+#else
+        if (position >= 0)
+            numWritten = pwrite(fd, buffer + totalWritten,
+                    size - totalWritten,
+                    (off_t) (position + totalWritten));
+        else numWritten = write(fd, buffer + totalWritten,
+                size - totalWritten);
+        if (numWritten < 0 && errno == EINTR)
+            continue;
+#endif
+        if (numWritten < 0)
+            return -1;
+        totalWritten += (size_t) numWritten;
+    }
+
+    return 0;
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoUtils_detachThread()
+//   Detach the native thread so that its resources are released when it
+// terminates, without waiting for it.
+//-----------------------------------------------------------------------------
+void cxoUtils_detachThread(cxoThread thread)
+{
+#ifdef _WIN32
+    CloseHandle((HANDLE) thread);
+#else
+    pthread_detach(thread);
+#endif
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoUtils_joinThread()
+//   Wait for the native thread to terminate. The GIL should not be held by
+// the caller if the thread might need it.
+//-----------------------------------------------------------------------------
+void cxoUtils_joinThread(cxoThread thread)
+{
+#ifdef _WIN32
+    WaitForSingleObject((HANDLE) thread, INFINITE);
+    CloseHandle((HANDLE) thread);
+#else
+    pthread_join(thread, NULL);
+#endif
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoUtils_runThread()
+//   Entry point for native threads which calls the function supplied to
+// cxoUtils_startThread().
+//-----------------------------------------------------------------------------
+#ifdef _WIN32
+static DWORD WINAPI cxoUtils_runThread(LPVOID arg)
+#else
+static void *cxoUtils_runThread(void *arg)
+#endif
+{
+    cxoThreadStart start = *((cxoThreadStart*) arg);
+
+    free(arg);
+    (*start.func)(start.arg);
+#ifdef _WIN32
+    return 0;
+#else
+    return NULL;
+#endif
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoUtils_sleep()
+//   Suspend the calling thread for the given number of milliseconds. The GIL
+// should not be held by the caller.
+//-----------------------------------------------------------------------------
+void cxoUtils_sleep(uint32_t milliseconds)
+{
+#ifdef _WIN32
+    Sleep(milliseconds);
+#else
+    struct timespec ts;
+
+    ts.tv_sec = milliseconds / 1000;
+    ts.tv_nsec = (long) (milliseconds % 1000) * 1000000;
+    nanosleep(&ts, NULL);
+#endif
+}
+
+
+//-----------------------------------------------------------------------------
+// cxoUtils_startThread()
+//   Start a native thread which calls the given function with the given
+// argument. The function must not make use of the Python interpreter. No
+// Python exception is set if the thread cannot be started, so this may be
+// called without holding the GIL.
+//-----------------------------------------------------------------------------
+int cxoUtils_startThread(cxoThread *thread, void (*func)(void*), void *arg)
+{
+    cxoThreadStart *start;
+
+    start = malloc(sizeof(cxoThreadStart));
+    if (!start)
+        return -1;
+    start->func = func;
+    start->arg = arg;
+#ifdef _WIN32
+    *thread = (cxoThread) CreateThread(NULL, 0, cxoUtils_runThread, start, 0,
+            NULL);
+    if (!*thread) {
+        free(start);
+        return -1;
+    }
+#else
+    if (pthread_create(thread, NULL, cxoUtils_runThread, start) != 0) {
+        free(start);
+        return -1;
+    }
+#endif
+    return 0;
+}
+
+
 //-----------------------------------------------------------------------------
 // cxoUtils_initializeDPI()
 //   Initialize the ODPI-C library. This is done when the first standalone
@@ -14,6 +14,15 @@
 
 #include "cxoModule.h"
 
+//-----------------------------------------------------------------------------
+// free list of variable objects which have been deallocated and are available
+// for reuse; this avoids the cost of allocating a new object for each column
+// of each query executed
+//-----------------------------------------------------------------------------
+#define CXO_VAR_FREE_LIST_SIZE          64
+static cxoVar *cxoVarFreeList[CXO_VAR_FREE_LIST_SIZE];
+static int cxoVarNumFree = 0;
+
 //-----------------------------------------------------------------------------
 // cxoVar_new()
 //   Allocate a new variable.
@@ -26,10 +35,18 @@ cxoVar *cxoVar_new(cxoCursor *cursor, Py_ssize_t numElements,
     dpiOracleTypeNum oracleTypeNum;
     cxoVar *var;
 
+    // reuse an object from the free list, if one is available; otherwise,
     // attempt to allocate the object
-    var = (cxoVar*) cxoPyTypeVar.tp_alloc(&cxoPyTypeVar, 0);
-    if (!var)
-        return NULL;
+    if (cxoVarNumFree > 0) {
+        var = cxoVarFreeList[--cxoVarNumFree];
+        memset((char*) var + sizeof(PyObject), 0,
+                sizeof(cxoVar) - sizeof(PyObject));
+        PyObject_Init((PyObject*) var, &cxoPyTypeVar);
+    } else {
+        var = (cxoVar*) cxoPyTypeVar.tp_alloc(&cxoPyTypeVar, 0);
+        if (!var)
+            return NULL;
+    }
 
     // perform basic initialization
     Py_INCREF(cursor->connection);
@@ -78,6 +95,31 @@ cxoVar *cxoVar_new(cxoCursor *cursor, Py_ssize_t numElements,
 }
 
 
+//-----------------------------------------------------------------------------
+// cxoVar_releasePooledLobs()
+//   Release the temporary LOBs acquired from the connection's pool for the
+// values bound by the variable. They are returned to the pool if requested;
+// otherwise, the variable remains their only owner.
+//-----------------------------------------------------------------------------
+static void cxoVar_releasePooledLobs(cxoVar *var, int returnToPool)
+{
+    uint32_t i;
+
+    if (!var->pooledLobs)
+        return;
+    for (i = 0; i < var->allocatedElements; i++) {
+        if (!var->pooledLobs[i])
+            continue;
+        if (returnToPool)
+            cxoConnection_releaseTempLob(var->connection, var->pooledLobs[i],
+                    var->dbType->num);
+        else dpiLob_release(var->pooledLobs[i]);
+    }
+    PyMem_Free(var->pooledLobs);
+    var->pooledLobs = NULL;
+}
+
+
 //-----------------------------------------------------------------------------
 // cxoVar_free()
 //   Free an existing variable.
@@ -90,6 +132,7 @@ static void cxoVar_free(cxoVar *var)
         Py_END_ALLOW_THREADS
         var->handle = NULL;
     }
+    cxoVar_releasePooledLobs(var, 1);
     if (var->encodingErrors)
         PyMem_Free((void*) var->encodingErrors);
     Py_CLEAR(var->connection);
@@ -97,6 +140,10 @@ static void cxoVar_free(cxoVar *var)
     Py_CLEAR(var->outConverter);
     Py_CLEAR(var->objectType);
     Py_CLEAR(var->dbType);
+    if (cxoVarNumFree < CXO_VAR_FREE_LIST_SIZE) {
+        cxoVarFreeList[cxoVarNumFree++] = var;
+        return;
+    }
     Py_TYPE(var)->tp_free((PyObject*) var);
 }
 
@@ -267,6 +314,14 @@ int cxoVar_bind(cxoVar *var, cxoCursor *cursor, PyObject *name, uint32_t pos)
     if (cursor->stmtInfo.isReturning && !var->isValueSet)
         var->getReturnedData = 1;
 
+    // LOBs bound to PL/SQL or DML returning statements may be replaced by
+    // the database, so temporary LOBs from the connection's pool are not
+    // used for them
+    if (cursor->stmtInfo.isPLSQL || cursor->stmtInfo.isReturning) {
+        var->lobPoolDisabled = 1;
+        cxoVar_releasePooledLobs(var, 0);
+    }
+
     return 0;
 }
 
@@ -338,6 +393,14 @@ PyObject *cxoVar_getSingleValue(cxoVar *var, dpiData *data, uint32_t arrayPos)
             default:
                 break;
         }
+        if (var->inlineLobSize > 0) {
+            result = cxoLob_getInlineValue((cxoLob*) value,
+                    var->inlineLobSize);
+            Py_DECREF(value);
+            if (!result)
+                return NULL;
+            value = result;
+        }
         if (var->outConverter && var->outConverter != Py_None) {
             result = PyObject_CallFunctionObjArgs(var->outConverter, value,
                     NULL);
@@ -574,6 +637,66 @@ int cxoVar_setValue(cxoVar *var, uint32_t arrayPos, PyObject *value)
 }
 
 
+//-----------------------------------------------------------------------------
+// cxoVar_setValueLob()
+//   Set the value of the variable at the given position to the contents of
+// the buffer. If the connection retains a pool of temporary LOBs and the
+// value is not too large, a temporary LOB from the pool is trimmed and
+// rewritten instead of a new temporary LOB being created for the value. The
+// LOB is kept by the variable for subsequent values at the same position and
+// returned to the pool when the variable is freed.
+//-----------------------------------------------------------------------------
+int cxoVar_setValueLob(cxoVar *var, uint32_t arrayPos, cxoBuffer *buffer)
+{
+    cxoConnection *conn = var->connection;
+    dpiLob *handle;
+    int status;
+
+    // if the pool is not being used, set the value directly
+    if (var->lobPoolDisabled || conn->tempLobPoolSize == 0 ||
+            (conn->tempLobMaxSize > 0 &&
+             buffer->size > conn->tempLobMaxSize)) {
+        Py_BEGIN_ALLOW_THREADS
+        status = dpiLob_setFromBytes(var->data[arrayPos].value.asLOB,
+                buffer->ptr, buffer->size);
+        Py_END_ALLOW_THREADS
+        if (status < 0)
+            return cxoError_raiseAndReturnInt();
+        return 0;
+    }
+
+    // acquire a LOB from the pool, if one has not already been acquired for
+    // this position
+    if (!var->pooledLobs) {
+        var->pooledLobs = PyMem_Calloc(var->allocatedElements,
+                sizeof(dpiLob*));
+        if (!var->pooledLobs) {
+            PyErr_NoMemory();
+            return -1;
+        }
+    }
+    handle = var->pooledLobs[arrayPos];
+    if (!handle) {
+        handle = cxoConnection_acquireTempLob(conn, var->dbType->num);
+        if (!handle)
+            return -1;
+        var->pooledLobs[arrayPos] = handle;
+    }
+
+    // replace the contents of the LOB and bind it
+    Py_BEGIN_ALLOW_THREADS
+    status = dpiLob_trim(handle, 0);
+    if (status == DPI_SUCCESS && buffer->size > 0)
+        status = dpiLob_writeBytes(handle, 1, buffer->ptr, buffer->size);
+    Py_END_ALLOW_THREADS
+    if (status < 0)
+        return cxoError_raiseAndReturnInt();
+    if (dpiVar_setFromLob(var->handle, arrayPos, handle) < 0)
+        return cxoError_raiseAndReturnInt();
+    return 0;
+}
+
+
 //-----------------------------------------------------------------------------
 // cxoVar_externalCopy()
 //   Copy the contents of the source variable to the destination variable.
@@ -0,0 +1,244 @@
+#------------------------------------------------------------------------------
+# Copyright (c) 2021, Oracle and/or its affiliates. All rights reserved.
+#------------------------------------------------------------------------------
+
+#------------------------------------------------------------------------------
+# benchmark.py
+#
+# Measures the cost of fetching each column type and of binding each bind
+# type with executemany() against the schema created by setup_test.py. The
+# cursor statistics are used to separate the time spent converting values
+# from the time spent waiting for the database so that regressions in the
+# conversion and bind paths are visible even on a noisy network. Results can
+# be saved to a JSON file and compared with the results of a previous run in
+# order to track them over time, as in:
+#
+#     python benchmark.py --output before.json
+#     python benchmark.py --compare before.json
+#------------------------------------------------------------------------------
+
+import argparse
+import datetime
+import decimal
+import json
+import statistics
+import sys
+import time
+
+import cx_Oracle as oracledb
+import test_env
+
+# benchmarks for fetching; each entry contains the name of the benchmark,
+# the SQL used to generate the rows (with :num_rows bound to the number of
+# rows to generate) and the minimum server version required, if any
+FETCH_BENCHMARKS = [
+    ("fetch_number", "select level from dual connect by level <= :num_rows",
+            None),
+    ("fetch_decimal",
+            "select level + 0.25 from dual connect by level <= :num_rows",
+            None),
+    ("fetch_binary_double",
+            "select to_binary_double(level) from dual "
+            "connect by level <= :num_rows", None),
+    ("fetch_varchar",
+            "select rpad('X', 50, 'Y') from dual "
+            "connect by level <= :num_rows", None),
+    ("fetch_nvarchar",
+            "select to_nchar(rpad('X', 50, 'Y')) from dual "
+            "connect by level <= :num_rows", None),
+    ("fetch_raw",
+            "select utl_raw.cast_to_raw(rpad('X', 50, 'Y')) from dual "
+            "connect by level <= :num_rows", None),
+    ("fetch_date", "select sysdate + level from dual "
+            "connect by level <= :num_rows", None),
+    ("fetch_timestamp", "select systimestamp + level from dual "
+            "connect by level <= :num_rows", None),
+    ("fetch_clob", "select to_clob(rpad('X', 500, 'Y')) from dual "
+            "connect by level <= :num_rows", None),
+    ("fetch_blob",
+            "select to_blob(utl_raw.cast_to_raw(rpad('X', 500, 'Y'))) "
+            "from dual connect by level <= :num_rows", None),
+    ("fetch_object",
+            "select udt_Building(level, 3, 'Description', sysdate) "
+            "from dual connect by level <= :num_rows", None),
+    ("fetch_json",
+            "select json_object('id' value level, 'name' value 'X' "
+            "returning json) from dual connect by level <= :num_rows",
+            (21, 1)),
+]
+
+# benchmarks for executemany(); each entry contains the name of the
+# benchmark, the PL/SQL type to which the values are bound, the type passed
+# to setinputsizes() (if any), a function that returns the value for a given
+# row and the minimum server version required, if any
+BIND_BENCHMARKS = [
+    ("bind_int", "number", None, lambda i: i, None),
+    ("bind_float", "binary_double", None, lambda i: i + 0.25, None),
+    ("bind_decimal", "number", None,
+            lambda i: decimal.Decimal(i) + decimal.Decimal("0.25"), None),
+    ("bind_str", "varchar2(100)", None, lambda i: "X" * 50, None),
+    ("bind_bytes", "raw(100)", None, lambda i: b"X" * 50, None),
+    ("bind_date", "date", None,
+            lambda i: datetime.date(2021, 1, 1 + i % 28), None),
+    ("bind_datetime", "timestamp", None,
+            lambda i: datetime.datetime(2021, 1, 1, 12, 0, i % 60), None),
+    ("bind_clob", "clob", oracledb.DB_TYPE_CLOB, lambda i: "X" * 500, None),
+    ("bind_blob", "blob", oracledb.DB_TYPE_BLOB, lambda i: b"X" * 500, None),
+    ("bind_object", "udt_Building", "UDT_BUILDING", None, None),
+    ("bind_json", "json", oracledb.DB_TYPE_JSON,
+            lambda i: dict(id=i, name="X"), (21, 1)),
+]
+
+
+class Result:
+
+    def __init__(self, name, num_rows):
+        self.name = name
+        self.num_rows = num_rows
+        self.elapsed_times = []
+        self.conversion_times = []
+        self.wait_times = []
+
+    def add(self, elapsed_time, stats):
+        self.elapsed_times.append(elapsed_time)
+        self.conversion_times.append(stats["conversion_time"])
+        self.wait_times.append(stats["wait_time"])
+
+    def to_dict(self):
+        return dict(num_rows=self.num_rows,
+                    mean=statistics.mean(self.elapsed_times),
+                    stdev=statistics.pstdev(self.elapsed_times),
+                    min=min(self.elapsed_times),
+                    conversion=statistics.mean(self.conversion_times),
+                    wait=statistics.mean(self.wait_times))
+
+
+def run_benchmark(name, num_rows, args, func):
+    result = Result(name, num_rows)
+    for i in range(args.warmups + args.repeats):
+        run = func()
+        run.cursor.stats_enabled = True
+        start_time = time.perf_counter()
+        run.run()
+        elapsed_time = time.perf_counter() - start_time
+        if i >= args.warmups:
+            result.add(elapsed_time, run.cursor.stats)
+        run.cursor.close()
+    return result
+
+
+class FetchRun:
+
+    def __init__(self, conn, sql, num_rows, array_size):
+        self.cursor = conn.cursor()
+        self.cursor.arraysize = array_size
+        self.sql = sql
+        self.num_rows = num_rows
+
+    def run(self):
+        self.cursor.execute(self.sql, num_rows=self.num_rows)
+        for row in self.cursor:
+            pass
+
+
+class BindRun(FetchRun):
+
+    def __init__(self, conn, plsql_type, input_type, data):
+        super().__init__(conn, "declare v %s; begin v := :1; end;" % \
+                plsql_type, len(data), len(data))
+        if input_type is not None:
+            self.cursor.setinputsizes(input_type)
+        self.data = data
+
+    def run(self):
+        self.cursor.executemany(self.sql, self.data)
+
+
+def create_building(obj_type, building_id):
+    obj = obj_type.newobject()
+    obj.BUILDINGID = building_id
+    obj.NUMFLOORS = 3
+    obj.DESCRIPTION = "Description"
+    obj.DATEBUILT = datetime.datetime(2021, 1, 1)
+    return obj
+
+
+def meets_version(conn, min_version):
+    if min_version is None:
+        return True
+    server_version = tuple(int(s) for s in conn.version.split("."))[:2]
+    return server_version >= min_version \
+            and test_env.get_client_version() >= min_version
+
+
+def run_benchmarks(conn, args):
+    results = []
+    for name, sql, min_version in FETCH_BENCHMARKS:
+        if not args.matches(name) or not meets_version(conn, min_version):
+            continue
+        func = lambda: FetchRun(conn, sql, args.num_rows, args.array_size)
+        results.append(run_benchmark(name, args.num_rows, args, func))
+    for name, plsql_type, input_type, value_func, min_version \
+            in BIND_BENCHMARKS:
+        if not args.matches(name) or not meets_version(conn, min_version):
+            continue
+        if isinstance(input_type, str):
+            input_type = conn.gettype(input_type)
+            value_func = lambda i: create_building(input_type, i)
+        data = [(value_func(i),) for i in range(args.num_rows)]
+        func = lambda: BindRun(conn, plsql_type, input_type, data)
+        results.append(run_benchmark(name, args.num_rows, args, func))
+    return results
+
+
+def report(results, baseline):
+    fmt = "%-22s %10s %10s %10s %10s %9s"
+    print(fmt % ("Benchmark", "Mean (ms)", "Min (ms)", "Conv (ms)",
+                 "Wait (ms)", "Change"))
+    for name, result in results.items():
+        change = ""
+        prev_result = baseline.get(name)
+        if prev_result is not None and prev_result["mean"] > 0:
+            change = "%+.1f%%" % \
+                    ((result["mean"] / prev_result["mean"] - 1) * 100)
+        print(fmt % (name, "%.3f" % (result["mean"] * 1000),
+                     "%.3f" % (result["min"] * 1000),
+                     "%.3f" % (result["conversion"] * 1000),
+                     "%.3f" % (result["wait"] * 1000), change))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="cx_Oracle benchmarks")
+    parser.add_argument("names", nargs="*",
+            help="run only benchmarks whose names contain these strings")
+    parser.add_argument("--num-rows", type=int, default=10000)
+    parser.add_argument("--array-size", type=int, default=500)
+    parser.add_argument("--repeats", type=int, default=5)
+    parser.add_argument("--warmups", type=int, default=1)
+    parser.add_argument("--output", help="save the results to this file")
+    parser.add_argument("--compare",
+            help="compare the results with those saved in this file")
+    args = parser.parse_args()
+    args.matches = lambda name: not args.names or \
+            any(s in name for s in args.names)
+
+    conn = test_env.get_connection()
+    results = run_benchmarks(conn, args)
+    result_dict = dict((r.name, r.to_dict()) for r in results)
+    baseline = {}
+    if args.compare:
+        with open(args.compare) as f:
+            baseline = json.load(f)["results"]
+    report(result_dict, baseline)
+    if args.output:
+        data = dict(version=oracledb.version,
+                    client_version=oracledb.clientversion(),
+                    server_version=conn.version,
+                    python_version=sys.version.split()[0],
+                    timestamp=datetime.datetime.now().isoformat(),
+                    results=result_dict)
+        with open(args.output, "w") as f:
+            json.dump(data, f, indent=4)
+
+if __name__ == "__main__":
+    main()
@@ -589,5 +589,140 @@ class TestCase(test_env.BaseTestCase):
         self.assertRaises(oracledb.DatabaseError, conn.cursor().callproc,
                           test_env.get_sleep_proc_name(), [2])
 
+    def test_1136_trace_hook(self):
+        "1136 - test trace hook receives events for blocking calls"
+        conn = test_env.get_connection()
+        cursor = conn.cursor()
+        events = []
+        oracledb.set_trace_hook(events.append)
+        try:
+            cursor.execute("select 1 from dual")
+            cursor.fetchall()
+            conn.commit()
+        finally:
+            oracledb.set_trace_hook(None)
+        ops = [e[0] for e in events]
+        self.assertEqual(ops, ["prepare", "execute", "fetch", "commit"])
+        op, statement, tag, elapsed, num_rows = events[1]
+        self.assertEqual(statement, "select 1 from dual")
+        self.assertEqual(tag, None)
+        self.assertTrue(elapsed >= 0)
+        self.assertEqual(events[2][4], 1)
+        cursor.execute("select 1 from dual")
+        self.assertEqual(len(events), 4)
+
+        # operations performed by the hook are not traced and the errors of
+        # the operation being traced are not replaced by the hook
+        hook_cursor = conn.cursor()
+        def hook(event):
+            events.append(event)
+            hook_cursor.execute("select 1 from dual")
+        events.clear()
+        oracledb.set_trace_hook(hook)
+        try:
+            with self.assertRaisesRegex(oracledb.DatabaseError, "^ORA-00942:"):
+                cursor.execute("select * from TestMissingTable")
+            conn.commit()
+        finally:
+            oracledb.set_trace_hook(None)
+        self.assertEqual([e[0] for e in events],
+                         ["prepare", "execute", "commit"])
+        self.assertEqual(events[1][4], 0)
+
+    def test_1137_trace_hook_batch(self):
+        "1137 - test trace hook with batched delivery"
+        conn = test_env.get_connection()
+        batches = []
+        oracledb.set_trace_hook(batches.append, batch_size=3)
+        try:
+            conn.commit()
+            conn.rollback()
+            self.assertEqual(batches, [])
+            oracledb.flush_trace_events()
+            self.assertEqual(len(batches), 1)
+            self.assertEqual([e[0] for e in batches[0]],
+                             ["commit", "rollback"])
+            for i in range(3):
+                conn.commit()
+            self.assertEqual(len(batches), 2)
+            self.assertEqual(len(batches[1]), 3)
+        finally:
+            oracledb.set_trace_hook(None)
+        self.assertRaises(TypeError, oracledb.set_trace_hook, 5)
+        self.assertRaises(ValueError, oracledb.set_trace_hook, batches.append,
+                          batch_size=0)
+
+    def test_1138_connect_many(self):
+        "1138 - test creating multiple connections concurrently"
+        conns = oracledb.connect_many(4, test_env.get_main_user(),
+                                      test_env.get_main_password(),
+                                      test_env.get_connect_string())
+        self.assertEqual(len(conns), 4)
+        sids = set()
+        for conn in conns:
+            self.assertEqual(conn.username, test_env.get_main_user())
+            cursor = conn.cursor()
+            cursor.execute("select sys_context('userenv', 'sid') from dual")
+            sids.add(cursor.fetchone()[0])
+        self.assertEqual(len(sids), 4)
+        self.assertRaises(oracledb.DatabaseError, oracledb.connect_many, 2,
+                          test_env.get_main_user(),
+                          test_env.get_main_password() + "X",
+                          test_env.get_connect_string())
+        self.assertRaises(oracledb.ProgrammingError, oracledb.connect_many,
+                          0, test_env.get_main_user(),
+                          test_env.get_main_password(),
+                          test_env.get_connect_string())
+
+    def test_1139_session_info(self):
+        "1139 - test session_info() and cached session properties"
+        conn = test_env.get_connection()
+        version = conn.version
+        self.assertIs(conn.version, version)
+        self.assertIs(conn.encoding, conn.encoding)
+        info = conn.session_info()
+        self.assertEqual(info["version"], version)
+        self.assertEqual(info["version_info"],
+                         tuple(int(s) for s in version.split(".")))
+        self.assertEqual(info["encoding"], conn.encoding)
+        self.assertEqual(info["nencoding"], conn.nencoding)
+        self.assertEqual(info["max_bytes_per_character"],
+                         conn.maxBytesPerCharacter)
+        self.assertEqual(info["username"], test_env.get_main_user())
+        self.assertEqual(info["dsn"], test_env.get_connect_string())
+        self.assertEqual(info["stmtcachesize"], conn.stmtcachesize)
+        self.assertEqual(info["autocommit"], False)
+        self.assertEqual(info["tag"], None)
+        conn.close()
+        self.assertRaises(oracledb.InterfaceError, conn.session_info)
+
+    def test_1140_temp_lob_pool(self):
+        "1140 - test reuse of temporary LOBs when binding values"
+        conn = test_env.get_connection()
+        self.assertEqual(conn.temp_lob_pool_size, 0)
+        conn.temp_lob_pool_size = 5
+        conn.temp_lob_max_size = 100000
+        cursor = conn.cursor()
+        cursor.execute("truncate table TestCLOBs")
+        for i in range(10):
+            cursor = conn.cursor()
+            cursor.setinputsizes(None, oracledb.DB_TYPE_CLOB)
+            cursor.execute("insert into TestCLOBs values (:1, :2)",
+                           [i, "Value %d" % i])
+        cursor.setinputsizes(None, oracledb.DB_TYPE_CLOB)
+        cursor.execute("insert into TestCLOBs values (:1, :2)",
+                       [10, "X" * 200000])
+        cursor.execute("select count(*) from TestCLOBs")
+        self.assertEqual(cursor.fetchone(), (11,))
+        stats = conn.temp_lob_stats
+        self.assertEqual(stats["created"], 1)
+        self.assertEqual(stats["reused"], 9)
+        del cursor
+        self.assertEqual(conn.temp_lob_stats["pooled"], 1)
+        conn.temp_lob_pool_size = 0
+        self.assertEqual(conn.temp_lob_stats["pooled"], 0)
+        conn.rollback()
+        conn.close()
+
 if __name__ == "__main__":
     test_env.run_test_cases()
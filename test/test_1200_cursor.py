@@ -1031,5 +1031,101 @@ class TestCase(test_env.BaseTestCase):
                           "func_Test", oracledb.NUMBER, [], kwargs,
                           keywordParameters=kwargs)
 
+    def test_1288_stats(self):
+        "1288 - test execution statistics collected by the cursor"
+        cursor = self.connection.cursor()
+        self.assertEqual(cursor.stats_enabled, False)
+        cursor.execute("select IntCol from TestNumbers")
+        cursor.fetchall()
+        self.assertEqual(cursor.stats["fetch_calls"], 0)
+        cursor.stats_enabled = True
+        cursor.arraysize = 4
+        cursor.execute("select IntCol from TestNumbers order by IntCol")
+        rows = cursor.fetchall()
+        stats = cursor.stats
+        self.assertEqual(stats["rows_fetched"], len(rows))
+        self.assertTrue(stats["fetch_calls"] >= len(rows) // 4)
+        self.assertTrue(stats["define_bytes"] > 0)
+        self.assertTrue(stats["wait_time"] > 0)
+        self.assertTrue(stats["conversion_time"] > 0)
+        self.assertEqual(stats["bind_reallocations"], 0)
+        cursor.execute("select :1 from dual", ["a"])
+        cursor.execute("select :1 from dual", ["a" * 3000])
+        self.assertEqual(cursor.stats["bind_reallocations"], 1)
+
+    def test_1289_connection_stats(self):
+        "1289 - test execution statistics aggregated by the connection"
+        connection = test_env.get_connection()
+        self.assertEqual(connection.stats_enabled, False)
+        connection.stats_enabled = True
+        for i in range(2):
+            cursor = connection.cursor()
+            self.assertEqual(cursor.stats_enabled, False)
+            cursor.execute("select IntCol from TestNumbers")
+            cursor.fetchall()
+        stats = connection.stats
+        self.assertEqual(stats["rows_fetched"], 2 * cursor.rowcount)
+        self.assertTrue(stats["fetch_calls"] >= 2)
+
+    def test_1290_fetch_window(self):
+        "1290 - test fetching a window of rows from a scrollable cursor"
+        cursor = self.connection.cursor(scrollable=True)
+        cursor.arraysize = 4
+        cursor.stats_enabled = True
+        cursor.execute("""
+                select IntCol
+                from TestNumbers
+                order by IntCol""")
+        self.assertEqual(cursor.fetch_window(3, 4), [(3,), (4,), (5,), (6,)])
+        self.assertEqual(cursor.rowcount, 6)
+        fetch_calls = cursor.stats["fetch_calls"]
+        self.assertEqual(cursor.fetch_window(4, 2), [(4,), (5,)])
+        self.assertEqual(cursor.stats["fetch_calls"], fetch_calls)
+        self.assertEqual(cursor.fetch_window(9, 5), [(9,), (10,)])
+        self.assertEqual(cursor.fetch_window(0, 2, mode="first"),
+                         [(1,), (2,)])
+        self.assertEqual(cursor.fetch_window(0, 3, mode="last"), [(10,)])
+        cursor.rowfactory = lambda n: n * 10
+        self.assertEqual(cursor.fetch_window(3, 2), [30, 40])
+        self.assertRaises(oracledb.InterfaceError, cursor.fetch_window, 1, 1,
+                          "bad")
+
+    def test_1291_fetch_window_cache_size(self):
+        "1291 - test fetching windows with the window cache disabled"
+        cursor = self.connection.cursor(scrollable=True)
+        self.assertEqual(cursor.window_cache_size, 1000)
+        cursor.window_cache_size = 0
+        cursor.stats_enabled = True
+        cursor.execute("""
+                select IntCol
+                from TestNumbers
+                order by IntCol""")
+        self.assertEqual(cursor.fetch_window(2, 2), [(2,), (3,)])
+        fetch_calls = cursor.stats["fetch_calls"]
+        self.assertEqual(cursor.fetch_window(2, 2), [(2,), (3,)])
+        self.assertEqual(cursor.stats["fetch_calls"], fetch_calls + 1)
+
+    def test_1292_reuse_define_variables(self):
+        "1292 - test define variables are reused by short-lived cursors"
+        sql = "select IntCol, StringCol from TestStrings where IntCol <= :1"
+        for array_size in (100, 100, 5, 100):
+            for num_rows in (3, 1, 2):
+                cursor = self.connection.cursor()
+                cursor.arraysize = array_size
+                cursor.execute(sql, [num_rows])
+                expected = [(i, "String %d" % i) \
+                            for i in range(1, num_rows + 1)]
+                self.assertEqual(cursor.fetchall(), expected)
+                cursor.close()
+        cursor = self.connection.cursor()
+        cursor.execute("select sysdate, 1.5 from dual")
+        self.assertEqual(cursor.fetchone()[1], 1.5)
+        cursor.execute(sql, [1])
+        self.assertEqual(cursor.fetchall(), [(1, "String 1")])
+        fetch_vars = cursor.fetchvars
+        cursor.execute("select 'X' from dual")
+        self.assertEqual(cursor.fetchall(), [("X",)])
+        self.assertEqual(fetch_vars[1].getvalue(), "String 1")
+
 if __name__ == "__main__":
     test_env.run_test_cases()
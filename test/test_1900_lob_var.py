@@ -11,6 +11,13 @@
 1900 - Module for testing LOB (CLOB and BLOB) variables
 """
 
+import array
+import hashlib
+import os
+import tempfile
+import unittest
+import zlib
+
 import cx_Oracle as oracledb
 import test_env
 
@@ -280,5 +287,304 @@ class TestCase(test_env.BaseTestCase):
         nclobVar = self.cursor.var(oracledb.DB_TYPE_NCLOB)
         self.assertRaises(IndexError, nclobVar.setvalue, 1, "test char")
 
+    def test_1920_readinto(self):
+        "1920 - test reading a BLOB into a buffer"
+        data = bytes(range(256)) * 300
+        lob = self.connection.createlob(oracledb.DB_TYPE_BLOB)
+        lob.write(data)
+        buf = bytearray(50000)
+        self.assertEqual(lob.readinto(buf), 50000)
+        self.assertEqual(buf, data[:50000])
+        self.assertEqual(lob.readinto(buf, 50001), len(data) - 50000)
+        self.assertEqual(buf[:len(data) - 50000], data[50000:])
+        self.assertEqual(lob.readinto(buf, len(data) + 1), 0)
+        view = memoryview(buf)[10:20]
+        self.assertEqual(lob.readinto(view, 5), 10)
+        self.assertEqual(buf[10:20], data[4:14])
+        self.assertRaises(TypeError, lob.readinto, b"read only")
+        clob = self.connection.createlob(oracledb.DB_TYPE_CLOB)
+        self.assertRaises(oracledb.ProgrammingError, clob.readinto, buf)
+
+    def test_1921_iter_chunks(self):
+        "1921 - test iterating over LOBs in chunks"
+        data = bytes(range(256)) * 300
+        lob = self.connection.createlob(oracledb.DB_TYPE_BLOB)
+        lob.write(data)
+        chunk_size = lob.getchunksize()
+        chunks = list(lob.iter_chunks())
+        self.assertEqual(b"".join(chunks), data)
+        self.assertEqual(len(chunks[0]), chunk_size)
+        chunks = list(lob.iter_chunks(chunk_size + 1))
+        self.assertEqual(len(chunks[0]), chunk_size * 2)
+        self.assertEqual(b"".join(chunks), data)
+        text = "ABC\u3042" * 20000
+        for lob_type in (oracledb.DB_TYPE_CLOB, oracledb.DB_TYPE_NCLOB):
+            lob = self.connection.createlob(lob_type)
+            lob.write(text)
+            self.assertEqual("".join(lob.iter_chunks(1000)), text)
+        lob = self.connection.createlob(oracledb.DB_TYPE_BLOB)
+        self.assertEqual(list(lob.iter_chunks()), [])
+
+    def test_1922_write_from_buffer(self):
+        "1922 - test writing to a BLOB from objects supporting buffers"
+        data = bytes(range(256)) * 300
+        lob = self.connection.createlob(oracledb.DB_TYPE_BLOB)
+        lob.write(bytearray(data))
+        self.assertEqual(lob.read(), data)
+        lob.write(memoryview(data)[100:200], 3)
+        self.assertEqual(lob.read(), data[:2] + data[100:200] + data[102:])
+        values = array.array("i", range(1000))
+        lob.trim()
+        lob.write(values)
+        self.assertEqual(lob.read(), values.tobytes())
+        chunk_size = lob.getchunksize()
+        lob.trim()
+        lob.write(b"X" * (chunk_size * 3 + 17), chunk_size // 2)
+        self.assertEqual(lob.size(), chunk_size * 3 + 17 + chunk_size // 2 - 1)
+        self.assertRaises(TypeError, lob.write, 25)
+
+    def test_1923_file_transfer(self):
+        "1923 - test transferring data between LOBs and files"
+        data = os.urandom(3 * 1024 * 1024 + 1234)
+        with tempfile.TemporaryDirectory() as temp_dir:
+            in_name = os.path.join(temp_dir, "in.dat")
+            out_name = os.path.join(temp_dir, "out.dat")
+            with open(in_name, "wb") as f:
+                f.write(data)
+            lob = self.connection.createlob(oracledb.DB_TYPE_BLOB)
+            progress = []
+            self.assertEqual(lob.write_from_file(in_name,
+                                                 progress=progress.append),
+                             len(data))
+            self.assertGreater(progress[0], 0)
+            for prev_value, value in zip(progress, progress[1:]):
+                self.assertGreater(value, prev_value)
+            self.assertEqual(progress[-1], len(data))
+            self.assertEqual(lob.read(), data)
+            self.assertEqual(lob.read_to_file(out_name, open_lob=True),
+                             len(data))
+            with open(out_name, "rb") as f:
+                self.assertEqual(f.read(), data)
+            with open(out_name, "wb") as f:
+                f.write(b"HEADER")
+                f.flush()
+                lob.read_to_file(f.fileno(), offset=len(data) - 9)
+                self.assertEqual(f.tell(), 16)
+            with open(out_name, "rb") as f:
+                self.assertEqual(f.read(), b"HEADER" + data[-10:])
+            text = "ABC\u3042" * 100000
+            clob = self.connection.createlob(oracledb.DB_TYPE_CLOB)
+            clob.write(text)
+            clob.read_to_file(out_name)
+            with open(out_name, "rb") as f:
+                self.assertEqual(f.read().decode(self.connection.encoding),
+                                 text)
+            self.assertRaises(oracledb.ProgrammingError,
+                              clob.write_from_file, in_name)
+            self.assertRaises(OSError, lob.write_from_file,
+                              os.path.join(temp_dir, "missing.dat"))
+
+    def test_1924_fetch_lobs_inline(self):
+        "1924 - test fetching LOBs as strings and bytes"
+        self.cursor.execute("truncate table TestCLOBs")
+        self.cursor.execute("truncate table TestBLOBs")
+        long_text = "X" * 50000
+        self.cursor.executemany("insert into TestCLOBs values (:1, :2)",
+                                [(1, "Short value"), (2, long_text)])
+        self.cursor.execute("insert into TestBLOBs values (1, :1)",
+                            [b"Short value"])
+        self.connection.commit()
+        cursor = self.connection.cursor()
+        cursor.fetch_lobs = False
+        cursor.execute("select ClobCol from TestCLOBs order by IntCol")
+        self.assertEqual(cursor.fetchall(), [("Short value",), (long_text,)])
+        cursor.execute("select BlobCol from TestBLOBs")
+        self.assertEqual(cursor.fetchall(), [(b"Short value",)])
+        cursor = self.connection.cursor()
+        self.assertEqual(cursor.inline_lob_size, 0)
+        cursor.inline_lob_size = 1000
+        cursor.execute("select ClobCol from TestCLOBs order by IntCol")
+        (short_value,), (long_value,) = cursor.fetchall()
+        self.assertEqual(short_value, "Short value")
+        self.assertIsInstance(long_value, oracledb.LOB)
+        self.assertEqual(long_value.read(), long_text)
+        cursor.execute("select BlobCol from TestBLOBs")
+        self.assertEqual(cursor.fetchone(), (b"Short value",))
+
+    def test_1925_parallel_transfer(self):
+        "1925 - test transferring LOB data using multiple streams"
+        data = os.urandom(5 * 1024 * 1024 + 4321)
+        lob = self.connection.createlob(oracledb.DB_TYPE_BLOB)
+        self.assertEqual(lob.parallel_write(data, streams=3), len(data))
+        self.assertEqual(lob.size(), len(data))
+        self.assertEqual(lob.read(), data)
+        dest = bytearray(len(data))
+        self.assertEqual(lob.parallel_read(dest, streams=3), len(data))
+        self.assertEqual(bytes(dest), data)
+        with tempfile.TemporaryDirectory() as temp_dir:
+            name = os.path.join(temp_dir, "data.dat")
+            self.assertEqual(lob.parallel_read(name, streams=5), len(data))
+            with open(name, "rb") as f:
+                self.assertEqual(f.read(), data)
+            other_lob = self.connection.createlob(oracledb.DB_TYPE_BLOB)
+            self.assertEqual(other_lob.parallel_write(name), len(data))
+            self.assertEqual(other_lob.read(), data)
+        self.assertRaises(TypeError, lob.parallel_write, data, lobs=[lob])
+        threaded_conn = test_env.get_connection(threaded=True)
+        threaded_lob = threaded_conn.createlob(oracledb.DB_TYPE_BLOB)
+        self.assertEqual(threaded_lob.parallel_write(data, streams=3),
+                         len(data))
+        dest = bytearray(len(data))
+        self.assertEqual(threaded_lob.parallel_read(dest, streams=3),
+                         len(data))
+        self.assertEqual(bytes(dest), data)
+        dest = bytearray(len(data))
+        self.assertEqual(lob.parallel_read(dest, streams=4,
+                                           lobs=[lob, threaded_lob]),
+                         len(data))
+        self.assertEqual(bytes(dest), data)
+        self.assertRaises(ValueError, lob.parallel_read, bytearray(10))
+        self.assertRaises(ValueError, lob.parallel_read, dest, streams=0)
+        clob = self.connection.createlob(oracledb.DB_TYPE_CLOB)
+        self.assertRaises(oracledb.ProgrammingError, clob.parallel_read,
+                          dest)
+        self.assertRaises(oracledb.ProgrammingError, clob.parallel_write,
+                          data)
+
+    def test_1926_clob_reader(self):
+        "1926 - test reading CLOBs incrementally"
+        lines = ["line %d \u3042\n" % i for i in range(20000)]
+        text = "".join(lines)
+        for lob_type in (oracledb.DB_TYPE_CLOB, oracledb.DB_TYPE_NCLOB):
+            lob = self.connection.createlob(lob_type)
+            lob.write(text)
+            with lob.reader(size=1000) as reader:
+                self.assertEqual(list(reader), lines)
+                self.assertEqual(reader.tell(), len(text))
+                self.assertEqual(reader.read(), "")
+                self.assertEqual(reader.seek(150000), 150000)
+                self.assertEqual(reader.read(20), text[150000:150020])
+                self.assertEqual(reader.seek(-10, 1), 150010)
+                self.assertEqual(reader.readline(), text[150010:
+                                 text.index("\n", 150010) + 1])
+                reader.seek(5)
+                self.assertEqual(reader.read(5000), text[5:5005])
+                reader.seek(len(text) + 100)
+                self.assertEqual(reader.tell(), len(text))
+                self.assertRaises(ValueError, reader.seek, -1)
+            self.assertRaises(oracledb.InterfaceError, reader.read)
+        blob = self.connection.createlob(oracledb.DB_TYPE_BLOB)
+        self.assertRaises(oracledb.ProgrammingError, blob.reader)
+
+    def test_1927_executemany_bulk_lob_binds(self):
+        "1927 - test executemany() binding LOB values in bulk"
+        self.cursor.execute("truncate table TestCLOBs")
+        self.cursor.execute("truncate table TestBLOBs")
+        self.assertEqual(self.cursor.bulk_lob_binds, False)
+        self.cursor.bulk_lob_binds = True
+        clob_data = [(i, "Value %d " % i * (i * 1000 + 1))
+                     for i in range(1, 11)]
+        self.cursor.setinputsizes(None, oracledb.DB_TYPE_CLOB)
+        self.cursor.executemany("insert into TestCLOBs values (:1, :2)",
+                                clob_data)
+        self.assertEqual(self.cursor.bindvars[1].type, oracledb.DB_TYPE_LONG)
+        blob_data = [dict(i=i, v=bytes(range(256)) * i * 100)
+                     for i in range(1, 6)]
+        self.cursor.setinputsizes(v=oracledb.DB_TYPE_BLOB)
+        self.cursor.executemany("insert into TestBLOBs values (:i, :v)",
+                                blob_data)
+        self.connection.commit()
+        self.cursor.execute("""
+                select IntCol, ClobCol
+                from TestCLOBs
+                order by IntCol""")
+        self.assertEqual([(i, c.read()) for i, c in self.cursor],
+                         clob_data)
+        self.cursor.execute("""
+                select IntCol, BlobCol
+                from TestBLOBs
+                order by IntCol""")
+        self.assertEqual([dict(i=i, v=b.read()) for i, b in self.cursor],
+                         blob_data)
+
+    def test_1928_file_transfer_transforms(self):
+        "1928 - test compressing and digesting data during file transfers"
+        data = b"0123456789abcdef" * 200000
+        compressed = zlib.compress(data)
+        with tempfile.TemporaryDirectory() as temp_dir:
+            in_name = os.path.join(temp_dir, "in.dat")
+            out_name = os.path.join(temp_dir, "out.dat")
+            with open(in_name, "wb") as f:
+                f.write(data)
+            lob = self.connection.createlob(oracledb.DB_TYPE_BLOB)
+            num_bytes, digest = \
+                    lob.write_from_file(in_name, compressor=zlib.compressobj(),
+                                        digest=hashlib.sha256())
+            self.assertEqual(num_bytes, len(compressed))
+            self.assertEqual(lob.size(), len(compressed))
+            self.assertEqual(digest, hashlib.sha256(lob.read()).digest())
+            self.assertEqual(zlib.decompress(lob.read()), data)
+            num_bytes, digest = \
+                    lob.read_to_file(out_name,
+                                     decompressor=zlib.decompressobj(),
+                                     digest=hashlib.sha256())
+            self.assertEqual(num_bytes, len(data))
+            self.assertEqual(digest, hashlib.sha256(lob.read()).digest())
+            with open(out_name, "rb") as f:
+                self.assertEqual(f.read(), data)
+            lob = self.connection.createlob(oracledb.DB_TYPE_BLOB)
+            lob.write(b"123456789")
+            self.assertEqual(lob.read_to_file(out_name, digest="crc32c"),
+                             (9, 0xE3069283))
+            with open(out_name, "rb") as f:
+                self.assertEqual(f.read(), b"123456789")
+            self.assertRaises(ValueError, lob.read_to_file, out_name,
+                              digest="md4")
+            self.assertRaises(TypeError, lob.write_from_file, in_name,
+                              compressor=zlib.decompressobj())
+
+    def test_1929_read_bfiles(self):
+        "1929 - test reading a batch of BFILEs"
+        self.assertEqual(oracledb.read_bfiles([]), [])
+        self.assertRaises(ValueError, oracledb.read_bfiles, [], threads=0)
+        blob = self.connection.createlob(oracledb.DB_TYPE_BLOB)
+        self.assertRaises(TypeError, oracledb.read_bfiles, [blob])
+        self.cursor.execute("""
+                select bfilename('MISSING_DIR', 'file' || level || '.dat')
+                from dual
+                connect by level <= 5""")
+        lobs = [lob for lob, in self.cursor]
+        self.assertEqual(lobs[2].getfilename(), ("MISSING_DIR", "file3.dat"))
+        self.assertRaises(oracledb.DatabaseError, oracledb.read_bfiles, lobs,
+                          threads=2)
+        with tempfile.TemporaryDirectory() as temp_dir:
+            self.assertRaises(oracledb.DatabaseError, oracledb.read_bfiles,
+                              lobs, directory=temp_dir)
+            self.assertRaises(oracledb.ProgrammingError, oracledb.read_bfiles,
+                              [lobs[0], lobs[0]], directory=temp_dir)
+
+    @unittest.skipUnless(test_env.get_bfile(),
+                         "no readable BFILE has been configured")
+    def test_1930_read_bfiles_contents(self):
+        "1930 - test reading the contents of a batch of BFILEs"
+        directory, file_name = test_env.get_bfile()
+        sql = "select bfilename(:1, :2) from dual connect by level <= 3"
+        self.cursor.execute(sql, [directory, file_name])
+        lobs = [lob for lob, in self.cursor]
+        lobs[0].open()
+        expected_data = lobs[0].read()
+        lobs[0].close()
+        other_conn = test_env.get_connection(threaded=True)
+        other_cursor = other_conn.cursor()
+        other_cursor.execute(sql, [directory, file_name])
+        lobs.extend(lob for lob, in other_cursor)
+        self.assertEqual(oracledb.read_bfiles(lobs, threads=4),
+                         [expected_data] * len(lobs))
+        with tempfile.TemporaryDirectory() as temp_dir:
+            paths = oracledb.read_bfiles(lobs[:1], directory=temp_dir)
+            self.assertEqual(paths, [os.path.join(temp_dir, file_name)])
+            with open(paths[0], "rb") as f:
+                self.assertEqual(f.read(), expected_data)
+
 if __name__ == "__main__":
     test_env.run_test_cases()
@@ -12,6 +12,7 @@
 """
 
 import threading
+import time
 
 import cx_Oracle as oracledb
 import test_env
@@ -554,5 +555,311 @@ class TestCase(test_env.BaseTestCase):
             result, = cursor.fetchone()
             self.assertEqual(self.session_called, True)
 
+    def test_2421_acquire_reuses_connection_objects(self):
+        "2421 - test repeated acquire and release with the default type"
+        pool = test_env.get_pool(min=1, max=2, increment=1,
+                                 getmode=oracledb.SPOOL_ATTRVAL_WAIT)
+        for i in range(20):
+            conn = pool.acquire()
+            self.assertIs(type(conn), oracledb.Connection)
+            self.assertEqual(conn.username, None)
+            self.assertEqual(conn.tag, None)
+            self.assertEqual(conn.stats_enabled, False)
+            conn.stats_enabled = True
+            cursor = conn.cursor()
+            cursor.execute("select :1 from dual", [i])
+            self.assertEqual(cursor.fetchone(), (i,))
+            pool.release(conn)
+            del cursor, conn
+        self.assertEqual(pool.busy, 0)
+
+    def test_2422_acquire_with_subclass(self):
+        "2422 - test acquire with a subclass of Connection"
+        class MyConnection(oracledb.Connection):
+            pass
+        pool = test_env.get_pool(min=1, max=2, increment=1,
+                                 connectiontype=MyConnection,
+                                 getmode=oracledb.SPOOL_ATTRVAL_WAIT)
+        with pool.acquire() as conn:
+            self.assertIs(type(conn), MyConnection)
+            cursor = conn.cursor()
+            cursor.execute("select 1 from dual")
+            self.assertEqual(cursor.fetchone(), (1,))
+
+    def test_2423_pool_stats(self):
+        "2423 - test session pool statistics"
+        pool = test_env.get_pool(min=1, max=2, increment=1,
+                                 getmode=oracledb.SPOOL_ATTRVAL_TIMEDWAIT,
+                                 wait_timeout=200)
+        stats = pool.stats
+        self.assertEqual(stats["acquires"], 0)
+        self.assertEqual(stats["sessions_created"], 1)
+        self.assertEqual(stats["opened"], 1)
+        conn1 = pool.acquire()
+        conn2 = pool.acquire()
+        self.assertRaises(oracledb.DatabaseError, pool.acquire)
+        stats = pool.stats
+        self.assertEqual(stats["acquires"], 3)
+        self.assertEqual(stats["acquire_failures"], 1)
+        self.assertEqual(stats["acquire_timeouts"], 1)
+        self.assertEqual(stats["sessions_created"], 2)
+        self.assertEqual(stats["busy"], 2)
+        self.assertEqual(stats["busy_high_water"], 2)
+        self.assertEqual(stats["opened_high_water"], 2)
+        self.assertTrue(stats["max_wait_time"] >= 0.2)
+        histogram = stats["wait_histogram"]
+        self.assertEqual(sum(c for b, c in histogram), 3)
+        self.assertEqual(histogram[-1][0], None)
+        pool.release(conn1)
+        pool.drop(conn2)
+        stats = pool.stats
+        self.assertEqual(stats["busy"], 0)
+        self.assertEqual(stats["sessions_destroyed"], 1)
+        self.assertTrue(0 < stats["busy_average"] <= 2)
+        for i in range(2):
+            conn1 = pool.acquire()
+            conn2 = pool.acquire()
+            pool.drop(conn2)
+            pool.release(conn1)
+        stats = pool.stats
+        self.assertEqual(stats["opened"], 1)
+        self.assertEqual(stats["sessions_created"], 4)
+        self.assertEqual(stats["sessions_destroyed"], 3)
+        self.assertEqual(stats["opened_high_water"], 2)
+
+    def __wait_for_opened(self, pool, num_sessions):
+        for i in range(100):
+            if pool.opened >= num_sessions:
+                break
+            time.sleep(0.1)
+        self.assertEqual(pool.opened, num_sessions)
+
+    def test_2424_prewarm(self):
+        "2424 - test opening sessions in the background"
+        pool = test_env.get_pool(min=4, max=8, increment=1, prewarm=True,
+                                 getmode=oracledb.SPOOL_ATTRVAL_WAIT)
+        self.__wait_for_opened(pool, 4)
+        self.assertEqual(pool.spare, 0)
+        with pool.acquire() as conn:
+            cursor = conn.cursor()
+            cursor.execute("select 1 from dual")
+            self.assertEqual(cursor.fetchone(), (1,))
+        pool.close()
+
+    def test_2425_spare(self):
+        "2425 - test replenishing spare sessions in the background"
+        pool = test_env.get_pool(min=1, max=4, increment=1, spare=2,
+                                 getmode=oracledb.SPOOL_ATTRVAL_WAIT)
+        self.__wait_for_opened(pool, 2)
+        conn1 = pool.acquire()
+        conn2 = pool.acquire()
+        self.__wait_for_opened(pool, 4)
+        pool.release(conn1)
+        pool.release(conn2)
+        pool.reconfigure(spare=0)
+        self.assertEqual(pool.spare, 0)
+        pool = test_env.get_pool(min=1, max=2, increment=1, spare=1,
+                                 getmode=oracledb.SPOOL_ATTRVAL_WAIT)
+        conn = pool.acquire()
+        self.assertRaises(oracledb.DatabaseError, pool.close)
+        self.assertEqual(pool.spare, 1)
+        self.__wait_for_opened(pool, 2)
+        pool.release(conn)
+        pool.close()
+        self.assertRaises(oracledb.ProgrammingError, test_env.get_pool,
+                          prewarm=True, session_callback=lambda c, t: None)
+        self.assertRaises(oracledb.ProgrammingError, test_env.get_pool,
+                          spare=1, homogeneous=False)
+        pool = test_env.get_pool(min=1, max=2, increment=1, threaded=False)
+        with self.assertRaises(oracledb.ProgrammingError):
+            pool.spare = 1
+
+    def test_2426_thread_affinity(self):
+        "2426 - test thread affinity retains the session for the thread"
+        pool = test_env.get_pool(min=1, max=4, increment=1,
+                                 thread_affinity=True,
+                                 getmode=oracledb.SPOOL_ATTRVAL_WAIT)
+        self.assertEqual(pool.thread_affinity, True)
+        self.assertEqual(pool.affinity_timeout, 60)
+        sql = "select sys_context('userenv', 'sid') from dual"
+        with pool.acquire() as conn:
+            cursor = conn.cursor()
+            cursor.execute("truncate table TestTempTable")
+            cursor.execute("insert into TestTempTable (IntCol) values (1)")
+            cursor.execute(sql)
+            (sid,) = cursor.fetchone()
+        self.assertEqual(pool.busy, 1)
+        conn = pool.acquire()
+        cursor = conn.cursor()
+        cursor.execute(sql)
+        self.assertEqual(cursor.fetchone(), (sid,))
+        cursor.execute("select count(*) from TestTempTable")
+        self.assertEqual(cursor.fetchone(), (0,))
+        pool.release(conn)
+        self.assertEqual(pool.stats["affinity_hits"], 1)
+        def thread_func():
+            with pool.acquire() as conn:
+                cursor = conn.cursor()
+                cursor.execute(sql)
+                other_sids.append(cursor.fetchone()[0])
+        other_sids = []
+        thread = threading.Thread(target=thread_func)
+        thread.start()
+        thread.join()
+        self.assertNotEqual(other_sids[0], sid)
+        self.assertEqual(pool.busy, 1)
+        pool.affinity_timeout = 0
+        conn = pool.acquire()
+        self.assertEqual(pool.stats["affinity_hits"], 1)
+        pool.release(conn)
+        self.assertRaises(oracledb.InterfaceError, pool.release, conn)
+        other_pool = test_env.get_pool(min=1, max=1, increment=1,
+                                       thread_affinity=True)
+        conn = other_pool.acquire()
+        self.assertRaises(oracledb.ProgrammingError, pool.release, conn)
+        other_pool.release(conn)
+        other_pool.close()
+        pool.close()
+        pool = test_env.get_pool(min=1, max=2, increment=1,
+                                 thread_affinity=True,
+                                 getmode=oracledb.SPOOL_ATTRVAL_TIMEDWAIT,
+                                 wait_timeout=500)
+        with pool.acquire():
+            pass
+        self.assertEqual(pool.busy, 1)
+        def acquire_func():
+            held_conns.append(pool.acquire())
+        held_conns = []
+        for i in range(2):
+            thread = threading.Thread(target=acquire_func)
+            thread.start()
+            thread.join()
+        self.assertEqual(len(held_conns), 2)
+        for conn in held_conns:
+            pool.release(conn)
+
+    def test_2427_session_state(self):
+        "2427 - test applying declarative session state on acquire"
+        pool = test_env.get_pool(min=1, max=1, increment=1,
+                                 getmode=oracledb.SPOOL_ATTRVAL_WAIT)
+        state_a = dict(nls_date_format="YYYY-MM-DD", module="mod_a",
+                       action="action_a")
+        state_b = dict(NLS_DATE_FORMAT="DD/MM/YYYY HH24:MI", module="mod_b")
+        state_c = dict(module="mod_c")
+        sql = """
+                select
+                    value,
+                    sys_context('userenv', 'module'),
+                    sys_context('userenv', 'action')
+                from nls_session_parameters
+                where parameter = 'NLS_DATE_FORMAT'"""
+        with pool.acquire() as conn:
+            cursor = conn.cursor()
+            cursor.execute(sql)
+            default_format = cursor.fetchone()[0]
+        for state, expected_value in ((state_a, ("YYYY-MM-DD", "mod_a",
+                                                 "action_a")),
+                                      (state_b, ("DD/MM/YYYY HH24:MI",
+                                                 "mod_b", None)),
+                                      (state_c, (default_format, "mod_c",
+                                                 None)),
+                                      (state_a, ("YYYY-MM-DD", "mod_a",
+                                                 "action_a"))):
+            conn = pool.acquire(state=state)
+            self.assertTrue(conn.tag.startswith("cxo_state="))
+            cursor = conn.cursor()
+            cursor.execute(sql)
+            self.assertEqual(cursor.fetchone(), expected_value)
+            pool.release(conn)
+        tag = pool.acquire(state=state_a).tag
+        self.assertNotEqual(tag, pool.acquire(state=state_b).tag)
+        self.assertRaises(oracledb.ProgrammingError, pool.acquire,
+                          state=dict(nls_x="1; drop table x"))
+        self.assertRaises(oracledb.ProgrammingError, pool.acquire,
+                          state=dict(unknown="value"))
+        self.assertRaises(oracledb.ProgrammingError, pool.acquire,
+                          state=state_a, tag="a=b")
+
+    def test_2428_health_check(self):
+        "2428 - test checking the health of idle sessions in the background"
+        pool = test_env.get_pool(min=2, max=4, increment=1,
+                                 health_check_interval=1,
+                                 getmode=oracledb.SPOOL_ATTRVAL_WAIT)
+        self.assertEqual(pool.health_check_interval, 1)
+        time.sleep(2.5)
+        stats = pool.stats
+        self.assertGreaterEqual(stats["health_checks"], 2)
+        self.assertEqual(stats["sessions_evicted"], 0)
+        self.assertEqual(pool.opened, 2)
+        pool.reconfigure(health_check_interval=0)
+        self.assertEqual(pool.health_check_interval, 0)
+        pool = test_env.get_pool(min=1, max=2, increment=1, threaded=False)
+        with self.assertRaises(oracledb.ProgrammingError):
+            pool.health_check_interval = 1
+
+    def test_2429_priority(self):
+        "2429 - test serving waiters in order of priority"
+        pool = test_env.get_pool(min=1, max=2, increment=1,
+                                 reservations={0: 1},
+                                 getmode=oracledb.SPOOL_ATTRVAL_TIMEDWAIT,
+                                 wait_timeout=500)
+        self.assertEqual(pool.reservations, {0: 1})
+        conn1 = pool.acquire()
+        self.assertRaises(oracledb.DatabaseError, pool.acquire)
+        conn2 = pool.acquire(priority=1)
+        self.assertEqual(pool.stats["queue_timeouts"], 1)
+        pool.release(conn1)
+        pool.release(conn2)
+        pool = test_env.get_pool(min=1, max=1, increment=1,
+                                 priority_queue=True,
+                                 getmode=oracledb.SPOOL_ATTRVAL_WAIT)
+        order = []
+        def thread_func(priority):
+            conn = pool.acquire(priority=priority)
+            order.append(priority)
+            pool.release(conn)
+        conn = pool.acquire()
+        threads = []
+        for priority in (0, 5, 0, 5):
+            thread = threading.Thread(target=thread_func, args=(priority,))
+            thread.start()
+            threads.append(thread)
+            while pool.stats["queued"] < len(threads):
+                time.sleep(0.05)
+        pool.release(conn)
+        for thread in threads:
+            thread.join()
+        self.assertEqual(order, [5, 5, 0, 0])
+        self.assertEqual(pool.stats["queue_waits"], 4)
+        pool = test_env.get_pool(min=1, max=2, increment=1)
+        self.assertRaises(oracledb.ProgrammingError, pool.acquire,
+                          priority=1)
+        self.assertRaises(oracledb.ProgrammingError, test_env.get_pool,
+                          thread_affinity=True, priority_queue=True)
+        self.assertRaises(oracledb.ProgrammingError, test_env.get_pool,
+                          thread_affinity=True, reservations={0: 1})
+
+    def test_2430_heterogeneous_combined_user(self):
+        "2430 - test acquire with user/password@dsn in a heterogeneous pool"
+        class MyConnection(oracledb.Connection):
+            pass
+        user = test_env.get_main_user()
+        password = test_env.get_main_password()
+        dsn = test_env.get_connect_string()
+        for connection_type in (oracledb.Connection, MyConnection):
+            pool = test_env.get_pool(user="", password="", min=0, max=2,
+                                     increment=1, homogeneous=False,
+                                     connectiontype=connection_type,
+                                     getmode=oracledb.SPOOL_ATTRVAL_WAIT)
+            with pool.acquire(user="%s/%s" % (user, password)) as conn:
+                self.assertIs(type(conn), connection_type)
+                self.assertEqual(conn.username, user)
+                self.__verify_connection(conn, user)
+            with pool.acquire(user="%s/%s@%s" % (user, password, dsn)) \
+                    as conn:
+                self.assertEqual(conn.username, user)
+                self.assertEqual(conn.dsn, dsn)
+                self.__verify_connection(conn, user)
+
 if __name__ == "__main__":
     test_env.run_test_cases()
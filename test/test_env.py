@@ -22,6 +22,9 @@
 #     CX_ORACLE_TEST_CONNECT_STRING: connect string for test suite
 #     CX_ORACLE_TEST_ADMIN_USER: administrative user for test suite
 #     CX_ORACLE_TEST_ADMIN_PASSWORD: administrative password for test suite
+#     CX_ORACLE_TEST_BFILE_DIRECTORY: optional directory object containing a
+#         file readable by the main user, used for testing BFILEs
+#     CX_ORACLE_TEST_BFILE_NAME: optional name of the file in that directory
 #
 # CX_ORACLE_TEST_CONNECT_STRING can be set to an Easy Connect string, or a
 # Net Service Name from a tnsnames.ora file or external naming service,
@@ -86,6 +89,12 @@ def get_admin_connect_string():
                                "Password for %s" % admin_user)
     return "%s/%s@%s" % (admin_user, admin_password, get_connect_string())
 
+def get_bfile():
+    directory = os.environ.get("CX_ORACLE_TEST_BFILE_DIRECTORY")
+    file_name = os.environ.get("CX_ORACLE_TEST_BFILE_NAME")
+    if directory and file_name:
+        return directory, file_name
+
 def get_charset_ratios():
     value = PARAMETERS.get("CS_RATIO")
     if value is None: